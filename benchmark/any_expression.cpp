@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "deferred/deferred.hpp"
+#include "harness.hpp"
+
+namespace {
+
+constexpr std::size_t count      = 1024;
+constexpr std::size_t iterations = 2000;
+
+// Returns a callable that captures Size bytes.
+template<std::size_t Size>
+auto make_callable(int i)
+{
+  std::array<int, Size / sizeof(int)> values{};
+  values.front() = i;
+  return [values] { return values.front(); };
+}
+
+// Measures constructing and evaluating count wrappers of type Wrapper.
+template<typename Wrapper, std::size_t Size>
+void run(char const* name)
+{
+  std::vector<Wrapper> wrappers;
+  wrappers.reserve(count);
+
+  auto const construct_t = deferred::benchmark::measure(
+    [&] {
+      wrappers.clear();
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        wrappers.emplace_back(make_callable<Size>(static_cast<int>(i)));
+      }
+      deferred::benchmark::do_not_optimize(wrappers.data());
+    },
+    iterations);
+
+  auto const call_t = deferred::benchmark::measure(
+    [&] {
+      int sum = 0;
+      for (auto const& w : wrappers)
+      {
+        sum += w();
+      }
+      deferred::benchmark::do_not_optimize(sum);
+    },
+    iterations);
+
+  std::printf("%-28s %8zu %16.3f %12.3f\n", name, Size, construct_t / count, call_t / count);
+}
+
+template<std::size_t Size>
+void run_all()
+{
+  using namespace deferred;
+
+  run<any_expression<int>, Size>("any_expression");
+  run<move_only_any_expression<int>, Size>("move_only_any_expression");
+  run<std::function<int()>, Size>("std::function");
+#if defined(__cpp_lib_move_only_function)
+  run<std::move_only_function<int() const>, Size>("std::move_only_function");
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief Compares construction and evaluation of any_expression with std::function and
+ * std::move_only_function, for callables that fit in the inline storage and callables that do not.
+ */
+int main()
+{
+  std::printf("%-28s %8s %16s %12s\n", "wrapper", "bytes", "construct ns", "call ns");
+  run_all<16>();
+  run_all<128>();
+  return 0;
+}
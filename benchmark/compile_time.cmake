@@ -0,0 +1,138 @@
+# SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+# SPDX-License-Identifier: MIT
+
+# Measures the compilation time of generated sources with switches, conditional chains, and
+# operator chains of increasing size.
+#
+# Usage:
+#   cmake -DCOMPILER=<path> -DCOMPILER_ID=<id> -DINCLUDE_DIR=<path> -DOUTPUT_DIR=<path>
+#         [-DCOMPILER_VERSION=<version>] [-DFLAGS=<flags>] [-DSIZES=10;100;300;1000]
+#         -P compile_time.cmake
+#
+# The results are printed and written to ${OUTPUT_DIR}/compile_time.json.
+
+cmake_minimum_required(VERSION 3.23)
+
+foreach(variable COMPILER COMPILER_ID INCLUDE_DIR OUTPUT_DIR)
+  if(NOT DEFINED ${variable})
+    message(FATAL_ERROR "${variable} is not defined")
+  endif()
+endforeach()
+
+if(NOT DEFINED SIZES)
+  set(SIZES 10 100 300 1000)
+endif()
+
+separate_arguments(flags NATIVE_COMMAND "${FLAGS}")
+if(COMPILER_ID STREQUAL "MSVC")
+  list(APPEND flags /nologo /std:c++latest /EHsc /bigobj "/I${INCLUDE_DIR}")
+  set(compile_flag /c)
+  set(output_flag /Fo)
+else()
+  list(APPEND flags -std=c++23 "-I${INCLUDE_DIR}")
+  set(compile_flag -c)
+  set(output_flag -o)
+endif()
+
+file(MAKE_DIRECTORY "${OUTPUT_DIR}")
+
+set(header "// generated by compile_time.cmake\n#include \"deferred/deferred.hpp\"\n\n")
+set(main_begin "int main(int argc, char**)\n{\n  auto x = deferred::variable(argc);\n")
+set(main_end "  return ex();\n}\n")
+
+# switch_ with n cases
+function(generate_switch n result)
+  set(source "${header}${main_begin}  auto ex = deferred::switch_(x, deferred::default_(-1)")
+  math(EXPR last "${n} - 1")
+  foreach(i RANGE ${last})
+    string(APPEND source ",\n    deferred::case_(${i}, ${i})")
+  endforeach()
+  string(APPEND source ");\n${main_end}")
+  set(${result} "${source}" PARENT_SCOPE)
+endfunction()
+
+# if_ with n - 1 else_if branches and an else_ branch
+function(generate_conditional n result)
+  set(source "${header}${main_begin}  auto ex = deferred::if_(x == 0, 0)")
+  math(EXPR last "${n} - 1")
+  if(last GREATER 0)
+    foreach(i RANGE 1 ${last})
+      string(APPEND source "\n    .else_if(x == ${i}, ${i})")
+    endforeach()
+  endif()
+  string(APPEND source "\n    .else_(-1);\n${main_end}")
+  set(${result} "${source}" PARENT_SCOPE)
+endfunction()
+
+# sum of n products
+function(generate_operators n result)
+  set(source "${header}${main_begin}  auto ex = x * 0")
+  math(EXPR last "${n} - 1")
+  if(last GREATER 0)
+    foreach(i RANGE 1 ${last})
+      string(APPEND source "\n    + x * ${i}")
+    endforeach()
+  endif()
+  string(APPEND source ";\n${main_end}")
+  set(${result} "${source}" PARENT_SCOPE)
+endfunction()
+
+message(STATUS "Compiler: ${COMPILER_ID} ${COMPILER_VERSION}")
+message(STATUS "benchmark        terms   time (s)")
+
+set(entries "")
+foreach(benchmark switch conditional operators)
+  foreach(n ${SIZES})
+    set(name "${benchmark}_${n}")
+    set(source_file "${OUTPUT_DIR}/${name}.cpp")
+    cmake_language(CALL generate_${benchmark} ${n} source)
+    file(WRITE "${source_file}" "${source}")
+
+    string(TIMESTAMP start "%s%f" UTC)
+    execute_process(
+      COMMAND "${COMPILER}" ${flags} ${compile_flag} "${source_file}"
+              "${output_flag}${OUTPUT_DIR}/${name}.o"
+      RESULT_VARIABLE result
+      OUTPUT_QUIET
+      ERROR_VARIABLE errors)
+    string(TIMESTAMP end "%s%f" UTC)
+
+    if(result EQUAL 0)
+      math(EXPR elapsed_ms "(${end} - ${start}) / 1000")
+      math(EXPR seconds "${elapsed_ms} / 1000")
+      math(EXPR milliseconds "${elapsed_ms} % 1000")
+      string(LENGTH "${milliseconds}" digits)
+      while(digits LESS 3)
+        string(PREPEND milliseconds "0")
+        math(EXPR digits "${digits} + 1")
+      endwhile()
+      set(time "${seconds}.${milliseconds}")
+    else()
+      file(WRITE "${OUTPUT_DIR}/${name}.log" "${errors}")
+      set(time "null")
+    endif()
+
+    string(LENGTH "${benchmark}" length)
+    math(EXPR padding "16 - ${length}")
+    string(REPEAT " " ${padding} spaces)
+    string(LENGTH "${n}" length)
+    math(EXPR padding "6 - ${length}")
+    string(REPEAT " " ${padding} n_spaces)
+    if(time STREQUAL "null")
+      message(STATUS "${benchmark}${spaces}${n_spaces}${n}   failed (see ${name}.log)")
+    else()
+      message(STATUS "${benchmark}${spaces}${n_spaces}${n}   ${time}")
+    endif()
+
+    list(APPEND entries
+         "    {\"benchmark\": \"${benchmark}\", \"terms\": ${n}, \"seconds\": ${time}}")
+  endforeach()
+endforeach()
+
+list(JOIN entries ",\n" entries)
+file(WRITE "${OUTPUT_DIR}/compile_time.json"
+  "{\n"
+  "  \"compiler\": \"${COMPILER_ID}\",\n"
+  "  \"version\": \"${COMPILER_VERSION}\",\n"
+  "  \"results\": [\n${entries}\n  ]\n"
+  "}\n")
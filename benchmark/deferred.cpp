@@ -0,0 +1,273 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <utility>
+#include <valarray>
+#include <vector>
+
+#include "deferred/deferred.hpp"
+#include "harness.hpp"
+
+namespace {
+
+constexpr std::size_t key_count = 1024;
+
+/// @brief Returns pseudo-random keys in <tt>[0, n]</tt>; @p n selects the default case.
+std::array<int, key_count> make_keys(int n)
+{
+  std::array<int, key_count> keys{};
+  std::uint32_t state = 12345;
+  for (auto& k : keys)
+  {
+    state = state * 1664525u + 1013904223u;
+    k     = static_cast<int>((state >> 8) % static_cast<std::uint32_t>(n + 1));
+  }
+  return keys;
+}
+
+/// @brief Appends branches @p I to @p N to the conditional @p c and finalizes it.
+template<std::size_t I, std::size_t N, typename Conditional, typename Variable>
+auto add_branches(Conditional&& c, Variable& x)
+{
+  if constexpr (I == N)
+  {
+    return std::forward<Conditional>(c).else_(-1);
+  }
+  else
+  {
+    return add_branches<I + 1, N>(
+      std::forward<Conditional>(c).else_if(x == static_cast<int>(I), static_cast<int>(I) * 3), x);
+  }
+}
+
+/// @brief Creates an @c if_ chain with sizeof...(I) branches over @p x.
+template<typename Variable, std::size_t... I>
+auto make_conditional(Variable& x, std::index_sequence<I...>)
+{
+  return add_branches<1, sizeof...(I)>(deferred::if_(x == 0, 0), x);
+}
+
+/// @brief Creates a @c switch_ with sizeof...(I) cases over @p x.
+template<typename Variable, std::size_t... I>
+auto make_switch(Variable& x, std::index_sequence<I...>)
+{
+  return deferred::switch_(
+    x,
+    deferred::default_(-1),
+    deferred::case_(static_cast<int>(I), static_cast<int>(I) * 3)...);
+}
+
+/// @brief Hand-written equivalent of @ref make_conditional and @ref make_switch.
+template<std::size_t... I>
+int select(int v, std::index_sequence<I...>)
+{
+  int r = -1;
+  static_cast<void>(((v == static_cast<int>(I) ? (r = static_cast<int>(I) * 3, true) : false) || ...));
+  return r;
+}
+
+/// @brief Compares @c if_ and @c switch_ with @p N cases against an @c if chain.
+template<std::size_t N>
+void dispatch(deferred::benchmark::report& report, std::size_t iterations)
+{
+  using indices   = std::make_index_sequence<N>;
+  auto const keys = make_keys(static_cast<int>(N));
+
+  auto x           = deferred::variable(0);
+  auto conditional = make_conditional(x, indices{});
+  auto sw          = make_switch(x, indices{});
+
+  std::size_t k = 0;
+  auto baseline = [&] {
+    deferred::benchmark::do_not_optimize(select(keys[k++ % key_count], indices{}));
+  };
+  report.compare(
+    "if_/" + std::to_string(N),
+    [&] {
+      x = keys[k++ % key_count];
+      deferred::benchmark::do_not_optimize(conditional());
+    },
+    baseline,
+    iterations);
+  report.compare(
+    "switch_/" + std::to_string(N),
+    [&] {
+      x = keys[k++ % key_count];
+      deferred::benchmark::do_not_optimize(sw());
+    },
+    baseline,
+    iterations);
+}
+
+} // namespace
+
+/**
+ * @brief Compares deferred expressions against equivalent hand-written code.
+ *
+ * With <tt>--json=\<path\></tt>, the results are also written to @c path.
+ */
+int main(int argc, char* argv[])
+{
+  using namespace deferred;
+
+  char const* json = nullptr;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strncmp(argv[i], "--json=", 7) == 0)
+    {
+      json = argv[i] + 7;
+    }
+    else
+    {
+      std::fprintf(stderr, "usage: %s [--json=<path>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  constexpr std::size_t iterations = 1 << 20;
+
+  benchmark::report report;
+  benchmark::report::print_header();
+
+  // scalar operators
+  {
+    auto a  = variable(1.5);
+    auto x  = variable(0.0);
+    auto y  = variable(2.0);
+    auto ex = (a * x + y) * (x - a) / (y + 1.0);
+
+    double v = 0.0;
+    report.compare(
+      "operators",
+      [&] {
+        x = v;
+        v += 1.0;
+        benchmark::do_not_optimize(ex());
+      },
+      [&] {
+        // a and y are read on every iteration, as the deferred expression does
+        auto const av = a();
+        auto const yv = y();
+        auto const xv = v;
+        v += 1.0;
+        benchmark::do_not_optimize((av * xv + yv) * (xv - av) / (yv + 1.0));
+      },
+      iterations);
+  }
+
+  // variable_ updates
+  {
+    auto x  = variable(0);
+    auto ex = x + 1;
+
+    int v = 0;
+    int p = 0;
+    report.compare(
+      "variable",
+      [&] {
+        x = v++;
+        benchmark::do_not_optimize(ex());
+      },
+      [&] {
+        p = v++;
+        benchmark::do_not_optimize(p + 1);
+      },
+      iterations);
+  }
+
+  // if_ and switch_ dispatch
+  dispatch<2>(report, iterations);
+  dispatch<8>(report, iterations);
+  dispatch<32>(report, iterations);
+
+  // while_ loops
+  {
+    constexpr int n = 1000;
+
+    auto i    = variable(0);
+    auto sum  = variable(0);
+    auto loop = while_(i != n, invoke([](int& s, int v) { s += v ^ (v >> 3); }, sum, i++));
+
+    report.compare(
+      "while_/1000",
+      [&] {
+        i   = 0;
+        sum = 0;
+        loop();
+        benchmark::do_not_optimize(sum());
+      },
+      [&] {
+        int s = 0;
+        for (int v = 0; v != n; ++v)
+        {
+          s += v ^ (v >> 3);
+        }
+        benchmark::do_not_optimize(s);
+      },
+      iterations / n);
+  }
+
+  // saxpy examples
+  {
+    constexpr std::size_t n = 4096;
+
+    std::vector<float> x_data(n, 0.5f);
+    std::vector<float> y_data(n, 0.25f);
+    std::vector<float> out(n);
+
+    auto a  = variable(2.0f);
+    auto x  = constant(std::span<float const>(x_data));
+    auto y  = constant(std::span<float const>(y_data));
+    auto ex = a * x + y;
+
+    report.compare(
+      "saxpy/vector",
+      [&] {
+        elementwise_evaluate(ex, out);
+        benchmark::do_not_optimize(out.data());
+      },
+      [&] {
+        auto const av = a();
+        for (std::size_t j = 0; j < n; ++j)
+        {
+          out[j] = av * x_data[j] + y_data[j];
+        }
+        benchmark::do_not_optimize(out.data());
+      },
+      iterations / n);
+
+    std::valarray<float> xv(0.5f, n);
+    std::valarray<float> yv(0.25f, n);
+    std::valarray<float> outv(n);
+
+    auto dx  = constant(xv);
+    auto dy  = constant(yv);
+    auto exv = a * dx + dy;
+
+    report.compare(
+      "saxpy/valarray",
+      [&] {
+        elementwise_evaluate(exv, outv);
+        benchmark::do_not_optimize(&outv[0]);
+      },
+      [&] {
+        outv = a() * xv + yv;
+        benchmark::do_not_optimize(&outv[0]);
+      },
+      iterations / n);
+  }
+
+  if (json != nullptr && !report.write_json(json))
+  {
+    std::fprintf(stderr, "cannot write %s\n", json);
+    return 1;
+  }
+  return 0;
+}
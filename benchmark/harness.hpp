@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_BENCHMARK_HARNESS_HPP
+#define DEFERRED_BENCHMARK_HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace deferred::benchmark {
+
+/**
+ * @brief Prevents the compiler from optimizing away @p t.
+ * @tparam T Type of the value.
+ * @param t Value to keep.
+ */
+template<typename T>
+inline void do_not_optimize(T const& t)
+{
+  asm volatile("" : : "r,m"(t) : "memory");
+}
+
+/**
+ * @brief Returns the minimum time in nanoseconds per iteration of @p f.
+ *
+ * @p f is called @p iterations times per repetition, and the fastest of @p repetitions is kept.
+ *
+ * @tparam F Type of the function to benchmark.
+ * @param f Function to benchmark.
+ * @param iterations Number of calls per repetition.
+ * @param repetitions Number of repetitions.
+ */
+template<typename F>
+double measure(F&& f, std::size_t iterations, std::size_t repetitions = 5)
+{
+  using clock = std::chrono::steady_clock;
+
+  f(); // warm-up
+  auto best = std::chrono::duration<double, std::nano>::max();
+  for (std::size_t r = 0; r < repetitions; ++r)
+  {
+    auto const start = clock::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+      f();
+    }
+    best = std::min<std::chrono::duration<double, std::nano>>(best, clock::now() - start);
+  }
+  return best.count() / static_cast<double>(iterations);
+}
+
+/// @brief Returns the name and version of the compiler.
+inline char const* compiler_name() noexcept
+{
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#else
+  return "unknown";
+#endif
+}
+
+/**
+ * @brief Times of a benchmark that is implemented with deferred expressions and hand-written
+ * code.
+ */
+struct comparison
+{
+  std::string name;
+  double deferred_ns;
+  double baseline_ns;
+};
+
+/**
+ * @brief Collects @ref comparison results, prints them as a table and writes them as JSON.
+ */
+class report
+{
+  std::vector<comparison> m_results;
+
+public:
+  /**
+   * @brief Measures @p deferred and @p baseline and stores the result as @p name.
+   *
+   * @tparam D Type of the function that uses deferred expressions.
+   * @tparam B Type of the hand-written function.
+   * @param name Name of the benchmark; it is written to JSON as is, so it must not need escaping.
+   * @param deferred Function that uses deferred expressions.
+   * @param baseline Hand-written function that computes the same result.
+   * @param iterations Number of calls per repetition.
+   */
+  template<typename D, typename B>
+  void compare(std::string name, D&& deferred, B&& baseline, std::size_t iterations)
+  {
+    auto const d = measure(std::forward<D>(deferred), iterations);
+    auto const b = measure(std::forward<B>(baseline), iterations);
+    std::printf("%-28s %12.3f %12.3f %8.2fx\n", name.c_str(), d, b, d / b);
+    m_results.push_back({std::move(name), d, b});
+  }
+
+  /// @brief Prints the header of the table.
+  static void print_header()
+  {
+    std::printf("%-28s %12s %12s %9s\n", "benchmark", "deferred ns", "baseline ns", "ratio");
+  }
+
+  /**
+   * @brief Writes the results as JSON to @p path.
+   * @return @c true if the file was written.
+   */
+  bool write_json(char const* path) const
+  {
+    auto* file = std::fopen(path, "w");
+    if (file == nullptr)
+    {
+      return false;
+    }
+    std::fprintf(file, "{\n  \"compiler\": \"%s\",\n  \"benchmarks\": [", compiler_name());
+    for (std::size_t i = 0; i < m_results.size(); ++i)
+    {
+      auto const& r = m_results[i];
+      std::fprintf(file,
+                   "%s\n    {\"name\": \"%s\", \"deferred_ns\": %.4f, \"baseline_ns\": %.4f, "
+                   "\"ratio\": %.4f}",
+                   i == 0 ? "" : ",",
+                   r.name.c_str(),
+                   r.deferred_ns,
+                   r.baseline_ns,
+                   r.deferred_ns / r.baseline_ns);
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+    return std::fclose(file) == 0;
+  }
+};
+
+} // namespace deferred::benchmark
+
+#endif
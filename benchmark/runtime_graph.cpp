@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "deferred/deferred.hpp"
+#include "harness.hpp"
+
+namespace {
+
+using graph_type = deferred::runtime_graph<std::int64_t>;
+
+// Tree-walking interpreter of a runtime_graph, with variables resolved per node.
+class tree_interpreter
+{
+  graph_type const& m_graph;
+  std::vector<deferred::variable_<std::int64_t>*> m_variables;
+
+public:
+  tree_interpreter(graph_type const& graph, deferred::runtime_bindings<std::int64_t> const& b) :
+    m_graph(graph), m_variables(graph.size(), nullptr)
+  {
+    for (std::uint32_t i = 0; i < graph.size(); ++i)
+    {
+      if (graph[deferred::runtime_node{i}].kind == graph_type::node_kind::variable)
+      {
+        m_variables[i] = b.find(graph[deferred::runtime_node{i}].name)->second;
+      }
+    }
+  }
+
+  std::int64_t operator()(std::uint32_t id) const
+  {
+    using deferred::runtime_operator;
+    using kind = graph_type::node_kind;
+
+    auto const& n = m_graph[deferred::runtime_node{id}];
+    switch (n.kind)
+    {
+      case kind::constant:
+        return n.value;
+      case kind::variable:
+        return (*m_variables[id])();
+      case kind::if_:
+        return (*this)(n.operands[0]) != 0 ? (*this)(n.operands[1]) : (*this)(n.operands[2]);
+      case kind::switch_:
+      {
+        auto const c = (*this)(n.operands[0]);
+        for (std::size_t i = 0; i < n.labels.size(); ++i)
+        {
+          if (n.labels[i] == c)
+          {
+            return (*this)(n.operands[i + 2]);
+          }
+        }
+        return (*this)(n.operands[1]);
+      }
+      case kind::operation:
+      {
+        auto const a = (*this)(n.operands[0]);
+        switch (n.op)
+        {
+          case runtime_operator::plus:
+            return a + (*this)(n.operands[1]);
+          case runtime_operator::minus:
+            return a - (*this)(n.operands[1]);
+          case runtime_operator::multiplies:
+            return a * (*this)(n.operands[1]);
+          case runtime_operator::modulus:
+            return a % (*this)(n.operands[1]);
+          case runtime_operator::less:
+            return a < (*this)(n.operands[1]);
+          default:
+            return 0;
+        }
+      }
+      default:
+        return 0;
+    }
+  }
+};
+
+} // namespace
+
+/**
+ * @brief Compares a statically typed expression with the same expression built as a
+ * runtime_graph, evaluated by the bytecode interpreter and by a tree-walking interpreter.
+ */
+int main()
+{
+  using namespace deferred;
+
+  constexpr std::size_t n = 4096;
+
+  auto x = variable<std::int64_t>();
+  auto y = variable<std::int64_t>(1000);
+
+  // if (x < y) (x * 3 + y) % 7 else switch (x % 4) { 0: x - y, 1: y, default: x * 2 }
+  auto static_ex = if_(x < y, (x * 3 + y) % 7)
+                     .else_(switch_(x % 4, default_(x * 2), case_(0, x - y), case_(1, y * 1)));
+
+  graph_type g;
+  auto const gx     = g.variable("x");
+  auto const gy     = g.variable("y");
+  auto const x3     = g.operation(runtime_operator::multiplies, gx, g.constant(3));
+  auto const lhs    = g.operation(
+    runtime_operator::modulus, g.operation(runtime_operator::plus, x3, gy), g.constant(7));
+  auto const rhs    = g.switch_(g.operation(runtime_operator::modulus, gx, g.constant(4)),
+                             {{0, g.operation(runtime_operator::minus, gx, gy)}, {1, gy}},
+                             g.operation(runtime_operator::multiplies, gx, g.constant(2)));
+  auto const root   = g.if_(g.operation(runtime_operator::less, gx, gy), lhs, rhs);
+  auto const bind   = runtime_bindings<std::int64_t>{{"x", &x}, {"y", &y}};
+  auto const prog   = g.compile(root, bind);
+  auto const walker = tree_interpreter(g, bind);
+
+  auto const run = [&](auto&& f) {
+    return benchmark::measure(
+             [&] {
+               std::int64_t sum = 0;
+               for (std::size_t i = 0; i < n; ++i)
+               {
+                 x = static_cast<std::int64_t>(i);
+                 sum += f();
+               }
+               benchmark::do_not_optimize(sum);
+             },
+             200)
+           / n;
+  };
+
+  auto const static_t   = run([&] { return static_ex(); });
+  auto const bytecode_t = run([&] { return prog(); });
+  auto const tree_t     = run([&] { return walker(root.id); });
+
+  std::printf("%-20s %12s %10s\n", "evaluation", "ns/eval", "vs static");
+  std::printf("%-20s %12.3f %9.2fx\n", "static", static_t, 1.0);
+  std::printf("%-20s %12.3f %9.2fx\n", "bytecode", bytecode_t, bytecode_t / static_t);
+  std::printf("%-20s %12.3f %9.2fx\n", "tree-walking", tree_t, tree_t / static_t);
+  std::printf("%zu instructions, %zu registers\n", prog.instruction_count(), prog.register_count());
+
+  return 0;
+}
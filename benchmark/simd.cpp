@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstddef>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "deferred/deferred.hpp"
+#include "harness.hpp"
+
+namespace {
+
+constexpr char const* isa_name(deferred::simd_isa isa)
+{
+  switch (isa)
+  {
+    case deferred::simd_isa::sse2:
+      return "sse2";
+    case deferred::simd_isa::avx2:
+      return "avx2";
+    case deferred::simd_isa::avx512:
+      return "avx512";
+    default:
+      return "scalar";
+  }
+}
+
+} // namespace
+
+/// @brief Compares element-wise evaluation of saxpy for every supported instruction set.
+int main()
+{
+  using namespace deferred;
+
+  constexpr std::size_t n          = 1 << 16;
+  constexpr std::size_t iterations = 2000;
+
+  std::vector<float> x_data(n, 0.5f);
+  std::vector<float> y_data(n, 0.25f);
+  std::vector<float> out(n);
+
+  auto a  = variable(2.0f);
+  auto x  = constant(std::span<float const>(x_data));
+  auto y  = constant(std::span<float const>(y_data));
+  auto ex = a * x + y;
+
+  auto const baseline = benchmark::measure(
+    [&] {
+      auto const av = a();
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        out[i] = av * x_data[i] + y_data[i];
+      }
+      benchmark::do_not_optimize(out.data());
+    },
+    iterations);
+  std::printf("%-10s %6s %12s %10s\n", "isa", "lanes", "ns/element", "speedup");
+  std::printf("%-10s %6s %12.4f %10s\n", "loop", "-", baseline / n, "-");
+
+  double scalar = 0.0;
+  for (auto isa : {simd_isa::scalar, simd_isa::sse2, simd_isa::avx2, simd_isa::avx512})
+  {
+    if (isa > detected_simd_isa())
+    {
+      break;
+    }
+    auto const t = benchmark::measure(
+      [&] {
+        elementwise_evaluate(ex, out, isa);
+        benchmark::do_not_optimize(out.data());
+      },
+      iterations);
+    if (isa == simd_isa::scalar)
+    {
+      scalar = t;
+    }
+    std::printf(
+      "%-10s %6zu %12.4f %9.2fx\n", isa_name(isa), simd_lanes<float>(isa), t / n, scalar / t);
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "deferred/deferred.hpp"
+#include "harness.hpp"
+
+namespace {
+
+std::uint64_t fib(deferred::thread_pool& pool, std::uint64_t n)
+{
+  if (n < 16)
+  {
+    return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+  }
+  std::uint64_t x = 0, y = 0;
+  deferred::fork_join(pool, [&] { x = fib(pool, n - 1); }, [&] { y = fib(pool, n - 2); });
+  return x + y;
+}
+
+double work(double x)
+{
+  for (int i = 0; i < 200000; ++i)
+  {
+    x = std::sqrt(x + 1.0);
+  }
+  return x;
+}
+
+} // namespace
+
+/// @brief Measures fork-join and par_ scaling of the work-stealing thread pool over 1..N threads.
+int main()
+{
+  using namespace deferred;
+
+  auto const max_threads = thread_pool::default_concurrency();
+  auto x                 = variable(1.0);
+  auto sum               = [](auto... v) { return (v + ...); };
+  auto leaf              = [&](double k) {
+    return invoke([k](double v) { return work(v + k); }, x);
+  };
+
+  std::printf(
+    "%-8s %14s %9s %14s %9s\n", "threads", "fib(32) ms", "speedup", "par_ x6 ms", "speedup");
+  double fib_base = 0.0;
+  double par_base = 0.0;
+  for (std::size_t n = 1; n <= max_threads; ++n)
+  {
+    thread_pool pool(n);
+    auto ex = par_(pool, invoke(sum, leaf(0), leaf(1), leaf(2), leaf(3), leaf(4), leaf(5)));
+
+    auto const fib_t = benchmark::measure([&] { benchmark::do_not_optimize(fib(pool, 32)); }, 1, 3);
+    auto const par_t = benchmark::measure([&] { benchmark::do_not_optimize(ex()); }, 10, 3);
+    if (n == 1)
+    {
+      fib_base = fib_t;
+      par_base = par_t;
+    }
+    std::printf("%-8zu %14.2f %8.2fx %14.3f %8.2fx\n",
+                n,
+                fib_t / 1e6,
+                fib_base / fib_t,
+                par_t / 1e6,
+                par_base / par_t);
+  }
+
+  return 0;
+}
@@ -7,6 +7,7 @@
 #include <valarray>
 
 #include "deferred/deferred.hpp"
+#include "deferred/elementwise.hpp"
 #include "deferred/type_name.hpp"
 
 /// @brief Visitor to print the deferred expression tree.
@@ -67,12 +68,14 @@ int main()
             std::ostream_iterator<float>(std::cout, " "));
   std::cout << "\n\n";
 
-  // FIXME this is not
+  // evaluating the whole chain through std::valarray operators would return an expression
+  // template that refers to destroyed temporaries, so it is evaluated element-wise in one pass
   auto dres = partial_dres + dy;
 
   dres.visit(print_visitor{});
 
-  std::valarray<float> eval_res = dres();
+  std::valarray<float> eval_res(x.size());
+  elementwise_evaluate(dres, eval_res);
   std::cout << "deferred result: ";
   std::copy(std::begin(eval_res), std::end(eval_res), std::ostream_iterator<float>(std::cout, " "));
   std::cout << '\n';
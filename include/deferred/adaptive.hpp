@@ -0,0 +1,351 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_ADAPTIVE_HPP
+#define DEFERRED_ADAPTIVE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "conditional.hpp"
+#include "detail/map_result.hpp"
+#include "evaluate.hpp"
+#include "expression.hpp"
+#include "switch.hpp"
+#include "type_traits/is_pure_expression.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/**
+ * @brief Tests and evaluates the cases of an expression in any order.
+ *
+ * Cases are indexed in declaration order. The fallback (@c default or @c else) is not a case.
+ */
+template<typename T>
+struct adaptive_cases;
+
+/// @brief Specialization for @ref switch_expression.
+template<typename Condition, typename Default, typename... Cases>
+struct adaptive_cases<switch_expression<Condition, Default, Cases...>>
+{
+  using expression_type = switch_expression<Condition, Default, Cases...>;
+  using result_type     = typename expression_type::result_type;
+
+  static constexpr std::size_t size = sizeof...(Cases);
+
+  /// @brief Evaluates the value that the cases are tested against.
+  [[nodiscard]] static constexpr auto key(expression_type const& e)
+  {
+    return evaluate(e.condition());
+  }
+
+  using key_type = decltype(key(std::declval<expression_type const&>()));
+
+  template<std::size_t I>
+  [[nodiscard]] static constexpr bool test(expression_type const& e, key_type const& k)
+  {
+    // index 0 is the default
+    return static_cast<bool>(detail::get<I + 1>(e.cases()).compare(k));
+  }
+
+  template<std::size_t I>
+  [[nodiscard]] static constexpr result_type evaluate_case(expression_type const& e)
+  {
+    return detail::map_result<result_type>([&] { return detail::get<I + 1>(e.cases())(); });
+  }
+
+  [[nodiscard]] static constexpr result_type evaluate_fallback(expression_type const& e)
+  {
+    return detail::map_result<result_type>([&] { return detail::get<0>(e.cases())(); });
+  }
+};
+
+/// @brief Specialization for @ref conditional_expression.
+template<typename Else, typename... Branches>
+struct adaptive_cases<conditional_expression<Else, Branches...>>
+{
+  using expression_type = conditional_expression<Else, Branches...>;
+  using result_type     = typename expression_type::result_type;
+
+  static constexpr std::size_t size = sizeof...(Branches);
+
+  struct key_type
+  { };
+
+  [[nodiscard]] static constexpr key_type key(expression_type const&) noexcept
+  {
+    return {};
+  }
+
+  template<std::size_t I>
+  [[nodiscard]] static constexpr bool test(expression_type const& e, key_type const&)
+  {
+    return static_cast<bool>(evaluate(detail::get<I>(e.branches()).condition));
+  }
+
+  template<std::size_t I>
+  [[nodiscard]] static constexpr result_type evaluate_case(expression_type const& e)
+  {
+    using base_result_type = typename expression_type::base_result_type;
+    return detail::map_result<base_result_type>(
+      [&] { return evaluate(detail::get<I>(e.branches()).then); });
+  }
+
+  [[nodiscard]] static constexpr result_type evaluate_fallback(expression_type const& e)
+  {
+    if constexpr (expression_type::finalized)
+    {
+      return detail::map_result<result_type>([&] { return evaluate(e.else_branch()); });
+    }
+    else if constexpr (!std::is_void_v<result_type>)
+    {
+      return std::nullopt;
+    }
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Deferred expression that tests the cases of a @ref switch_expression or the branches of a
+ * @ref conditional_expression in order of decreasing frequency.
+ *
+ * It counts how many times each case matches and, every @c period evaluations, reorders the cases
+ * so that the most frequent ones are tested first. The fallback (@c default_ or @c else_) is
+ * always chosen last. The counts can be exported with @ref frequencies() and used to construct an
+ * expression with a fixed order.
+ *
+ * Reordering preserves the result only if at most one case can match, i.e., the switch labels are
+ * distinct or the conditions are mutually exclusive; creating an adaptive expression declares
+ * that this holds. Switches with a lookup or hash table do not test cases in order and do not
+ * benefit from it.
+ *
+ * The counts are updated during evaluation, therefore the expression must not be evaluated
+ * concurrently.
+ *
+ * @tparam Expression Type of the @ref switch_expression or @ref conditional_expression.
+ */
+template<Deferred Expression>
+class adaptive_expression
+{
+  using cases_type = detail::adaptive_cases<std::remove_cvref_t<Expression>>;
+  using key_type   = typename cases_type::key_type;
+
+public:
+  using expression_type     = Expression;
+  using subexpression_types = std::tuple<Expression>;
+  using result_type         = typename cases_type::result_type;
+
+  /// @brief Number of cases, without the fallback.
+  static constexpr std::size_t case_count = cases_type::size;
+
+  /**
+   * @brief Number of matches per case in declaration order; the last element is the fallback.
+   */
+  using frequencies_type = std::array<std::uint64_t, case_count + 1>;
+
+  /// @brief Order in which the cases are tested, as indices in declaration order.
+  using order_type = std::array<std::size_t, case_count>;
+
+  /// @brief Default number of evaluations between reorderings.
+  static constexpr std::uint64_t default_period = 1024;
+
+private:
+  using test_function = bool (*)(std::remove_cvref_t<Expression> const&, key_type const&);
+  using case_function = result_type (*)(std::remove_cvref_t<Expression> const&);
+
+  template<std::size_t... I>
+  [[nodiscard]] static constexpr auto make_test_table(std::index_sequence<I...>)
+  {
+    return std::array<test_function, sizeof...(I)>{&cases_type::template test<I>...};
+  }
+
+  template<std::size_t... I>
+  [[nodiscard]] static constexpr auto make_case_table(std::index_sequence<I...>)
+  {
+    return std::array<case_function, sizeof...(I)>{&cases_type::template evaluate_case<I>...};
+  }
+
+  /// @brief Functions that test each case, in declaration order.
+  static constexpr auto s_test_table = make_test_table(std::make_index_sequence<case_count>{});
+
+  /// @brief Functions that evaluate each case, in declaration order.
+  static constexpr auto s_case_table = make_case_table(std::make_index_sequence<case_count>{});
+
+  Expression m_expression;
+  std::uint64_t m_period;
+  mutable std::uint64_t m_countdown;
+  mutable frequencies_type m_frequencies{};
+  mutable order_type m_order;
+
+  /// @brief Sorts the cases by decreasing frequency; ties keep their relative order.
+  constexpr void reorder() const noexcept
+  {
+    // insertion sort, as there are few cases and the order rarely changes
+    for (std::size_t i = 1; i < case_count; ++i)
+    {
+      auto const c = m_order[i];
+      auto j       = i;
+      for (; j > 0 && m_frequencies[m_order[j - 1]] < m_frequencies[c]; --j)
+      {
+        m_order[j] = m_order[j - 1];
+      }
+      m_order[j] = c;
+    }
+  }
+
+  constexpr void record(std::size_t i) const noexcept
+  {
+    ++m_frequencies[i];
+    if (m_period != 0 && --m_countdown == 0)
+    {
+      m_countdown = m_period;
+      reorder();
+    }
+  }
+
+public:
+  /**
+   * @brief Constructs an adaptive_expression that tests the cases in declaration order.
+   * @tparam E Type of the expression.
+   * @param e Expression to evaluate.
+   * @param period Number of evaluations between reorderings, or @c 0 to never reorder.
+   */
+  template<typename E>
+  constexpr explicit adaptive_expression(E&& e, std::uint64_t period) :
+    m_expression(std::forward<E>(e)), m_period(period), m_countdown(period)
+  {
+    for (std::size_t i = 0; i < case_count; ++i)
+    {
+      m_order[i] = i;
+    }
+  }
+
+  /**
+   * @brief Constructs an adaptive_expression that tests the cases in order of decreasing
+   * @p frequencies.
+   * @tparam E Type of the expression.
+   * @param e Expression to evaluate.
+   * @param frequencies Number of matches per case, e.g., from @ref frequencies().
+   * @param period Number of evaluations between reorderings, or @c 0 to never reorder.
+   */
+  template<typename E>
+  constexpr explicit adaptive_expression(E&& e,
+                                         frequencies_type const& frequencies,
+                                         std::uint64_t period) :
+    adaptive_expression(std::forward<E>(e), period)
+  {
+    m_frequencies = frequencies;
+    reorder();
+  }
+
+  /// @brief Returns the number of matches per case since construction.
+  [[nodiscard]] constexpr frequencies_type const& frequencies() const noexcept
+  {
+    return m_frequencies;
+  }
+
+  /// @brief Returns the order in which the cases are tested.
+  [[nodiscard]] constexpr order_type const& order() const noexcept
+  {
+    return m_order;
+  }
+
+  /**
+   * @brief Evaluates the adaptive expression.
+   * @return Result of the expression.
+   */
+  [[nodiscard]] constexpr result_type operator()() const
+  {
+    auto const& e   = static_cast<std::remove_cvref_t<Expression> const&>(m_expression);
+    auto const& key = cases_type::key(e);
+    for (auto const i : m_order)
+    {
+      if (s_test_table[i](e, key))
+      {
+        record(i);
+        return s_case_table[i](e);
+      }
+    }
+    record(case_count);
+    return cases_type::evaluate_fallback(e);
+  }
+
+  /**
+   * @brief Visits the adaptive expression with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    m_expression.visit(std::forward<Visitor>(v), nesting + 1);
+  }
+};
+
+/// @brief Specialization for @ref adaptive_expression, which counts matches.
+template<typename Expression>
+struct is_stateful_expression<adaptive_expression<Expression>> : public std::true_type
+{ };
+
+/**
+ * @brief Creates a new @ref adaptive_expression that tests the cases of @p expr in order of
+ * decreasing frequency, reordering them every @p period evaluations.
+ *
+ * At most one case of @p expr may match (see @ref adaptive_expression).
+ *
+ * Example:
+ * @code
+ * auto ex = adaptive_(switch_(type, default_(unknown), case_(login, ...), case_(data, ...)));
+ * ex(); // after enough evaluations, data is tested first if it matches more often
+ * save(ex.frequencies());
+ * auto fixed = adaptive_(switch_(...), load(), 0); // data is tested first
+ * @endcode
+ *
+ * @tparam Expression Type of the @ref switch_expression or @ref conditional_expression.
+ * @param expr Expression to evaluate.
+ * @param period Number of evaluations between reorderings, or @c 0 to never reorder.
+ * @return An @ref adaptive_expression for @p expr.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr auto
+adaptive_(Expression&& expr,
+          std::uint64_t period = adaptive_expression<make_deferred_t<Expression>>::default_period)
+{
+  return adaptive_expression<make_deferred_t<Expression>>(std::forward<Expression>(expr), period);
+}
+
+/**
+ * @brief Creates a new @ref adaptive_expression that tests the cases of @p expr in order of
+ * decreasing @p frequencies.
+ *
+ * @tparam Expression Type of the @ref switch_expression or @ref conditional_expression.
+ * @param expr Expression to evaluate.
+ * @param frequencies Number of matches per case, e.g., from
+ * @ref adaptive_expression::frequencies().
+ * @param period Number of evaluations between reorderings, or @c 0 to keep the order fixed.
+ * @return An @ref adaptive_expression for @p expr.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr auto
+adaptive_(Expression&& expr,
+          typename adaptive_expression<make_deferred_t<Expression>>::frequencies_type const&
+            frequencies,
+          std::uint64_t period = 0)
+{
+  return adaptive_expression<make_deferred_t<Expression>>(
+    std::forward<Expression>(expr), frequencies, period);
+}
+
+} // namespace deferred
+
+#endif
@@ -0,0 +1,367 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_ANY_EXPRESSION_HPP
+#define DEFERRED_ANY_EXPRESSION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#include "evaluate.hpp"
+#include "expression.hpp"
+#include "type_traits/is_deferred.hpp"
+
+namespace deferred {
+
+/**
+ * @brief Node of an expression that is visited through a @ref basic_any_expression.
+ */
+struct any_node
+{
+  /// @brief Address of the node.
+  void const* address;
+  /// @brief Type of the node.
+  std::type_info const* type;
+};
+
+namespace detail {
+
+/// @brief Non-owning reference to a visitor that accepts an @ref any_node.
+class any_visitor_ref
+{
+  void* m_visitor;
+  void (*m_invoke)(void*, any_node, std::size_t);
+
+public:
+  template<typename Visitor>
+  explicit any_visitor_ref(Visitor& v) noexcept :
+    m_visitor(const_cast<void*>(static_cast<void const*>(std::addressof(v)))),
+    m_invoke([](void* p, any_node node, std::size_t nesting) {
+      (*static_cast<Visitor*>(p))(node, nesting);
+    })
+  { }
+
+  template<typename Node>
+  void operator()(Node const& node, std::size_t nesting) const
+  {
+    m_invoke(m_visitor, any_node{std::addressof(node), &typeid(Node)}, nesting);
+  }
+};
+
+/// @brief Stores a pointer to an expression that is referenced by a @ref basic_any_expression.
+template<typename Expression>
+class referenced_expression
+{
+  Expression* m_expression;
+
+public:
+  explicit referenced_expression(Expression& e) noexcept : m_expression(std::addressof(e))
+  { }
+
+  [[nodiscard]] Expression& get() const noexcept
+  {
+    return *m_expression;
+  }
+};
+
+/// @brief Returns the expression that is stored as @p e.
+template<typename E>
+[[nodiscard]] constexpr E const& stored_expression(E const& e) noexcept
+{
+  return e;
+}
+
+/// @copydoc stored_expression
+template<typename E>
+[[nodiscard]] constexpr E& stored_expression(referenced_expression<E> const& e) noexcept
+{
+  return e.get();
+}
+
+} // namespace detail
+
+/**
+ * @brief Type-erased deferred expression that returns @p R.
+ *
+ * Expressions that fit in @p Size bytes and are nothrow move constructible are stored inline;
+ * others are allocated on the heap. Evaluation is an indirect call through a table of functions
+ * that is shared by all objects that store the same expression type.
+ *
+ * Like other nodes, it references lvalue expressions and owns (moves) rvalue expressions. An empty
+ * object (e.g., default-constructed or moved-from) throws @c std::bad_function_call when it is
+ * evaluated.
+ *
+ * Visiting it visits the stored expression; the nodes of the stored expression are passed to the
+ * visitor as @ref any_node.
+ *
+ * @tparam R Result type.
+ * @tparam Size Size of the inline storage in bytes.
+ * @tparam Copyable @c true if the object is copyable, which requires that stored expressions are
+ * copy constructible.
+ */
+template<typename R, std::size_t Size, bool Copyable>
+class basic_any_expression
+{
+public:
+  using result_type = R;
+  // the stored expression is not known, so it is neither constant nor pure
+  using subexpression_types = void;
+
+  /// @brief Size of the inline storage.
+  static constexpr std::size_t buffer_size = Size;
+
+private:
+  static constexpr std::size_t buffer_alignment = alignof(std::max_align_t);
+
+  union storage
+  {
+    void* m_heap;
+    alignas(buffer_alignment) std::byte m_buffer[Size > 0 ? Size : 1];
+  };
+
+  struct vtable
+  {
+    R (*invoke)(storage const&);
+    void (*move)(storage&, storage&) noexcept;
+    void (*copy)(storage&, storage const&);
+    void (*destroy)(storage&) noexcept;
+    void (*visit)(storage const&, detail::any_visitor_ref, std::size_t);
+  };
+
+  template<typename T>
+  static constexpr bool is_inline = sizeof(T) <= Size && alignof(T) <= buffer_alignment
+                                    && std::is_nothrow_move_constructible_v<T>;
+
+  template<typename T>
+  [[nodiscard]] static T& get(storage& s) noexcept
+  {
+    if constexpr (is_inline<T>)
+    {
+      return *std::launder(reinterpret_cast<T*>(s.m_buffer));
+    }
+    else
+    {
+      return *static_cast<T*>(s.m_heap);
+    }
+  }
+
+  template<typename T>
+  [[nodiscard]] static T const& get(storage const& s) noexcept
+  {
+    return get<T>(const_cast<storage&>(s));
+  }
+
+  template<typename T, typename... Args>
+  static void construct(storage& s, Args&&... args)
+  {
+    if constexpr (is_inline<T>)
+    {
+      ::new (static_cast<void*>(s.m_buffer)) T(std::forward<Args>(args)...);
+    }
+    else
+    {
+      s.m_heap = new T(std::forward<Args>(args)...);
+    }
+  }
+
+  template<typename T>
+  static constexpr vtable s_vtable = {
+    [](storage const& s) -> R {
+      auto const& e = detail::stored_expression(get<T>(s));
+      if constexpr (std::is_void_v<R>)
+      {
+        static_cast<void>(evaluate(e));
+      }
+      else
+      {
+        return evaluate(e);
+      }
+    },
+    [](storage& dst, storage& src) noexcept {
+      if constexpr (is_inline<T>)
+      {
+        ::new (static_cast<void*>(dst.m_buffer)) T(std::move(get<T>(src)));
+        get<T>(src).~T();
+      }
+      else
+      {
+        dst.m_heap = std::exchange(src.m_heap, nullptr);
+      }
+    },
+    [](storage& dst, storage const& src) {
+      if constexpr (Copyable)
+      {
+        construct<T>(dst, get<T>(src));
+      }
+    },
+    [](storage& s) noexcept {
+      if constexpr (is_inline<T>)
+      {
+        get<T>(s).~T();
+      }
+      else
+      {
+        delete static_cast<T*>(s.m_heap);
+      }
+    },
+    [](storage const& s, detail::any_visitor_ref v, std::size_t nesting) {
+      detail::stored_expression(get<T>(s)).visit(v, nesting);
+    }};
+
+  storage m_storage;
+  vtable const* m_vtable = nullptr;
+
+  template<typename E>
+  using stored_type = std::conditional_t<std::is_lvalue_reference_v<make_deferred_t<E>>,
+                                         detail::referenced_expression<std::remove_reference_t<E>>,
+                                         make_deferred_t<E>>;
+
+public:
+  /// @brief Constructs an empty object.
+  basic_any_expression() noexcept = default;
+
+  /**
+   * @brief Constructs an object that stores @p e.
+   * @tparam E Type of the expression.
+   * @param e Expression or callable to store; callables are stored as @ref expression_.
+   */
+  template<typename E>
+    requires(!std::is_same_v<std::remove_cvref_t<E>, basic_any_expression>
+             && (Deferred<std::remove_cvref_t<E>> || std::is_invocable_v<std::decay_t<E>>)
+             && (std::is_void_v<R>
+                 || std::is_convertible_v<decltype(evaluate(std::declval<make_deferred_t<E>>())),
+                                          R>))
+  basic_any_expression(E&& e) // NOLINT(google-explicit-constructor)
+  {
+    using T = stored_type<E>;
+    static_assert(!Copyable || std::is_copy_constructible_v<T>,
+                  "Expression must be copy constructible");
+    construct<T>(m_storage, std::forward<E>(e));
+    m_vtable = &s_vtable<T>;
+  }
+
+  basic_any_expression(basic_any_expression const& other)
+    requires Copyable
+  {
+    if (other.m_vtable != nullptr)
+    {
+      other.m_vtable->copy(m_storage, other.m_storage);
+      m_vtable = other.m_vtable;
+    }
+  }
+
+  basic_any_expression(basic_any_expression&& other) noexcept
+  {
+    if (other.m_vtable != nullptr)
+    {
+      other.m_vtable->move(m_storage, other.m_storage);
+      m_vtable = std::exchange(other.m_vtable, nullptr);
+    }
+  }
+
+  basic_any_expression& operator=(basic_any_expression const& other)
+    requires Copyable
+  {
+    if (this != &other)
+    {
+      basic_any_expression tmp(other);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+
+  basic_any_expression& operator=(basic_any_expression&& other) noexcept
+  {
+    if (this != &other)
+    {
+      reset();
+      if (other.m_vtable != nullptr)
+      {
+        other.m_vtable->move(m_storage, other.m_storage);
+        m_vtable = std::exchange(other.m_vtable, nullptr);
+      }
+    }
+    return *this;
+  }
+
+  ~basic_any_expression()
+  {
+    reset();
+  }
+
+  /// @brief Destroys the stored expression.
+  void reset() noexcept
+  {
+    if (m_vtable != nullptr)
+    {
+      std::exchange(m_vtable, nullptr)->destroy(m_storage);
+    }
+  }
+
+  /// @brief Checks if an expression is stored.
+  [[nodiscard]] explicit operator bool() const noexcept
+  {
+    return m_vtable != nullptr;
+  }
+
+  /**
+   * @brief Evaluates the stored expression.
+   * @return Result of the expression converted to @p R.
+   * @throws std::bad_function_call if no expression is stored.
+   */
+  R operator()() const
+  {
+    if (m_vtable == nullptr)
+    {
+      throw std::bad_function_call();
+    }
+    return m_vtable->invoke(m_storage);
+  }
+
+  /**
+   * @brief Visits the expression with a visitor.
+   *
+   * The nodes of the stored expression are passed to @p v as @ref any_node.
+   *
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    v(*this, nesting);
+    if (m_vtable != nullptr)
+    {
+      m_vtable->visit(m_storage, detail::any_visitor_ref(v), nesting + 1);
+    }
+  }
+};
+
+/// @brief Default size of the inline storage of @ref any_expression.
+inline constexpr std::size_t default_any_expression_size = 4 * sizeof(void*);
+
+/**
+ * @brief Copyable type-erased expression that returns @p R.
+ * @tparam R Result type.
+ * @tparam Size Size of the inline storage in bytes.
+ */
+template<typename R, std::size_t Size = default_any_expression_size>
+using any_expression = basic_any_expression<R, Size, true>;
+
+/**
+ * @brief Move-only type-erased expression that returns @p R.
+ * @tparam R Result type.
+ * @tparam Size Size of the inline storage in bytes.
+ */
+template<typename R, std::size_t Size = default_any_expression_size>
+using move_only_any_expression = basic_any_expression<R, Size, false>;
+
+} // namespace deferred
+
+#endif
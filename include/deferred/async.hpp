@@ -0,0 +1,308 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_ASYNC_HPP
+#define DEFERRED_ASYNC_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/// @brief Checks if @p T is a @ref task.
+template<typename T>
+inline constexpr bool is_task_v = false;
+
+/// @brief Specialization for @ref task.
+template<typename T>
+inline constexpr bool is_task_v<task<T>> = true;
+
+/**
+ * @brief Awaiter that resumes the awaiting coroutine on a worker of a @ref thread_pool.
+ */
+class schedule_awaiter
+{
+  thread_pool* m_pool;
+
+public:
+  explicit schedule_awaiter(thread_pool& pool) noexcept : m_pool(&pool)
+  { }
+
+  [[nodiscard]] bool await_ready() const noexcept
+  {
+    return false;
+  }
+
+  void await_suspend(std::coroutine_handle<> h) const
+  {
+    m_pool->submit([h] { h.resume(); });
+  }
+
+  void await_resume() const noexcept
+  { }
+};
+
+} // namespace detail
+
+/**
+ * @brief Deferred expression whose evaluation may wait (e.g., on I/O or another thread).
+ *
+ * When it is evaluated with @ref co_evaluate, @p F is invoked on a worker of a @ref thread_pool
+ * and the awaiting coroutine is suspended until it returns. If @p F returns a @ref task, the task
+ * is awaited instead.
+ *
+ * When it is evaluated synchronously, @p F is invoked on the calling thread, and a returned
+ * @ref task is waited for with @ref sync_wait.
+ *
+ * @tparam F Type of the callable.
+ */
+template<typename F>
+class async_expression
+{
+  using invoke_result_type = std::invoke_result_t<F const&>;
+
+  template<typename T>
+  struct task_value
+  {
+    using type = T;
+  };
+
+  template<typename T>
+  struct task_value<task<T>>
+  {
+    using type = T;
+  };
+
+public:
+  using function_type = F;
+  // the thread pool is not a deferred type, therefore the expression is never constant
+  using subexpression_types = std::tuple<F, thread_pool*>;
+  using result_type         = typename task_value<invoke_result_type>::type;
+
+private:
+  [[no_unique_address]] F m_f;
+  thread_pool* m_pool;
+
+public:
+  /**
+   * @brief Constructs an async_expression.
+   * @tparam G Type of the callable.
+   * @param pool Thread pool to invoke the callable on.
+   * @param g Callable.
+   */
+  template<typename G>
+  explicit async_expression(thread_pool& pool, G&& g) : m_f(std::forward<G>(g)), m_pool(&pool)
+  { }
+
+  /**
+   * @brief Evaluates the async expression on the calling thread.
+   * @return Result of the callable.
+   */
+  [[nodiscard]] result_type operator()() const
+  {
+    if constexpr (detail::is_task_v<invoke_result_type>)
+    {
+      return sync_wait(std::invoke(m_f));
+    }
+    else
+    {
+      return std::invoke(m_f);
+    }
+  }
+
+  /**
+   * @brief Evaluates the async expression asynchronously.
+   * @return A task that produces the result of the callable.
+   */
+  [[nodiscard]] task<result_type> co_evaluate() const
+  {
+    if constexpr (detail::is_task_v<invoke_result_type>)
+    {
+      co_return co_await std::invoke(m_f);
+    }
+    else
+    {
+      co_await detail::schedule_awaiter(*m_pool);
+      co_return std::invoke(m_f);
+    }
+  }
+
+  /**
+   * @brief Visits the async expression with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+  }
+};
+
+/**
+ * @brief Creates a new @ref async_expression that invokes @p f on @p pool when it is evaluated with
+ * @ref co_evaluate.
+ *
+ * @tparam F Type of the callable.
+ * @param pool Thread pool to invoke @p f on.
+ * @param f Callable, which may return a @ref task.
+ * @return An @ref async_expression for @p f.
+ */
+template<typename F>
+[[nodiscard]] auto async_(thread_pool& pool, F&& f)
+{
+  return async_expression<std::decay_t<F>>(pool, std::forward<F>(f));
+}
+
+/**
+ * @brief Creates a new @ref async_expression that invokes @p f on @ref default_thread_pool() when
+ * it is evaluated with @ref co_evaluate.
+ *
+ * @tparam F Type of the callable.
+ * @param f Callable, which may return a @ref task.
+ * @return An @ref async_expression for @p f.
+ */
+template<typename F>
+[[nodiscard]] auto async_(F&& f)
+{
+  return async_(default_thread_pool(), std::forward<F>(f));
+}
+
+namespace detail {
+
+/// @brief Checks if @p T is an @ref async_expression.
+template<typename T>
+inline constexpr bool is_async_expression_v = false;
+
+/// @brief Specialization for @ref async_expression.
+template<typename F>
+inline constexpr bool is_async_expression_v<async_expression<F>> = true;
+
+// Checks if the expression T contains an async_expression.
+template<typename T, typename = std::void_t<>>
+struct contains_async : public std::false_type
+{ };
+
+// Matches the tuple of subexpressions for a deferred type.
+template<typename... T>
+struct contains_async<std::tuple<T...>> :
+  public std::disjunction<contains_async<std::decay_t<T>>...>
+{ };
+
+// If subexpression_types is defined, then it is a deferred data type.
+template<typename T>
+struct contains_async<T, std::void_t<typename T::subexpression_types>> :
+  public std::bool_constant<is_async_expression_v<T>
+                            || contains_async<typename T::subexpression_types>::value>
+{ };
+
+/// @brief Type of the result of evaluating @p E.
+template<typename E>
+using co_result_t = decltype(std::declval<E&>()());
+
+} // namespace detail
+
+template<typename Expression>
+  requires Deferred<Expression>
+task<detail::co_result_t<Expression>> co_evaluate(Expression& expr);
+
+namespace detail {
+
+/**
+ * @brief Evaluates the subexpressions of the @ref expression_ @p expr concurrently and applies
+ * its operator to the results.
+ */
+template<typename E, std::size_t... I>
+task<co_result_t<E>> co_evaluate_expression(E& expr, std::index_sequence<I...>)
+{
+  auto const& subexpressions = expr.subexpressions();
+  auto results               = co_await when_all(co_evaluate(std::get<I>(subexpressions))...);
+  co_return std::apply(
+    [&expr](auto&&... args) -> co_result_t<E> {
+      return std::invoke(expr.operator_(), std::forward<decltype(args)>(args)...);
+    },
+    std::move(results));
+}
+
+/// @brief Evaluates the expression @p expr that is owned by the coroutine.
+template<typename E>
+task<co_result_t<E>> co_evaluate_owned(E expr)
+{
+  co_return co_await co_evaluate(expr);
+}
+
+} // namespace detail
+
+/**
+ * @brief Evaluates @p expr asynchronously.
+ *
+ * Subexpressions that contain an @ref async_expression are awaited without blocking the thread,
+ * and the subexpressions of an @ref expression_ are awaited concurrently. Subexpressions without
+ * an @ref async_expression are evaluated synchronously, as are other kinds of expressions (e.g.,
+ * @ref conditional_expression) that contain an @ref async_expression.
+ *
+ * @p expr must outlive the returned task.
+ *
+ * Example:
+ * @code
+ * auto price = async_([&] { return cache.lookup(id); });
+ * auto rate  = async_([&] { return read_rate(disk); });
+ * auto ex    = price * rate;
+ * auto t     = co_evaluate(ex); // lookup and read run concurrently
+ * sync_wait(t);
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to evaluate.
+ * @return A task that produces the result of @p expr.
+ */
+template<typename Expression>
+  requires Deferred<Expression>
+task<detail::co_result_t<Expression>> co_evaluate(Expression& expr)
+{
+  using expression_type = std::remove_cv_t<Expression>;
+  if constexpr (detail::is_async_expression_v<expression_type>)
+  {
+    co_return co_await expr.co_evaluate();
+  }
+  else if constexpr (detail::is_expression_v<expression_type>
+                     && detail::contains_async<expression_type>::value)
+  {
+    using expression_types = typename expression_type::expression_types;
+    co_return co_await detail::co_evaluate_expression(
+      expr, std::make_index_sequence<std::tuple_size_v<expression_types>>{});
+  }
+  else
+  {
+    co_return expr();
+  }
+}
+
+/**
+ * @brief Evaluates the temporary @p expr asynchronously.
+ *
+ * The returned task owns a copy of @p expr.
+ *
+ * @copydetails co_evaluate(Expression&)
+ */
+template<typename Expression>
+  requires(Deferred<Expression> && !std::is_lvalue_reference_v<Expression>)
+task<detail::co_result_t<Expression>> co_evaluate(Expression&& expr)
+{
+  return detail::co_evaluate_owned(std::forward<Expression>(expr));
+}
+
+} // namespace deferred
+
+#endif
@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_CACHED_HPP
+#define DEFERRED_CACHED_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "evaluate.hpp"
+#include "expression.hpp"
+#include "type_traits/is_pure_expression.hpp"
+#include "variable.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+// Counts the variable_ nodes in the expression T.
+template<typename T, typename = std::void_t<>>
+struct variable_count : public std::integral_constant<std::size_t, 0>
+{ };
+
+// Matches variable_ nodes.
+template<typename T>
+struct variable_count<variable_<T>> : public std::integral_constant<std::size_t, 1>
+{ };
+
+// Matches the tuple of subexpressions for a deferred type.
+template<typename... T>
+struct variable_count<std::tuple<T...>> :
+  public std::integral_constant<std::size_t, (variable_count<std::decay_t<T>>::value + ... + 0)>
+{ };
+
+// If subexpression_types is defined, then it is a deferred data type.
+template<typename T>
+  requires(!is_variable_v<T>)
+struct variable_count<T, std::void_t<typename T::subexpression_types>> :
+  public variable_count<typename T::subexpression_types>
+{ };
+
+// Checks if the expression T has nodes whose subexpressions are not known at compile time.
+template<typename T, typename = std::void_t<>>
+struct has_opaque_node : public std::false_type
+{ };
+
+// Matches the tuple of subexpressions for a deferred type.
+template<typename... T>
+struct has_opaque_node<std::tuple<T...>> :
+  public std::disjunction<has_opaque_node<std::decay_t<T>>...>
+{ };
+
+// Nodes other than variable_ with subexpression_types void hide their subexpressions.
+template<typename T>
+  requires(!is_variable_v<T>)
+struct has_opaque_node<T, std::void_t<typename T::subexpression_types>> :
+  public std::bool_constant<std::is_void_v<typename T::subexpression_types>
+                            || has_opaque_node<typename T::subexpression_types>::value>
+{ };
+
+} // namespace detail
+
+/**
+ * @brief Deferred expression that stores the result of @p Expression and only re-evaluates it
+ * if a @ref variable_ in it has been modified since the last evaluation.
+ *
+ * Modifications are detected through @ref variable_::version(), which is incremented on every
+ * assignment, on deferred increment and decrement operators, and on @ref variable_::touch().
+ * Variables that are accessed only through callables (e.g., a lambda that captures a variable)
+ * are not part of the expression and their modifications are not detected; such expressions can
+ * be re-evaluated with @ref invalidate(). Expressions with nodes that hide their subexpressions
+ * (e.g., @ref basic_any_expression, @ref runtime_program) cannot be tracked and are re-evaluated on
+ * every evaluation.
+ *
+ * The result is computed at most once per modification, therefore @p Expression should not have
+ * side effects.
+ *
+ * @tparam Expression Type of the expression to cache.
+ */
+template<Deferred Expression>
+class cached_expression
+{
+public:
+  using expression_type     = Expression;
+  using subexpression_types = std::tuple<Expression>;
+  using result_type = std::remove_cvref_t<decltype(evaluate(std::declval<Expression const&>()))>;
+
+  static_assert(!std::is_void_v<result_type>, "void expressions cannot be cached");
+
+private:
+  static constexpr std::size_t max_dependencies =
+    detail::variable_count<std::decay_t<Expression>>::value;
+  static constexpr bool is_opaque = detail::has_opaque_node<std::decay_t<Expression>>::value;
+
+  Expression m_expression;
+  std::array<std::uint64_t const*, max_dependencies> m_dependencies{};
+  std::size_t m_size{};
+  mutable std::array<std::uint64_t, max_dependencies> m_versions{};
+  mutable std::optional<result_type> m_result;
+
+  /// @brief Collects the versions of the variables in the expression.
+  constexpr void collect_dependencies() noexcept
+  {
+    m_size = 0;
+    m_expression.visit([this](auto const& node, std::size_t) {
+      if constexpr (detail::is_variable_v<std::remove_cvref_t<decltype(node)>>)
+      {
+        if (m_size < max_dependencies)
+        {
+          m_dependencies[m_size++] = &node.version();
+        }
+      }
+    });
+  }
+
+  /// @brief Checks if any variable in the expression has been modified.
+  [[nodiscard]] constexpr bool is_stale() const noexcept
+  {
+    if constexpr (is_opaque)
+    {
+      // variables of opaque nodes are not visible, so modifications to them cannot be detected
+      return true;
+    }
+    for (std::size_t i = 0; i < m_size; ++i)
+    {
+      if (*m_dependencies[i] != m_versions[i])
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+public:
+  /**
+   * @brief Constructs a cached_expression.
+   * @tparam E Type of the expression.
+   * @param e Expression to cache.
+   */
+  template<typename E>
+  constexpr explicit cached_expression(E&& e) : m_expression(std::forward<E>(e))
+  {
+    // variables are neither copyable nor movable, therefore expressions refer to them and the
+    // dependencies remain valid when the cached_expression is copied
+    collect_dependencies();
+  }
+
+  /// @brief Discards the stored result, so that the next evaluation re-evaluates the expression.
+  constexpr void invalidate() const noexcept
+  {
+    m_result.reset();
+  }
+
+  /// @brief Checks if there is a stored result that is up to date.
+  [[nodiscard]] constexpr bool is_cached() const noexcept
+  {
+    return m_result.has_value() && !is_stale();
+  }
+
+  /**
+   * @brief Evaluates the cached expression.
+   *
+   * The expression is evaluated only if there is no stored result, a variable in the
+   * expression has been modified since it was stored, or the expression has opaque nodes.
+   *
+   * @return Reference to the stored result, which is valid until the next evaluation that
+   * re-evaluates the expression.
+   */
+  [[nodiscard]] constexpr result_type const& operator()() const
+  {
+    if (!is_cached())
+    {
+      m_result.reset();
+      // versions are recorded before evaluation, so that modifications during evaluation are
+      // detected on the next one
+      for (std::size_t i = 0; i < m_size; ++i)
+      {
+        m_versions[i] = *m_dependencies[i];
+      }
+      m_result.emplace(evaluate(m_expression));
+    }
+    return *m_result;
+  }
+
+  /**
+   * @brief Visits the cached expression with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    m_expression.visit(std::forward<Visitor>(v), nesting + 1);
+  }
+};
+
+/// @brief Specialization for @ref cached_expression, which stores its result.
+template<typename Expression>
+struct is_stateful_expression<cached_expression<Expression>> : public std::true_type
+{ };
+
+/**
+ * @brief Creates a new @ref cached_expression that stores the result of @p expr and re-evaluates
+ * it only when a @ref variable_ in it is modified.
+ *
+ * Example:
+ * @code
+ * auto x  = variable<std::vector<double>>();
+ * auto ex = cached_(invoke(sort, x));
+ * ex(); // sorts
+ * ex(); // returns the stored result
+ * x = load();
+ * ex(); // sorts again
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to cache.
+ * @return A @ref cached_expression for @p expr.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr auto cached_(Expression&& expr)
+{
+  return cached_expression<make_deferred_t<Expression>>(std::forward<Expression>(expr));
+}
+
+} // namespace deferred
+
+#endif
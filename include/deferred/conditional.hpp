@@ -9,6 +9,7 @@
 #include <type_traits>
 #include <utility>
 
+#include "detail/flat_tuple.hpp"
 #include "detail/map_result.hpp"
 #include "evaluate.hpp"
 #include "expression.hpp"
@@ -20,10 +21,105 @@ namespace detail {
 
 /**
  * @brief Tag for conditional expressions without an @c else branch.
+ *
+ * Conditional expressions that are created by @c else_if store their branches in a
+ * @ref flat_tuple_append chain @p Storage, so that each @c else_if does not copy the previous
+ * branches one by one; the chain is converted to a @ref flat_tuple by @c else_. They also carry the
+ * unique result types of their branches in @p Results, so that each @c else_if does not deduce the
+ * result type from all the branches. Otherwise, @p Storage and @p Results are @c void and branches
+ * are stored in a @ref flat_tuple.
+ *
+ * @tparam Storage Type of the storage of the branches, or @c void.
+ * @tparam Results @c std::tuple of the unique result types of the branches, or @c void.
  */
+template<typename Storage = void, typename Results = void>
 struct no_else
 { };
 
+/// @brief Checks if @p T is @ref no_else.
+template<typename T>
+inline constexpr bool is_no_else_v = false;
+
+/// @brief Specialization for @ref no_else.
+template<typename Storage, typename Results>
+inline constexpr bool is_no_else_v<no_else<Storage, Results>> = true;
+
+/// @brief Type of the storage of the branches of a conditional expression.
+template<typename Else, typename... Branches>
+struct conditional_storage
+{
+  using type = flat_tuple<Branches...>;
+};
+
+/// @brief Specialization for conditional expressions created by @c else_if.
+template<typename Storage, typename Results, typename... Branches>
+  requires(!std::is_void_v<Storage>)
+struct conditional_storage<no_else<Storage, Results>, Branches...>
+{
+  using type = Storage;
+};
+
+/// @brief Result type of the @c then expression of @p Branch, mapping @c void to @c std::monostate.
+template<typename Branch>
+using branch_result_t = map_void_t<decltype(std::declval<typename Branch::then_type>()())>;
+
+/**
+ * @brief Unique result types of the @c if and @c else_if branches of a conditional expression, in
+ * the order of @ref homogenized_type.
+ */
+template<typename Else, typename... Branches>
+struct conditional_results
+{
+  using type = typename unique_list<branch_result_t<Branches>...>::type;
+};
+
+/// @brief Specialization for conditional expressions created by @c else_if.
+template<typename Storage, typename Results, typename... Branches>
+  requires(!std::is_void_v<Results>)
+struct conditional_results<no_else<Storage, Results>, Branches...>
+{
+  using type = Results;
+};
+
+/**
+ * @brief Appends @p T to the unique types @p Results, or moves it last if it is one of them, which
+ * keeps the last occurrence of each type as @ref unique_list does.
+ */
+template<typename Results, typename T>
+struct push_back_result;
+
+/// @brief Specialization for @c std::tuple.
+template<typename... Ts, typename T>
+struct push_back_result<std::tuple<Ts...>, T>
+{
+  using type = decltype(std::tuple_cat(
+    std::declval<std::conditional_t<std::is_same_v<Ts, T>, std::tuple<>, std::tuple<Ts>>>()...,
+    std::declval<std::tuple<T>>()));
+};
+
+/// @brief Homogenized type of the types of the @c std::tuple @p Results.
+template<typename Results>
+struct homogenized_results;
+
+/// @brief Specialization for @c std::tuple.
+template<typename... Ts>
+struct homogenized_results<std::tuple<Ts...>>
+{
+  using type = homogenized_type_t<Ts...>;
+};
+
+/**
+ * @brief Evaluates @p e and maps its result to @p Result.
+ *
+ * It is instantiated once per expression type, instead of once per branch of a conditional
+ * expression.
+ */
+template<typename Result, typename Expression>
+constexpr decltype(auto) evaluate_as(Expression& e)
+{
+  return map_result<Result>([&] { return evaluate(e); });
+}
+
 /**
  * @brief Deduces the base result type of a conditional expression.
  */
@@ -37,10 +133,11 @@ struct conditional_base_result_deducer
 /**
  * @brief Specialization for non-finalized conditional expressions.
  */
-template<typename... Branches>
-struct conditional_base_result_deducer<no_else, Branches...>
+template<typename Storage, typename Results, typename... Branches>
+struct conditional_base_result_deducer<no_else<Storage, Results>, Branches...>
 {
-  using type = homogenized_type_t<decltype(std::declval<typename Branches::then_type>()())...>;
+  using type = typename homogenized_results<
+    typename conditional_results<no_else<Storage, Results>, Branches...>::type>::type;
 };
 
 } // namespace detail
@@ -68,12 +165,14 @@ struct conditional_branch
 template<typename Else, typename... Branches>
 class conditional_expression
 {
-  constexpr static inline bool finalized = !std::is_same_v<Else, detail::no_else>;
-
 public:
-  using branches_tuple = std::tuple<Branches...>;
+  /// @brief @c true if the conditional expression has an @c else branch.
+  constexpr static inline bool finalized = !detail::is_no_else_v<Else>;
+
+  /// @brief Type of the storage of the @c if and @c else_if branches.
+  using branches_storage = typename detail::conditional_storage<Else, Branches...>::type;
   using subexpression_types =
-    std::conditional_t<finalized, std::tuple<Branches..., Else>, branches_tuple>;
+    std::conditional_t<finalized, std::tuple<Branches..., Else>, std::tuple<Branches...>>;
 
   /**
    * @brief Result type of the underlying expressions (common type or variant).
@@ -90,28 +189,25 @@ public:
     std::conditional_t<std::is_void_v<base_result_type>, void, std::optional<base_result_type>>>;
 
 private:
-  [[no_unique_address]] branches_tuple m_branches;
+  [[no_unique_address]] branches_storage m_branches;
   [[no_unique_address]] Else m_else;
 
-  template<std::size_t I = 0, typename Self>
-  static constexpr result_type evaluate_impl(Self&& self)
+  /// @brief Evaluates the @p I-th branch; index @c sizeof...(Branches) is the @c else branch.
+  template<std::size_t I, typename Self>
+  static constexpr result_type evaluate_branch(Self& self)
   {
     if constexpr (I < sizeof...(Branches))
     {
-      auto&& branch = std::get<I>(self.m_branches);
-      if (evaluate(branch.condition))
+      auto&& branch = detail::get<I>(self.m_branches);
+      if constexpr (std::is_void_v<result_type>)
       {
-        if constexpr (std::is_void_v<result_type>)
-        {
-          evaluate(branch.then);
-          return;
-        }
-        else
-        {
-          return detail::map_result<base_result_type>([&] { return evaluate(branch.then); });
-        }
+        evaluate(branch.then);
+        return;
+      }
+      else
+      {
+        return detail::evaluate_as<base_result_type>(branch.then);
       }
-      return evaluate_impl<I + 1>(std::forward<Self>(self));
     }
     else
     {
@@ -124,29 +220,71 @@ private:
       }
       else
       {
-        return detail::map_result<result_type>([&] { return evaluate(self.m_else); });
+        return detail::evaluate_as<result_type>(self.m_else);
+      }
+    }
+  }
+
+  /**
+   * @brief Evaluates the branch @p index, which is in <tt>[Begin, End)</tt>.
+   *
+   * The branch is found with a binary search, so that the depth of instantiations is logarithmic
+   * in the number of branches.
+   */
+  template<std::size_t Begin, std::size_t End, typename Self>
+  static constexpr result_type evaluate_branch(Self& self, std::size_t index)
+  {
+    if constexpr (End - Begin == 1)
+    {
+      return evaluate_branch<Begin>(self);
+    }
+    else
+    {
+      constexpr std::size_t middle = Begin + (End - Begin) / 2;
+      if (index < middle)
+      {
+        return evaluate_branch<Begin, middle>(self, index);
       }
+      return evaluate_branch<middle, End>(self, index);
     }
   }
 
+  template<typename Self>
+  static constexpr result_type evaluate_impl(Self& self)
+  {
+    // conditions are evaluated in order until one is true
+    auto const index = detail::flat_apply(
+      [](auto&... branch) {
+        std::size_t index = 0;
+        static_cast<void>(
+          ((static_cast<bool>(evaluate(branch.condition)) || (++index, false)) || ...));
+        return index;
+      },
+      self.m_branches);
+    return evaluate_branch<0, sizeof...(Branches) + 1>(self, index);
+  }
+
 public:
   /**
    * @brief Constructs a non-finalized conditional expression.
-   * @param branches Tuple of branches.
+   * @param branches Storage of the branches.
    */
-  constexpr explicit conditional_expression(branches_tuple&& branches)
+  constexpr explicit conditional_expression(branches_storage&& branches)
     requires(!finalized)
     : m_branches(std::move(branches)), m_else{}
   { }
 
   /**
    * @brief Constructs a finalized conditional expression.
-   * @param branches Tuple of branches.
+   * @tparam Storage Type of the storage of the branches.
+   * @param branches Storage of the branches, which is converted to a @ref detail::flat_tuple.
    * @param else_branch Else expression.
    */
-  constexpr explicit conditional_expression(branches_tuple&& branches, Else&& else_branch)
-    requires finalized
-    : m_branches(std::move(branches)), m_else(std::forward<Else>(else_branch))
+  template<typename Storage>
+  constexpr explicit conditional_expression(Storage&& branches, Else&& else_branch)
+    requires(finalized)
+    : m_branches(detail::flatten(std::forward<Storage>(branches))),
+      m_else(std::forward<Else>(else_branch))
   { }
 
   /**
@@ -164,11 +302,15 @@ public:
     using cond_type   = make_deferred_t<C>;
     using then_type   = make_deferred_t<T>;
     using branch_type = conditional_branch<cond_type, then_type>;
+    using storage     = detail::flat_tuple_append_t<branches_storage, branch_type>;
+    using results     = typename detail::push_back_result<
+      typename detail::conditional_results<Else, Branches...>::type,
+      detail::branch_result_t<branch_type>>::type;
 
-    return conditional_expression<Else, Branches..., branch_type>(
-      std::tuple_cat(std::move(m_branches),
-                     std::tuple<branch_type>{branch_type{cond_type(std::forward<C>(condition)),
-                                                         then_type(std::forward<T>(then_))}}));
+    return conditional_expression<detail::no_else<storage, results>, Branches..., branch_type>(
+      storage{std::move(m_branches),
+              branch_type{cond_type(std::forward<C>(condition)),
+                          then_type(std::forward<T>(then_))}});
   }
 
   /// @copydoc else_if
@@ -179,11 +321,15 @@ public:
     using cond_type   = make_deferred_t<C>;
     using then_type   = make_deferred_t<T>;
     using branch_type = conditional_branch<cond_type, then_type>;
+    using storage     = detail::flat_tuple_append_t<branches_storage, branch_type>;
+    using results     = typename detail::push_back_result<
+      typename detail::conditional_results<Else, Branches...>::type,
+      detail::branch_result_t<branch_type>>::type;
 
-    return conditional_expression<Else, Branches..., branch_type>(
-      std::tuple_cat(m_branches,
-                     std::tuple<branch_type>{branch_type{cond_type(std::forward<C>(condition)),
-                                                         then_type(std::forward<T>(then_))}}));
+    return conditional_expression<detail::no_else<storage, results>, Branches..., branch_type>(
+      storage{m_branches,
+              branch_type{cond_type(std::forward<C>(condition)),
+                          then_type(std::forward<T>(then_))}});
   }
 
   /**
@@ -211,6 +357,23 @@ public:
                                                           else_expr(std::forward<E>(else_branch)));
   }
 
+  /**
+   * @brief Returns the @c if and @c else_if branches.
+   *
+   * They are accessed with @ref detail::get and @ref detail::flat_apply.
+   */
+  [[nodiscard]] constexpr branches_storage const& branches() const noexcept
+  {
+    return m_branches;
+  }
+
+  /// @brief Returns the @c else branch.
+  [[nodiscard]] constexpr Else const& else_branch() const noexcept
+    requires finalized
+  {
+    return m_else;
+  }
+
   /**
    * @brief Evaluates the conditional expression.
    * @return Result of the conditional expression.
@@ -236,7 +399,7 @@ public:
   constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
   {
     std::forward<Visitor>(v)(*this, nesting);
-    std::apply(
+    detail::flat_apply(
       [&](auto const&... branch) {
         ((branch.condition.visit(std::forward<Visitor>(v), nesting + 1),
           branch.then.visit(std::forward<Visitor>(v), nesting + 1)),
@@ -272,9 +435,10 @@ template<typename Condition, typename Then>
   using cond_type   = make_deferred_t<Condition>;
   using then_type   = make_deferred_t<Then>;
   using branch_type = conditional_branch<cond_type, then_type>;
-  return conditional_expression<detail::no_else, branch_type>(
-    std::tuple<branch_type>{branch_type{cond_type(std::forward<Condition>(condition)),
-                                        then_type(std::forward<Then>(then_))}});
+  return conditional_expression<detail::no_else<>, branch_type>(
+    detail::flat_tuple<branch_type>(std::in_place,
+                                    branch_type{cond_type(std::forward<Condition>(condition)),
+                                                then_type(std::forward<Then>(then_))}));
 }
 
 } // namespace deferred
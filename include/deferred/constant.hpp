@@ -66,6 +66,18 @@ public:
   }
 };
 
+namespace detail {
+
+/// @brief Checks if @p T is a @ref constant_.
+template<typename T>
+inline constexpr bool is_constant_v = false;
+
+/// @brief Specialization for @ref constant_.
+template<typename T>
+inline constexpr bool is_constant_v<constant_<T>> = true;
+
+} // namespace detail
+
 /**
  * @brief Creates a constant for use in @c deferred expressions.
  *
@@ -83,6 +95,22 @@ template<typename T>
   return constant_<result_type>(recursive_evaluate(std::forward<T>(t)));
 }
 
+/**
+ * @brief Constant whose value @p V is part of its type.
+ *
+ * Its value is known when expressions are transformed, e.g., by @ref simplify.
+ *
+ * Example:
+ * @code
+ * auto ex = x * constant_c<1>; // simplify(ex) returns x
+ * @endcode
+ *
+ * @tparam V Value of the constant.
+ */
+template<auto V>
+inline constexpr constant_<std::integral_constant<decltype(V), V>> constant_c{
+  std::integral_constant<decltype(V), V>{}};
+
 } // namespace deferred
 
 #endif
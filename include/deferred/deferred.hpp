@@ -4,14 +4,35 @@
 #ifndef DEFERRED_DEFERRED_HPP
 #define DEFERRED_DEFERRED_HPP
 
+#include "adaptive.hpp"
+#include "any_expression.hpp"
 #include "apply.hpp"
+#include "async.hpp"
+#include "cached.hpp"
 #include "conditional.hpp"
 #include "constant.hpp"
+#include "dynamic_switch.hpp"
+#include "elementwise.hpp"
 #include "expression.hpp"
+#include "fold.hpp"
 #include "invoke.hpp"
+#include "logical.hpp"
+#include "nary.hpp"
 #include "operators.hpp"
+#include "parallel.hpp"
+#include "profile.hpp"
+#include "runtime_graph.hpp"
+#include "shared.hpp"
+#include "simplify.hpp"
+#include "speculative.hpp"
 #include "switch.hpp"
+#include "tape.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include "transform.hpp"
 #include "type_traits/is_constant_expression.hpp"
+#include "type_traits/is_pure_expression.hpp"
 #include "variable.hpp"
 #include "while.hpp"
 
@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_DETAIL_FLAT_CASE_MAP_HPP
+#define DEFERRED_DETAIL_FLAT_CASE_MAP_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace deferred::detail {
+
+/**
+ * @brief Open-addressing hash map from labels of type @p Label to bodies of type @p Body.
+ *
+ * Labels and bodies are stored contiguously in insertion order, while a separate power-of-two
+ * table of slots indexes them with linear probing. Insertion appends to the contiguous storage and
+ * only rebuilds the slots when the load factor exceeds @f$1/2@f$, so it is amortized @f$O(1)@f$
+ * and existing labels and bodies are never rehashed or moved because of the index.
+ *
+ * Labels of type @c std::string are looked up with @c std::string_view.
+ *
+ * @tparam Label Type of the labels.
+ * @tparam Body Type of the bodies.
+ */
+template<typename Label, typename Body>
+class flat_case_map
+{
+public:
+  using label_type = Label;
+  using body_type  = Body;
+  using key_type =
+    std::conditional_t<std::is_same_v<Label, std::string>, std::string_view, Label>;
+
+private:
+  static constexpr std::size_t empty_slot = 0;
+
+  std::vector<Label> m_labels;
+  std::vector<Body> m_bodies;
+  std::vector<std::size_t> m_hashes;
+  /// Indices to @ref m_labels and @ref m_bodies plus one, or @ref empty_slot.
+  std::vector<std::size_t> m_slots;
+
+  [[nodiscard]] static std::size_t hash(key_type const& key)
+  {
+    // std::hash may be the identity for integers, so the bits are mixed before masking
+    auto h = static_cast<std::uint64_t>(std::hash<key_type>{}(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+  }
+
+  /// @brief Returns the slot that contains @p key or the empty slot where it would be inserted.
+  [[nodiscard]] std::size_t find_slot(key_type const& key, std::size_t h) const
+  {
+    auto const mask = m_slots.size() - 1;
+    for (auto s = h & mask;; s = (s + 1) & mask)
+    {
+      auto const i = m_slots[s];
+      if (i == empty_slot || (m_hashes[i - 1] == h && key_type(m_labels[i - 1]) == key))
+      {
+        return s;
+      }
+    }
+  }
+
+  void rehash(std::size_t slots)
+  {
+    m_slots.assign(slots, empty_slot);
+    auto const mask = slots - 1;
+    for (std::size_t i = 0; i < m_labels.size(); ++i)
+    {
+      auto s = m_hashes[i] & mask;
+      while (m_slots[s] != empty_slot)
+      {
+        s = (s + 1) & mask;
+      }
+      m_slots[s] = i + 1;
+    }
+  }
+
+public:
+  /// @brief Returns the number of cases.
+  [[nodiscard]] std::size_t size() const noexcept
+  {
+    return m_labels.size();
+  }
+
+  /// @brief Checks if there are no cases.
+  [[nodiscard]] bool empty() const noexcept
+  {
+    return m_labels.empty();
+  }
+
+  /// @brief Returns the labels in insertion order.
+  [[nodiscard]] std::span<Label const> labels() const noexcept
+  {
+    return m_labels;
+  }
+
+  /// @brief Returns the bodies in insertion order.
+  [[nodiscard]] std::span<Body const> bodies() const noexcept
+  {
+    return m_bodies;
+  }
+
+  /**
+   * @brief Reserves space for @p n cases.
+   * @param n Number of cases.
+   */
+  void reserve(std::size_t n)
+  {
+    m_labels.reserve(n);
+    m_bodies.reserve(n);
+    m_hashes.reserve(n);
+    if (2 * n > m_slots.size())
+    {
+      rehash(std::bit_ceil(2 * n));
+    }
+  }
+
+  /**
+   * @brief Inserts a case with label @p label and body @p body.
+   *
+   * If a case with an equal label exists, it is kept and the new one is discarded.
+   *
+   * @tparam L Type of the label.
+   * @tparam B Type of the body.
+   * @param label Label of the case.
+   * @param body Body of the case.
+   * @return @c true if the case was inserted, @c false otherwise.
+   */
+  template<typename L, typename B>
+  bool insert(L&& label, B&& body)
+  {
+    if (2 * (m_labels.size() + 1) > m_slots.size())
+    {
+      rehash(std::max<std::size_t>(16, 2 * m_slots.size()));
+    }
+
+    auto l       = Label(std::forward<L>(label));
+    auto const h = hash(key_type(l));
+    auto const s = find_slot(key_type(l), h);
+    if (m_slots[s] != empty_slot)
+    {
+      return false;
+    }
+    m_hashes.push_back(h);
+    try
+    {
+      m_labels.push_back(std::move(l));
+      try
+      {
+        m_bodies.emplace_back(std::forward<B>(body));
+      }
+      catch (...)
+      {
+        m_labels.pop_back();
+        throw;
+      }
+    }
+    catch (...)
+    {
+      m_hashes.pop_back();
+      throw;
+    }
+    m_slots[s] = m_labels.size();
+    return true;
+  }
+
+  /**
+   * @brief Returns the body of the case with label @p key or @c nullptr if there is none.
+   * @param key Key to search for.
+   */
+  [[nodiscard]] Body const* find(key_type const& key) const
+  {
+    if (m_slots.empty())
+    {
+      return nullptr;
+    }
+    auto const i = m_slots[find_slot(key, hash(key))];
+    return i == empty_slot ? nullptr : &m_bodies[i - 1];
+  }
+};
+
+} // namespace deferred::detail
+
+#endif
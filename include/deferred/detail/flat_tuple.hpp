@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_FLAT_TUPLE_HPP
+#define DEFERRED_FLAT_TUPLE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace deferred::detail {
+
+/**
+ * @brief Element @p I of a @ref flat_tuple.
+ * @tparam I Index of the element.
+ * @tparam T Type of the element.
+ */
+template<std::size_t I, typename T>
+struct flat_tuple_leaf
+{
+  [[no_unique_address]] T value;
+};
+
+template<typename Indices, typename... Ts>
+class flat_tuple_impl;
+
+/**
+ * @brief Tuple whose elements are direct bases.
+ *
+ * Unlike a recursive @c std::tuple, constructing it and accessing its elements with @ref get does
+ * not instantiate a template per element, which keeps the compilation time of switches and
+ * conditionals with many cases linear in the number of cases.
+ *
+ * @tparam I Indices of the elements.
+ * @tparam Ts Types of the elements.
+ */
+template<std::size_t... I, typename... Ts>
+class flat_tuple_impl<std::index_sequence<I...>, Ts...> : public flat_tuple_leaf<I, Ts>...
+{
+public:
+  static constexpr std::size_t size = sizeof...(Ts);
+  /// @brief Type of the @ref flat_tuple with the same elements.
+  using flat_type = flat_tuple_impl;
+
+  /**
+   * @brief Constructs a flat_tuple_impl.
+   * @tparam Us Types of the arguments.
+   * @param us Arguments to initialize the elements with.
+   */
+  template<typename... Us>
+  constexpr explicit flat_tuple_impl(std::in_place_t, Us&&... us) :
+    flat_tuple_leaf<I, Ts>{std::forward<Us>(us)}...
+  { }
+};
+
+/**
+ * @brief Alias for the @ref flat_tuple_impl of @p Ts....
+ * @tparam Ts Types of the elements.
+ */
+template<typename... Ts>
+using flat_tuple = flat_tuple_impl<std::index_sequence_for<Ts...>, Ts...>;
+
+/// @brief Type of the @ref flat_tuple with the elements of the @ref flat_tuple @p Tuple and @p T.
+template<typename Tuple, typename T>
+struct flat_tuple_push_back;
+
+/// @brief Specialization for @ref flat_tuple.
+template<std::size_t... I, typename... Ts, typename T>
+struct flat_tuple_push_back<flat_tuple_impl<std::index_sequence<I...>, Ts...>, T>
+{
+  using type = flat_tuple_impl<std::index_sequence<I..., sizeof...(Ts)>, Ts..., T>;
+};
+
+/**
+ * @brief Tuple of the elements of @p Tuple followed by elements of types @p Ts in reverse order.
+ *
+ * The elements of @p Tuple are moved or copied as a whole, therefore appending an element does not
+ * instantiate a template per element of @p Tuple. Appending elements one at a time with
+ * @ref flat_tuple_append_t creates a chain of flat_tuple_append, which can be converted to a
+ * @ref flat_tuple with @ref flatten.
+ *
+ * The appended types are a pack instead of nested flat_tuple_append types, because compilers mangle
+ * the names of nested types in time quadratic in the nesting depth.
+ *
+ * It is an aggregate that is initialized with the previous link of the chain and the element, so
+ * that appending an element does not instantiate a constructor for each link of the chain.
+ *
+ * @tparam Tuple Type of the @ref flat_tuple at the start of the chain.
+ * @tparam Ts Types of the appended elements, last one first.
+ */
+template<typename Tuple, typename... Ts>
+struct flat_tuple_append;
+
+/// @brief Specialization for the first appended element.
+template<typename Tuple, typename T>
+struct flat_tuple_append<Tuple, T> : public Tuple, public flat_tuple_leaf<Tuple::size, T>
+{
+  static constexpr std::size_t size = Tuple::size + 1;
+  /// @brief Type of the @ref flat_tuple with the same elements, which is not instantiated.
+  using flat_type = typename flat_tuple_push_back<typename Tuple::flat_type, T>::type;
+};
+
+/// @brief Specialization for the elements that are appended to a flat_tuple_append.
+template<typename Tuple, typename T, typename U, typename... Ts>
+struct flat_tuple_append<Tuple, T, U, Ts...> :
+  public flat_tuple_append<Tuple, U, Ts...>,
+  public flat_tuple_leaf<Tuple::size + sizeof...(Ts) + 1, T>
+{
+  static constexpr std::size_t size = Tuple::size + sizeof...(Ts) + 2;
+  /// @brief Type of the @ref flat_tuple with the same elements, which is not instantiated.
+  using flat_type =
+    typename flat_tuple_push_back<typename flat_tuple_append<Tuple, U, Ts...>::flat_type, T>::type;
+};
+
+/// @brief Type of the @ref flat_tuple_append of @p Tuple and an element of type @p T.
+template<typename Tuple, typename T>
+struct flat_tuple_append_type
+{
+  using type = flat_tuple_append<Tuple, T>;
+};
+
+/// @brief Specialization for @ref flat_tuple_append.
+template<typename Tuple, typename... Ts, typename T>
+struct flat_tuple_append_type<flat_tuple_append<Tuple, Ts...>, T>
+{
+  using type = flat_tuple_append<Tuple, T, Ts...>;
+};
+
+/// @brief Alias for the type of the @ref flat_tuple_append of @p Tuple and an element of type @p T.
+template<typename Tuple, typename T>
+using flat_tuple_append_t = typename flat_tuple_append_type<Tuple, T>::type;
+
+/// @brief Reference to @p T with the constness and value category of the reference @p From.
+template<typename From, typename T>
+using like_t = std::conditional_t<
+  std::is_lvalue_reference_v<From>,
+  std::conditional_t<std::is_const_v<std::remove_reference_t<From>>, T const&, T&>,
+  std::conditional_t<std::is_const_v<std::remove_reference_t<From>>, T const&&, T&&>>;
+
+/// @brief Deduces the type of element @p I; it is only used in unevaluated contexts.
+template<std::size_t I, typename T>
+auto element_type(flat_tuple_leaf<I, T> const*) -> T;
+
+/**
+ * @brief Type of element @p I of a @ref flat_tuple or @ref flat_tuple_append @p Tuple.
+ *
+ * It is deduced from the bases of the @ref flat_tuple with the same elements, instead of the
+ * bases of @p Tuple, which are nested @p Tuple::size deep for a @ref flat_tuple_append chain.
+ */
+template<std::size_t I, typename Tuple>
+using flat_tuple_element_t =
+  decltype(detail::element_type<I>(static_cast<typename Tuple::flat_type const*>(nullptr)));
+
+/**
+ * @brief Returns element @p I of a @ref flat_tuple or @ref flat_tuple_append.
+ *
+ * The element is accessed with a cast to its base, because deducing the base in overload
+ * resolution is much slower for the nested bases of a @ref flat_tuple_append chain.
+ */
+template<std::size_t I, typename Tuple>
+[[nodiscard]] constexpr decltype(auto) get(Tuple&& t) noexcept
+{
+  using leaf = flat_tuple_leaf<I, flat_tuple_element_t<I, std::remove_cvref_t<Tuple>>>;
+  return (static_cast<like_t<Tuple&&, leaf>>(t).value);
+}
+
+/// @brief Invokes @p f with the elements of the @ref flat_tuple or @ref flat_tuple_append @p t.
+template<typename F, typename Tuple>
+constexpr decltype(auto) flat_apply(F&& f, Tuple&& t)
+{
+  using flat_type = typename std::remove_cvref_t<Tuple>::flat_type;
+  // elements are accessed without a function per element, whose names would contain Tuple
+  return [&]<std::size_t... I, typename... Ts>(
+           flat_tuple_impl<std::index_sequence<I...>, Ts...> const*) -> decltype(auto) {
+    return std::forward<F>(f)(static_cast<like_t<Tuple&&, flat_tuple_leaf<I, Ts>>>(t).value...);
+  }(static_cast<flat_type const*>(nullptr));
+}
+
+/**
+ * @brief Moves or copies the elements of the @ref flat_tuple or @ref flat_tuple_append @p t to a
+ * @ref flat_tuple.
+ */
+template<typename Tuple>
+[[nodiscard]] constexpr auto flatten(Tuple&& t)
+{
+  using flat_type = typename std::remove_cvref_t<Tuple>::flat_type;
+  if constexpr (std::is_same_v<std::remove_cvref_t<Tuple>, flat_type>)
+  {
+    return flat_type(std::forward<Tuple>(t));
+  }
+  else
+  {
+    return flat_apply(
+      []<typename... Us>(Us&&... us) { return flat_type(std::in_place, std::forward<Us>(us)...); },
+      std::forward<Tuple>(t));
+  }
+}
+
+} // namespace deferred::detail
+
+#endif
@@ -4,7 +4,6 @@
 #ifndef DEFERRED_MAP_RESULT_HPP
 #define DEFERRED_MAP_RESULT_HPP
 
-#include <functional>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -23,16 +22,16 @@ constexpr decltype(auto) map_result(F&& f)
 {
   if constexpr (std::is_void_v<Result>)
   {
-    static_cast<void>(std::invoke(std::forward<F>(f)));
+    static_cast<void>(std::forward<F>(f)());
   }
   else if constexpr (std::is_void_v<std::invoke_result_t<F>>)
   {
-    std::invoke(std::forward<F>(f));
+    std::forward<F>(f)();
     return std::monostate{};
   }
   else
   {
-    return std::invoke(std::forward<F>(f));
+    return std::forward<F>(f)();
   }
 }
 
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_DETAIL_NODE_LABEL_HPP
+#define DEFERRED_DETAIL_NODE_LABEL_HPP
+
+#include <string_view>
+
+#include "../conditional.hpp"
+#include "../expression.hpp"
+#include "../logical.hpp"
+#include "../switch.hpp"
+#include "../type_name.hpp"
+#include "../while.hpp"
+
+namespace deferred::detail {
+
+/**
+ * @brief Short name of the node @p Node that does not depend on its subexpressions.
+ *
+ * Operations are named after their operator and control flow nodes after the function that
+ * creates them; other nodes are named after their type.
+ */
+template<typename Node>
+inline constexpr std::string_view node_label_v = type_name<Node>();
+
+/// @brief Specialization for @ref expression_.
+template<typename Operator, typename... Expressions>
+inline constexpr std::string_view node_label_v<expression_<Operator, Expressions...>> =
+  type_name<Operator>();
+
+/// @brief Specialization for @ref logical_expression.
+template<typename Operator, typename... Expressions>
+inline constexpr std::string_view node_label_v<logical_expression<Operator, Expressions...>> =
+  type_name<Operator>();
+
+/// @brief Specialization for @ref conditional_expression.
+template<typename Else, typename... Branches>
+inline constexpr std::string_view node_label_v<conditional_expression<Else, Branches...>> = "if_";
+
+/// @brief Specialization for @ref switch_expression.
+template<typename Condition, typename Default, typename... Cases>
+inline constexpr std::string_view node_label_v<switch_expression<Condition, Default, Cases...>> =
+  "switch_";
+
+/// @brief Specialization for @ref while_expression.
+template<typename Condition, typename Body>
+inline constexpr std::string_view node_label_v<while_expression<Condition, Body>> = "while_";
+
+} // namespace deferred::detail
+
+#endif
@@ -0,0 +1,463 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_DETAIL_SWITCH_TABLE_HPP
+#define DEFERRED_DETAIL_SWITCH_TABLE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "../constant.hpp"
+
+namespace deferred::detail {
+
+/**
+ * @brief Promoted integral type that values of @p T are compared as.
+ *
+ * The type is @c void if @p T is not an integral or enumeration type.
+ */
+template<typename T>
+struct switch_key_deducer
+{
+  using type = void;
+};
+
+/// @brief Specialization for integral types.
+template<std::integral T>
+struct switch_key_deducer<T>
+{
+  using type = decltype(+std::declval<T>());
+};
+
+/// @brief Specialization for enumeration types.
+template<typename T>
+  requires std::is_enum_v<T>
+struct switch_key_deducer<T>
+{
+  using type = decltype(+std::declval<std::underlying_type_t<T>>());
+};
+
+/**
+ * @brief Returns the value type of label expression @p Label if it is a @ref constant_, otherwise
+ * @c void.
+ */
+template<typename Label>
+struct switch_label_value
+{
+  using type = void;
+};
+
+/// @brief Specialization for @ref constant_.
+template<typename T>
+struct switch_label_value<constant_<T>>
+{
+  using type = T;
+};
+
+/**
+ * @brief Wrapper of @p T to compute the common type of a list of types with a fold expression.
+ *
+ * @c std::common_type_t instantiates itself recursively for each type; folding binary common
+ * types does not, so that switches with many cases do not exceed the instantiation depth.
+ */
+template<typename T>
+struct common_type_fold
+{
+  using type = T;
+
+  template<typename U>
+  auto operator+(common_type_fold<U>) const -> common_type_fold<std::common_type_t<T, U>>;
+};
+
+/**
+ * @brief Deduces the key type of a @ref switch_table for a condition of type @p Condition and
+ * label expressions @p Labels....
+ *
+ * A table can be used if all labels are @ref constant_ and either the condition and the labels
+ * are integral, or they are all the same enumeration type. Integral keys are the common type of
+ * the promoted condition and labels, so that comparisons are the same as @c operator==. If a
+ * table cannot be used, the type is @c void.
+ */
+template<typename Condition, typename... Labels>
+struct switch_table_key_deducer
+{
+  template<typename T>
+  using label_value_t = typename switch_label_value<std::remove_cvref_t<T>>::type;
+
+  static consteval auto deduce()
+  {
+    if constexpr (sizeof...(Labels) == 0)
+    {
+      return std::type_identity<void>{};
+    }
+    else if constexpr (std::is_enum_v<Condition>)
+    {
+      if constexpr ((std::is_same_v<label_value_t<Labels>, Condition> && ...))
+      {
+        return std::type_identity<typename switch_key_deducer<Condition>::type>{};
+      }
+      else
+      {
+        return std::type_identity<void>{};
+      }
+    }
+    else if constexpr (std::integral<Condition> && (std::integral<label_value_t<Labels>> && ...))
+    {
+      using common_type =
+        decltype((common_type_fold<typename switch_key_deducer<Condition>::type>{} + ...
+                  + common_type_fold<typename switch_key_deducer<label_value_t<Labels>>::type>{}));
+      return std::type_identity<typename common_type::type>{};
+    }
+    else
+    {
+      return std::type_identity<void>{};
+    }
+  }
+
+  using type = typename decltype(deduce())::type;
+};
+
+/// @brief Alias for @ref switch_table_key_deducer::type.
+template<typename Condition, typename... Labels>
+using switch_table_key_t = typename switch_table_key_deducer<Condition, Labels...>::type;
+
+/**
+ * @brief Smallest unsigned type that can store the indices of @p N cases and the default case.
+ */
+template<std::size_t N>
+using switch_index_t = std::conditional_t<
+  (N < std::numeric_limits<std::uint8_t>::max()),
+  std::uint8_t,
+  std::conditional_t<(N < std::numeric_limits<std::uint16_t>::max()), std::uint16_t, std::size_t>>;
+
+/**
+ * @brief Lookup table from the labels of a switch to the indices of its cases.
+ *
+ * Labels are sorted once at construction. If they span at most @f$2N@f$ values, a dense table
+ * indexed by the key is used, otherwise a binary search over the sorted labels. For duplicate
+ * labels, the first case is kept. Indices start from @c 1, as @c 0 denotes the default case.
+ *
+ * @tparam Key Type of the keys.
+ * @tparam N Number of labels.
+ */
+template<typename Key, std::size_t N>
+class switch_table
+{
+  static_assert(std::is_integral_v<Key> && N > 0);
+
+  using unsigned_key_type = std::make_unsigned_t<Key>;
+  using index_type        = switch_index_t<N>;
+
+  struct entry
+  {
+    Key key;
+    index_type index;
+  };
+
+  std::array<entry, N> m_entries{};
+  std::array<index_type, 2 * N> m_dense{};
+  std::size_t m_size{};
+  Key m_min{};
+  bool m_is_dense{};
+
+  [[nodiscard]] constexpr unsigned_key_type offset(Key key) const noexcept
+  {
+    return static_cast<unsigned_key_type>(static_cast<unsigned_key_type>(key)
+                                          - static_cast<unsigned_key_type>(m_min));
+  }
+
+public:
+  /**
+   * @brief Constructs the table from @p labels.
+   * @param labels Labels of the cases in order.
+   */
+  constexpr explicit switch_table(std::array<Key, N> const& labels)
+  {
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      m_entries[i] = {labels[i], static_cast<index_type>(i + 1)};
+    }
+    std::sort(m_entries.begin(), m_entries.end(), [](entry const& x, entry const& y) {
+      return x.key < y.key || (x.key == y.key && x.index < y.index);
+    });
+    auto const last = std::unique(m_entries.begin(),
+                                  m_entries.end(),
+                                  [](entry const& x, entry const& y) { return x.key == y.key; });
+    m_size          = static_cast<std::size_t>(last - m_entries.begin());
+    m_min           = m_entries[0].key;
+    m_is_dense      = offset(m_entries[m_size - 1].key) < m_dense.size();
+    if (m_is_dense)
+    {
+      for (std::size_t i = 0; i < m_size; ++i)
+      {
+        m_dense[offset(m_entries[i].key)] = m_entries[i].index;
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the index of the case with label @p key, or @c 0 if there is none.
+   * @param key Key to search for.
+   */
+  [[nodiscard]] constexpr std::size_t find(Key key) const noexcept
+  {
+    if (m_is_dense)
+    {
+      auto const i = offset(key);
+      return i < m_dense.size() ? m_dense[i] : 0;
+    }
+    auto const last = m_entries.begin() + m_size;
+    auto const it   = std::lower_bound(
+      m_entries.begin(), last, key, [](entry const& e, Key k) { return e.key < k; });
+    return (it != last && it->key == key) ? it->index : 0;
+  }
+};
+
+/**
+ * @brief Checks if @p T is a string type whose values can be viewed as @c std::string_view.
+ */
+template<typename T>
+inline constexpr bool is_switch_string_v =
+  std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+/**
+ * @brief Checks if @p T is a type that can be hashed with @c std::hash and compared for equality.
+ */
+template<typename T>
+concept SwitchHashable = std::equality_comparable<T> && requires(T const& t) {
+  { std::hash<T>{}(t) } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * @brief Deduces the key type of a @ref switch_hash_table for a condition of type @p Condition and
+ * label expressions @p Labels....
+ *
+ * A hash table can be used if all labels are @ref constant_ and either the condition is
+ * @c std::string or @c std::string_view and the labels are strings or C-strings (the key is
+ * @c std::string_view), or the condition and the labels are the same hashable type (the key is
+ * that type). If a hash table cannot be used, the type is @c void.
+ */
+template<typename Condition, typename... Labels>
+struct switch_hash_key_deducer
+{
+  template<typename T>
+  using label_value_t = typename switch_label_value<std::remove_cvref_t<T>>::type;
+
+  template<typename T>
+  constexpr static inline bool is_string_label_v =
+    is_switch_string_v<T> || std::is_same_v<T, char const*> || std::is_same_v<T, char*>;
+
+  static consteval auto deduce()
+  {
+    if constexpr (sizeof...(Labels) == 0)
+    {
+      return std::type_identity<void>{};
+    }
+    else if constexpr (is_switch_string_v<Condition>)
+    {
+      if constexpr ((is_string_label_v<label_value_t<Labels>> && ...))
+      {
+        return std::type_identity<std::string_view>{};
+      }
+      else
+      {
+        return std::type_identity<void>{};
+      }
+    }
+    else if constexpr (SwitchHashable<Condition>
+                       && (std::is_same_v<label_value_t<Labels>, Condition> && ...))
+    {
+      return std::type_identity<Condition>{};
+    }
+    else
+    {
+      return std::type_identity<void>{};
+    }
+  }
+
+  using type = typename decltype(deduce())::type;
+};
+
+/// @brief Alias for @ref switch_hash_key_deducer::type.
+template<typename Condition, typename... Labels>
+using switch_hash_key_t = typename switch_hash_key_deducer<Condition, Labels...>::type;
+
+/**
+ * @brief Hashes keys of type @p Key for a @ref switch_hash_table.
+ */
+template<typename Key>
+struct switch_hash
+{
+  [[nodiscard]] std::uint64_t operator()(Key const& key) const
+  {
+    return std::hash<Key>{}(key);
+  }
+};
+
+/**
+ * @brief Specialization for @c std::string_view that uses FNV-1a, so that tables of string literals
+ * can be built at compile time.
+ */
+template<>
+struct switch_hash<std::string_view>
+{
+  [[nodiscard]] constexpr std::uint64_t operator()(std::string_view key) const noexcept
+  {
+    std::uint64_t h = 0xcbf29ce484222325;
+    for (auto c : key)
+    {
+      h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+    }
+    return h;
+  }
+};
+
+/**
+ * @brief Hash table from the labels of a switch to the indices of its cases.
+ *
+ * Labels are hashed once at construction into an open-addressing table of at least @f$2N@f$
+ * slots. Seeds are tried until no two labels share a slot, i.e., a perfect hash; if none is found,
+ * linear probing is used, bounded by the longest probe sequence of the labels. Each slot keeps the
+ * full hash of its label, so that a lookup is one hash and, in the common case, one comparison
+ * with the label of the candidate case. For duplicate labels, the first case is kept. Indices start
+ * from @c 1, as @c 0 denotes the default case.
+ *
+ * The labels themselves are not stored; the comparison with the label is done by the caller.
+ *
+ * @tparam Key Type of the keys.
+ * @tparam N Number of labels.
+ */
+template<typename Key, std::size_t N>
+class switch_hash_table
+{
+  static_assert(N > 0);
+
+  using index_type = switch_index_t<N>;
+
+  constexpr static inline std::size_t slots     = std::bit_ceil(2 * N);
+  constexpr static inline std::size_t max_seeds = 16;
+
+  std::array<std::uint64_t, slots> m_hashes{};
+  std::array<index_type, slots> m_indices{};
+  std::uint64_t m_seed{};
+  std::size_t m_max_probe{};
+
+  /// @brief Mixes @p h with @p seed and returns the home slot.
+  [[nodiscard]] static constexpr std::size_t slot(std::uint64_t h, std::uint64_t seed) noexcept
+  {
+    // finalizer of MurmurHash3
+    h ^= seed * 0x9e3779b97f4a7c15;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h & (slots - 1));
+  }
+
+  /**
+   * @brief Inserts @p labels with hashes @p hashes using @p seed.
+   * @return The longest probe sequence.
+   */
+  constexpr std::size_t insert(std::array<Key, N> const& labels,
+                               std::array<std::uint64_t, N> const& hashes,
+                               std::uint64_t seed)
+  {
+    m_hashes  = {};
+    m_indices = {};
+    m_seed    = seed;
+
+    std::size_t max_probe = 0;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      auto s            = slot(hashes[i], seed);
+      std::size_t probe = 0;
+      for (; m_indices[s] != 0; s = (s + 1) & (slots - 1), ++probe)
+      {
+        if (m_hashes[s] == hashes[i] && labels[m_indices[s] - 1] == labels[i])
+        {
+          // duplicate label
+          break;
+        }
+      }
+      if (m_indices[s] == 0)
+      {
+        m_hashes[s]  = hashes[i];
+        m_indices[s] = static_cast<index_type>(i + 1);
+        max_probe    = std::max(max_probe, probe);
+      }
+    }
+    return max_probe;
+  }
+
+public:
+  /**
+   * @brief Constructs the table from @p labels.
+   * @param labels Labels of the cases in order.
+   */
+  constexpr explicit switch_hash_table(std::array<Key, N> const& labels)
+  {
+    std::array<std::uint64_t, N> hashes{};
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      hashes[i] = switch_hash<Key>{}(labels[i]);
+    }
+
+    std::uint64_t best_seed = 0;
+    auto best_probe         = std::numeric_limits<std::size_t>::max();
+    for (std::uint64_t seed = 0; seed < max_seeds && best_probe > 0; ++seed)
+    {
+      auto const probe = insert(labels, hashes, seed);
+      if (probe < best_probe)
+      {
+        best_seed  = seed;
+        best_probe = probe;
+      }
+    }
+    if (m_seed != best_seed)
+    {
+      insert(labels, hashes, best_seed);
+    }
+    m_max_probe = best_probe;
+  }
+
+  /**
+   * @brief Returns the index of the case with label @p key, or @c 0 if there is none.
+   * @tparam IsLabel Type of the function object that compares with the label of a case.
+   * @param key Key to search for.
+   * @param is_label Function object that returns if the case with the given index has label
+   * @p key.
+   */
+  template<typename IsLabel>
+  [[nodiscard]] constexpr std::size_t find(Key const& key, IsLabel&& is_label) const
+  {
+    auto const h = switch_hash<Key>{}(key);
+    auto s       = slot(h, m_seed);
+    for (std::size_t probe = 0; probe <= m_max_probe; ++probe, s = (s + 1) & (slots - 1))
+    {
+      auto const i = m_indices[s];
+      if (i == 0)
+      {
+        break;
+      }
+      if (m_hashes[s] == h && is_label(static_cast<std::size_t>(i)))
+      {
+        return i;
+      }
+    }
+    return 0;
+  }
+};
+
+} // namespace deferred::detail
+
+#endif
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_DETAIL_TRACE_RING_HPP
+#define DEFERRED_DETAIL_TRACE_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace deferred::detail {
+
+/**
+ * @brief Fixed-capacity ring buffer of events that is written by a single thread.
+ *
+ * Pushing never blocks or allocates; when the buffer is full, the oldest events are overwritten.
+ * The events that have been pushed before the buffer is read are visible to the reader, provided
+ * that the writer does not push concurrently with reading.
+ *
+ * @tparam T Type of the events.
+ */
+template<typename T>
+class trace_ring
+{
+  std::size_t m_mask;
+  std::unique_ptr<T[]> m_events;
+  std::atomic<std::uint64_t> m_head{0};
+
+public:
+  /**
+   * @brief Constructs an empty ring buffer.
+   * @param capacity Capacity, which must be a power of two.
+   */
+  explicit trace_ring(std::size_t capacity) :
+    m_mask(capacity - 1), m_events(std::make_unique<T[]>(capacity))
+  { }
+
+  trace_ring(trace_ring const&)            = delete;
+  trace_ring& operator=(trace_ring const&) = delete;
+
+  /// @brief Returns the capacity.
+  [[nodiscard]] std::size_t capacity() const noexcept
+  {
+    return m_mask + 1;
+  }
+
+  /// @brief Appends @p t, overwriting the oldest event if the buffer is full. Owner only.
+  void push(T const& t) noexcept
+  {
+    auto const head         = m_head.load(std::memory_order_relaxed);
+    m_events[head & m_mask] = t;
+    m_head.store(head + 1, std::memory_order_release);
+  }
+
+  /// @brief Returns the number of events that have been overwritten.
+  [[nodiscard]] std::uint64_t dropped() const noexcept
+  {
+    auto const head = m_head.load(std::memory_order_acquire);
+    return head > capacity() ? head - capacity() : 0;
+  }
+
+  /// @brief Invokes @p f with the events in the buffer, from the oldest to the newest.
+  template<typename F>
+  void for_each(F&& f) const
+  {
+    auto const head = m_head.load(std::memory_order_acquire);
+    for (auto i = head > capacity() ? head - capacity() : 0; i != head; ++i)
+    {
+      f(m_events[i & m_mask]);
+    }
+  }
+};
+
+} // namespace deferred::detail
+
+#endif
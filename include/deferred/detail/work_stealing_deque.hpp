@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_DETAIL_WORK_STEALING_DEQUE_HPP
+#define DEFERRED_DETAIL_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace deferred::detail {
+
+/**
+ * @brief Chase-Lev work-stealing deque of pointers.
+ *
+ * The owner thread pushes and pops at the bottom, while other threads steal from the top. Only
+ * stealing and popping the last element synchronize with each other. The circular buffer grows
+ * when it is full; buffers that are replaced are kept until the deque is destroyed, as thieves
+ * may still read from them.
+ *
+ * See D. Chase and Y. Lev, "Dynamic Circular Work-Stealing Deque", SPAA 2005, and N. M. Lê et al.,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models", PPoPP 2013.
+ *
+ * @tparam T Type of the elements, which must be a pointer.
+ */
+template<typename T>
+  requires std::is_pointer_v<T>
+class work_stealing_deque
+{
+  class buffer
+  {
+    std::int64_t m_mask;
+    std::unique_ptr<std::atomic<T>[]> m_elements;
+
+  public:
+    explicit buffer(std::int64_t capacity) :
+      m_mask(capacity - 1), m_elements(std::make_unique<std::atomic<T>[]>(capacity))
+    { }
+
+    [[nodiscard]] std::int64_t capacity() const noexcept
+    {
+      return m_mask + 1;
+    }
+
+    [[nodiscard]] T load(std::int64_t i) const noexcept
+    {
+      return m_elements[i & m_mask].load(std::memory_order_relaxed);
+    }
+
+    void store(std::int64_t i, T t) noexcept
+    {
+      m_elements[i & m_mask].store(t, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns a buffer with twice the capacity that contains the elements in [top, bottom).
+    [[nodiscard]] std::unique_ptr<buffer> grow(std::int64_t top, std::int64_t bottom) const
+    {
+      auto b = std::make_unique<buffer>(2 * capacity());
+      for (auto i = top; i != bottom; ++i)
+      {
+        b->store(i, load(i));
+      }
+      return b;
+    }
+  };
+
+  alignas(64) std::atomic<std::int64_t> m_top{0};
+  alignas(64) std::atomic<std::int64_t> m_bottom{0};
+  std::atomic<buffer*> m_buffer;
+  // only accessed by the owner
+  std::vector<std::unique_ptr<buffer>> m_buffers;
+
+public:
+  /**
+   * @brief Constructs an empty deque.
+   * @param capacity Initial capacity, which must be a power of two.
+   */
+  explicit work_stealing_deque(std::int64_t capacity = 64)
+  {
+    m_buffers.push_back(std::make_unique<buffer>(capacity));
+    m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+  }
+
+  work_stealing_deque(work_stealing_deque const&)            = delete;
+  work_stealing_deque(work_stealing_deque&&)                 = delete;
+  work_stealing_deque& operator=(work_stealing_deque const&) = delete;
+  work_stealing_deque& operator=(work_stealing_deque&&)      = delete;
+
+  ~work_stealing_deque() = default;
+
+  /**
+   * @brief Pushes @p x at the bottom. Only the owner may call it.
+   * @param x Element to push.
+   */
+  void push(T x)
+  {
+    auto const b = m_bottom.load(std::memory_order_relaxed);
+    auto const t = m_top.load(std::memory_order_acquire);
+    auto* a      = m_buffer.load(std::memory_order_relaxed);
+    if (b - t > a->capacity() - 1)
+    {
+      m_buffers.push_back(a->grow(t, b));
+      a = m_buffers.back().get();
+      m_buffer.store(a, std::memory_order_release);
+    }
+    a->store(b, x);
+    m_bottom.store(b + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Pops an element from the bottom. Only the owner may call it.
+   * @return The element or @c nullptr if the deque is empty.
+   */
+  [[nodiscard]] T pop() noexcept
+  {
+    auto const b = m_bottom.load(std::memory_order_relaxed) - 1;
+    auto* a      = m_buffer.load(std::memory_order_relaxed);
+    m_bottom.store(b, std::memory_order_seq_cst);
+    auto t = m_top.load(std::memory_order_seq_cst);
+    if (t > b)
+    {
+      // empty
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    auto x = a->load(b);
+    if (t == b)
+    {
+      // last element, race against thieves
+      if (!m_top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      {
+        x = nullptr;
+      }
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return x;
+  }
+
+  /**
+   * @brief Steals an element from the top. Any thread may call it.
+   * @return The element or @c nullptr if the deque is empty or another thread won the race.
+   */
+  [[nodiscard]] T steal() noexcept
+  {
+    auto t       = m_top.load(std::memory_order_seq_cst);
+    auto const b = m_bottom.load(std::memory_order_seq_cst);
+    if (t >= b)
+    {
+      return nullptr;
+    }
+    auto* a = m_buffer.load(std::memory_order_acquire);
+    auto x  = a->load(t);
+    if (!m_top.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+      return nullptr;
+    }
+    return x;
+  }
+
+  /// @brief Checks if the deque is empty; the result may be outdated.
+  [[nodiscard]] bool empty() const noexcept
+  {
+    return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+  }
+};
+
+} // namespace deferred::detail
+
+#endif
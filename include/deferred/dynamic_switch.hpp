@@ -0,0 +1,232 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_DYNAMIC_SWITCH_HPP
+#define DEFERRED_DYNAMIC_SWITCH_HPP
+
+#include <cstddef>
+#include <functional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "detail/flat_case_map.hpp"
+#include "detail/map_result.hpp"
+#include "evaluate.hpp"
+#include "expression.hpp"
+#include "switch.hpp"
+#include "type_traits/homogenized_type.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/**
+ * @brief Returns the result of invoking @p body if it is callable, otherwise @p body.
+ */
+template<typename Body>
+constexpr decltype(auto) invoke_case_body(Body const& body)
+{
+  if constexpr (std::is_invocable_v<Body const&>)
+  {
+    return std::invoke(body);
+  }
+  else
+  {
+    return Body(body);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Deferred switch whose cases are added at runtime.
+ *
+ * Cases are stored in a @ref detail::flat_case_map, so that finding the case that matches the
+ * condition is @f$O(1)@f$ and adding a case is amortized @f$O(1)@f$. All cases have labels of type
+ * @p Label and bodies of type @p Body. Bodies that are callable (e.g., @c std::function) are
+ * invoked with @c std::invoke, otherwise they are returned as values.
+ *
+ * Unlike @ref switch_expression, a case with a label that already exists is ignored, which keeps
+ * first-match semantics.
+ *
+ * @tparam ConditionExpression Type of the condition expression.
+ * @tparam DefaultExpression Type of the default case expression.
+ * @tparam Label Type of the labels.
+ * @tparam Body Type of the bodies.
+ */
+template<Deferred ConditionExpression, Deferred DefaultExpression, typename Label, typename Body>
+class dynamic_switch_expression
+{
+public:
+  using condition_expression_type = ConditionExpression;
+  using default_expression_type   = DefaultExpression;
+  using case_map_type             = detail::flat_case_map<Label, Body>;
+  // the case map is not a deferred type, therefore the expression is never constant
+  using subexpression_types = std::tuple<ConditionExpression, DefaultExpression, case_map_type>;
+
+  /**
+   * @brief Result type of the dynamic switch expression (common type or variant).
+   */
+  using result_type =
+    homogenized_type_t<decltype(std::declval<typename DefaultExpression::body_type>()()),
+                       decltype(detail::invoke_case_body(std::declval<Body const&>()))>;
+
+private:
+  [[no_unique_address]] ConditionExpression m_condition;
+  [[no_unique_address]] DefaultExpression m_default;
+  case_map_type m_cases;
+
+public:
+  /**
+   * @brief Constructs a dynamic_switch_expression without any cases.
+   * @tparam Condition Type of the condition expression.
+   * @tparam Default Type of the default expression.
+   * @param condition Condition expression.
+   * @param df Default expression.
+   */
+  template<typename Condition, typename Default>
+  explicit dynamic_switch_expression(Condition&& condition, Default&& df) :
+    m_condition(std::forward<Condition>(condition)), m_default(std::forward<Default>(df))
+  { }
+
+  /**
+   * @brief Inserts a case.
+   *
+   * If a case with an equal label exists, the new case is ignored.
+   *
+   * @tparam L Type of the label.
+   * @tparam B Type of the body.
+   * @param label Label of the case.
+   * @param body Body of the case.
+   * @return @c true if the case was inserted, @c false otherwise.
+   */
+  template<typename L, typename B>
+  bool insert(L&& label, B&& body)
+  {
+    return m_cases.insert(std::forward<L>(label), std::forward<B>(body));
+  }
+
+  /**
+   * @brief Reserves space for @p n cases.
+   * @param n Number of cases.
+   */
+  void reserve(std::size_t n)
+  {
+    m_cases.reserve(n);
+  }
+
+  /// @brief Returns the number of cases.
+  [[nodiscard]] std::size_t size() const noexcept
+  {
+    return m_cases.size();
+  }
+
+  /// @brief Returns the cases.
+  [[nodiscard]] case_map_type const& cases() const noexcept
+  {
+    return m_cases;
+  }
+
+  /**
+   * @brief Evaluates the dynamic switch expression.
+   * @return Result of the dynamic switch expression.
+   */
+  [[nodiscard]] result_type operator()() const
+  {
+    auto const& condition = evaluate(m_condition);
+    if (auto const body = m_cases.find(typename case_map_type::key_type(condition)))
+    {
+      return detail::map_result<result_type>([&] { return detail::invoke_case_body(*body); });
+    }
+    return detail::map_result<result_type>([&] { return m_default(); });
+  }
+
+  /**
+   * @brief Visits the dynamic switch expression with a visitor.
+   *
+   * Only the condition and default expressions are visited, as the cases are not expressions.
+   *
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    m_condition.visit(std::forward<Visitor>(v), nesting + 1);
+    m_default.visit(std::forward<Visitor>(v), nesting + 1);
+  }
+};
+
+/**
+ * @brief Creates a new @ref dynamic_switch_expression that checks @p condition against cases that
+ * are added at runtime.
+ *
+ * If none of the cases matches, it returns the result of @p default_.
+ *
+ * Example:
+ * @code
+ * auto var = variable<std::string>();
+ * auto ex  = dynamic_switch_<std::string, std::function<int()>>(var, default_(-1));
+ * for (auto const& [name, id] : load_config())
+ * {
+ *   ex.insert(name, [id] { return id; });
+ * }
+ * @endcode
+ *
+ * @tparam Label Type of the labels.
+ * @tparam Body Type of the bodies.
+ * @tparam ConditionExpression Type of the condition expression.
+ * @tparam DefaultExpression_ Type of the default expression.
+ * @param condition Condition expression.
+ * @param default_ Default case expression.
+ * @return A @ref dynamic_switch_expression without any cases.
+ */
+template<typename Label,
+         typename Body,
+         typename ConditionExpression,
+         DefaultExpression DefaultExpression_>
+[[nodiscard]] auto dynamic_switch_(ConditionExpression&& condition, DefaultExpression_&& default_)
+{
+  using condition_expression = make_deferred_t<ConditionExpression>;
+  return dynamic_switch_expression<condition_expression,
+                                   std::decay_t<DefaultExpression_>,
+                                   Label,
+                                   Body>(std::forward<ConditionExpression>(condition),
+                                         std::forward<DefaultExpression_>(default_));
+}
+
+/**
+ * @brief Creates a new @ref dynamic_switch_expression with the cases in @p cases.
+ *
+ * @copydetails dynamic_switch_(ConditionExpression&&, DefaultExpression_&&)
+ * @tparam Cases Type of the range of (label, body) pairs.
+ * @param cases Range of (label, body) pairs.
+ */
+template<typename Label,
+         typename Body,
+         typename ConditionExpression,
+         DefaultExpression DefaultExpression_,
+         std::ranges::input_range Cases>
+[[nodiscard]] auto
+dynamic_switch_(ConditionExpression&& condition, DefaultExpression_&& default_, Cases&& cases)
+{
+  auto ex = dynamic_switch_<Label, Body>(std::forward<ConditionExpression>(condition),
+                                         std::forward<DefaultExpression_>(default_));
+  if constexpr (std::ranges::sized_range<Cases>)
+  {
+    ex.reserve(std::ranges::size(cases));
+  }
+  for (auto&& [label, body] : cases)
+  {
+    ex.insert(label, body);
+  }
+  return ex;
+}
+
+} // namespace deferred
+
+#endif
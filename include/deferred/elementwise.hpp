@@ -0,0 +1,588 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_ELEMENTWISE_HPP
+#define DEFERRED_ELEMENTWISE_HPP
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <valarray>
+#include <vector>
+
+#include "expression.hpp"
+#include "logical.hpp"
+#include "simd.hpp"
+#include "type_traits/is_deferred.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/**
+ * @brief Checks if @p T is a @c std::valarray.
+ * @tparam T Type to check.
+ */
+template<typename T>
+struct is_valarray : std::false_type
+{ };
+
+/**
+ * @brief Specialization for @c std::valarray.
+ */
+template<typename T>
+struct is_valarray<std::valarray<T>> : std::true_type
+{ };
+
+/**
+ * @brief Concept for types whose elements are stored contiguously and can be used as leaves of an
+ * element-wise evaluation (e.g., @c std::vector, @c std::valarray, @c std::span).
+ * @tparam T Type to check.
+ */
+template<typename T>
+concept ContiguousStorage =
+  is_valarray<std::remove_cvref_t<T>>::value
+  || (std::ranges::contiguous_range<T> && std::ranges::sized_range<T>);
+
+/// @brief Returns a pointer to the first element of @p t.
+template<ContiguousStorage T>
+[[nodiscard]] constexpr auto storage_data(T&& t) noexcept
+{
+  if constexpr (is_valarray<std::remove_cvref_t<T>>::value)
+  {
+    return t.size() == 0 ? nullptr : std::addressof(t[0]);
+  }
+  else
+  {
+    return std::ranges::data(t);
+  }
+}
+
+/// @brief Returns the number of elements in @p t.
+template<ContiguousStorage T>
+[[nodiscard]] constexpr std::size_t storage_size(T const& t) noexcept
+{
+  if constexpr (is_valarray<std::remove_cvref_t<T>>::value)
+  {
+    return t.size();
+  }
+  else
+  {
+    return static_cast<std::size_t>(std::ranges::size(t));
+  }
+}
+
+/// @brief Size of a kernel that does not depend on a range (i.e., broadcasts a scalar).
+inline constexpr std::size_t broadcast_size = std::numeric_limits<std::size_t>::max();
+
+/**
+ * @brief Combines the sizes of two kernels.
+ * @throws std::length_error if both sizes refer to ranges of different length.
+ */
+constexpr std::size_t combine_sizes(std::size_t x, std::size_t y)
+{
+  if (x == broadcast_size)
+  {
+    return y;
+  }
+  if (y != broadcast_size && x != y)
+  {
+    throw std::length_error("deferred::elementwise_evaluate: ranges of different size");
+  }
+  return x;
+}
+
+/**
+ * @brief Kernel for a leaf of the element-wise evaluation.
+ *
+ * The leaf node is evaluated once when the kernel is constructed. If the result is a contiguous
+ * range, then element @c i of the range is returned, otherwise the result is broadcast to all
+ * elements.
+ *
+ * @tparam Node Type of the leaf node.
+ */
+template<typename Node>
+class leaf_kernel
+{
+  using result_type = decltype(std::declval<Node const&>()());
+  using value_type  = std::remove_cvref_t<result_type>;
+
+  constexpr static inline bool is_reference = std::is_lvalue_reference_v<result_type>;
+
+public:
+  constexpr static inline bool is_range = ContiguousStorage<value_type const&>;
+
+private:
+  using storage_type = std::conditional_t<is_reference, value_type const*, value_type>;
+
+  storage_type m_value;
+
+  [[nodiscard]] constexpr value_type const& value() const noexcept
+  {
+    if constexpr (is_reference)
+    {
+      return *m_value;
+    }
+    else
+    {
+      return m_value;
+    }
+  }
+
+  static constexpr storage_type make_storage(Node const& node)
+  {
+    if constexpr (is_reference)
+    {
+      return std::addressof(node());
+    }
+    else
+    {
+      return node();
+    }
+  }
+
+public:
+  /**
+   * @brief Constructs the kernel by evaluating @p node.
+   * @param node Leaf node.
+   */
+  constexpr explicit leaf_kernel(Node const& node) : m_value(make_storage(node))
+  { }
+
+  /// @brief Returns the number of elements of this leaf, or @ref broadcast_size for scalars.
+  [[nodiscard]] constexpr std::size_t size() const noexcept
+  {
+    if constexpr (is_range)
+    {
+      return storage_size(value());
+    }
+    else
+    {
+      return broadcast_size;
+    }
+  }
+
+  /// @brief Returns the @p i-th element of this leaf.
+  [[nodiscard]] constexpr decltype(auto) operator()([[maybe_unused]] std::size_t i) const noexcept
+  {
+    if constexpr (is_range)
+    {
+      return storage_data(value())[i];
+    }
+    else
+    {
+      return value();
+    }
+  }
+
+#ifdef DEFERRED_SIMD_X86
+  /// @brief Checks if the elements starting from the @p i-th one are aligned to @p bytes.
+  [[nodiscard]] bool is_aligned([[maybe_unused]] std::size_t i, [[maybe_unused]] std::size_t bytes)
+    const noexcept
+  {
+    if constexpr (is_range)
+    {
+      return simd::is_aligned(storage_data(value()) + i, bytes);
+    }
+    else
+    {
+      return true;
+    }
+  }
+
+  /// @brief Loads the elements starting from the @p i-th one to @p v.
+  template<typename V, bool Aligned>
+  [[gnu::always_inline]] void load(V& v, [[maybe_unused]] std::size_t i) const noexcept
+  {
+    if constexpr (is_range)
+    {
+      simd::load<Aligned>(v, storage_data(value()) + i);
+    }
+    else
+    {
+      simd::broadcast(v, value());
+    }
+  }
+#endif
+};
+
+template<typename Node>
+struct kernel_type_deducer;
+
+/**
+ * @brief Alias for the kernel type of @p Node.
+ * @tparam Node Type of the node.
+ */
+template<typename Node>
+using kernel_t = typename kernel_type_deducer<std::remove_cvref_t<Node>>::type;
+
+/**
+ * @brief Kernel that applies an operator element-wise to the results of its subkernels.
+ * @tparam Operator Type of the operator.
+ * @tparam Kernels Types of the subkernels.
+ */
+template<typename Operator, typename... Kernels>
+class operator_kernel
+{
+  Operator const* m_op;
+  std::tuple<Kernels...> m_kernels;
+
+  template<typename Node, std::size_t... I>
+  constexpr operator_kernel(Node const& node, std::index_sequence<I...>) :
+    m_op(std::addressof(node.operator_())), m_kernels(std::get<I>(node.subexpressions())...)
+  { }
+
+public:
+  /**
+   * @brief Constructs the kernel and its subkernels in place from @p node.
+   * @tparam Node Type of the expression node.
+   * @param node Expression node.
+   */
+  template<typename Node>
+  constexpr explicit operator_kernel(Node const& node) :
+    operator_kernel(node, std::index_sequence_for<Kernels...>{})
+  { }
+
+  operator_kernel(operator_kernel const&) = delete;
+  operator_kernel(operator_kernel&&)      = delete;
+
+  operator_kernel& operator=(operator_kernel const&) = delete;
+  operator_kernel& operator=(operator_kernel&&)      = delete;
+
+  ~operator_kernel() = default;
+
+  /// @brief Returns the number of elements of this kernel.
+  [[nodiscard]] constexpr std::size_t size() const
+  {
+    return std::apply(
+      [](auto const&... k) {
+        auto n = broadcast_size;
+        ((n = combine_sizes(n, k.size())), ...);
+        return n;
+      },
+      m_kernels);
+  }
+
+  /// @brief Returns the @p i-th element of this kernel.
+  [[nodiscard]] constexpr decltype(auto) operator()(std::size_t i) const
+  {
+    return std::apply([this, i](auto const&... k) { return (*m_op)(k(i)...); }, m_kernels);
+  }
+
+#ifdef DEFERRED_SIMD_X86
+private:
+  template<typename V, bool Aligned, std::size_t I, std::size_t... Is>
+  [[gnu::always_inline]] void load_impl(V& v, std::size_t i, std::index_sequence<I, Is...>) const
+  {
+    std::get<I>(m_kernels).template load<V, Aligned>(v, i);
+    if constexpr (sizeof...(Is) == 0)
+    {
+      simd::apply(*m_op, v);
+    }
+    else
+    {
+      V u;
+      ((std::get<Is>(m_kernels).template load<V, Aligned>(u, i), simd::apply(*m_op, v, u)), ...);
+    }
+  }
+
+public:
+  /// @brief Checks if the elements starting from the @p i-th one are aligned to @p bytes.
+  [[nodiscard]] bool is_aligned(std::size_t i, std::size_t bytes) const noexcept
+  {
+    return std::apply([i, bytes](auto const&... k) { return (k.is_aligned(i, bytes) && ...); },
+                      m_kernels);
+  }
+
+  /// @brief Loads the elements starting from the @p i-th one to @p v.
+  template<typename V, bool Aligned>
+  [[gnu::always_inline]] void load(V& v, std::size_t i) const
+  {
+    load_impl<V, Aligned>(v, i, std::index_sequence_for<Kernels...>{});
+  }
+
+  /// @brief Compares the elements of the subkernels starting from the @p i-th one.
+  template<typename V, bool Aligned, typename M>
+  [[gnu::always_inline]] void compare(M& m, std::size_t i) const
+  {
+    V v;
+    V u;
+    std::get<0>(m_kernels).template load<V, Aligned>(v, i);
+    std::get<1>(m_kernels).template load<V, Aligned>(u, i);
+    simd::compare(*m_op, m, v, u);
+  }
+#endif
+};
+
+/**
+ * @brief Returns the element type of kernel @p Kernel.
+ * @tparam Kernel Type of the kernel.
+ */
+template<typename Kernel>
+using kernel_element_t = decltype(std::declval<Kernel const&>()(std::size_t{}));
+
+/**
+ * @brief Deduces the kernel type of leaf nodes and expressions whose operator cannot be applied
+ * element-wise.
+ */
+template<typename Node>
+struct kernel_type_deducer
+{
+  using type = leaf_kernel<Node>;
+};
+
+/**
+ * @brief Checks if any leaf of @p Kernel is a range.
+ */
+template<typename Kernel>
+struct has_range_leaf : std::false_type
+{ };
+
+/// @brief Specialization for leaves.
+template<typename Node>
+struct has_range_leaf<leaf_kernel<Node>> : std::bool_constant<leaf_kernel<Node>::is_range>
+{ };
+
+/// @brief Specialization for operators.
+template<typename Operator, typename... Kernels>
+struct has_range_leaf<operator_kernel<Operator, Kernels...>> :
+  std::disjunction<has_range_leaf<Kernels>...>
+{ };
+
+/**
+ * @brief Checks if @p Operator can be applied to the elements of @p Kernels.
+ */
+template<typename Operator, typename... Kernels>
+struct is_elementwise_invocable :
+  std::is_invocable<Operator const&, kernel_element_t<Kernels>...>::type
+{ };
+
+/**
+ * @brief Deduces the kernel type of @p Node, which applies @p Operator to @p Expressions....
+ *
+ * If any of the subexpressions has range leaves and @p Operator can be applied to their elements,
+ * the expression is fused. Otherwise, it is evaluated as a whole and treated as a leaf.
+ */
+template<typename Node, typename Operator, typename... Expressions>
+using operator_kernel_t = std::conditional_t<
+  std::conjunction_v<std::disjunction<has_range_leaf<kernel_t<Expressions>>...>,
+                     is_elementwise_invocable<Operator, kernel_t<Expressions>...>>,
+  operator_kernel<Operator, kernel_t<Expressions>...>,
+  leaf_kernel<Node>>;
+
+/// @brief Specialization for @ref expression_.
+template<typename Operator, typename... Expressions>
+struct kernel_type_deducer<expression_<Operator, Expressions...>>
+{
+  using type = operator_kernel_t<expression_<Operator, Expressions...>, Operator, Expressions...>;
+};
+
+/**
+ * @brief Specialization for @ref logical_expression.
+ *
+ * Fused logical expressions do not short-circuit, as their leaves are already evaluated.
+ */
+template<typename Operator, typename... Expressions>
+struct kernel_type_deducer<logical_expression<Operator, Expressions...>>
+{
+  using type =
+    operator_kernel_t<logical_expression<Operator, Expressions...>, Operator, Expressions...>;
+};
+
+/**
+ * @brief Checks if @p Kernel can be evaluated with SIMD vectors of elements of type @p T.
+ */
+template<typename Kernel, typename T>
+struct is_simd_kernel : std::false_type
+{ };
+
+/// @brief Specialization for leaves.
+template<typename Node, typename T>
+struct is_simd_kernel<leaf_kernel<Node>, T> :
+  std::bool_constant<std::is_same_v<std::remove_cvref_t<kernel_element_t<leaf_kernel<Node>>>, T>
+                     && simd::kind_of<std::plus<>, T>() != simd::operator_kind::none>
+{ };
+
+/// @brief Specialization for operators.
+template<typename Operator, typename... Kernels, typename T>
+struct is_simd_kernel<operator_kernel<Operator, Kernels...>, T> :
+  std::bool_constant<simd::is_arithmetic_v<Operator, T> && (is_simd_kernel<Kernels, T>::value && ...)>
+{ };
+
+/**
+ * @brief Deduces the type of the SIMD vector elements to evaluate @p Kernel with when the result is
+ * stored to @p T.
+ *
+ * The type is @c void if @p Kernel cannot be evaluated with SIMD vectors.
+ */
+template<typename Kernel, typename T>
+struct simd_element_deducer
+{
+  using type = std::conditional_t<is_simd_kernel<Kernel, T>::value, T, void>;
+};
+
+/// @brief Specialization for comparisons stored as @c bool.
+template<typename Operator, typename Kernel0, typename Kernel1>
+struct simd_element_deducer<operator_kernel<Operator, Kernel0, Kernel1>, bool>
+{
+  using element_type = std::remove_cvref_t<kernel_element_t<Kernel0>>;
+  using type         = std::conditional_t<simd::is_comparison_v<Operator, element_type>
+                                            && is_simd_kernel<Kernel0, element_type>::value
+                                            && is_simd_kernel<Kernel1, element_type>::value,
+                                          element_type,
+                                          void>;
+};
+
+/**
+ * @brief Evaluates @p kernel for all elements in @f$[0, n)@f$ and stores them in @p out.
+ *
+ * If the operators and element types of @p kernel allow it and @p isa is not
+ * @ref simd_isa::scalar, @p kernel is evaluated with SIMD vectors.
+ */
+template<typename Kernel, typename T>
+constexpr void
+run_kernel(Kernel const& kernel, T* out, std::size_t n, [[maybe_unused]] simd_isa isa)
+{
+  using element_type = typename simd_element_deducer<Kernel, T>::type;
+  if !consteval
+  {
+    if constexpr (!std::is_void_v<element_type>)
+    {
+      if (simd::run<element_type>(isa, kernel, out, n))
+      {
+        return;
+      }
+    }
+  }
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    out[i] = kernel(i);
+  }
+}
+
+/**
+ * @brief Returns @p isa if it is supported by the CPU, otherwise the widest supported one.
+ */
+[[nodiscard]] inline simd_isa supported_simd_isa(simd_isa isa) noexcept
+{
+  auto const detected = detected_simd_isa();
+  return isa < detected ? isa : detected;
+}
+
+} // namespace detail
+
+/**
+ * @brief Element type of the element-wise evaluation of @p Expression.
+ * @tparam Expression Type of the expression.
+ */
+template<typename Expression>
+using elementwise_result_t =
+  std::remove_cvref_t<detail::kernel_element_t<detail::kernel_t<Expression>>>;
+
+/**
+ * @brief Evaluates @p ex element-wise with instruction set @p isa and stores the result in @p out.
+ *
+ * Leaves of @p ex that evaluate to contiguous ranges (@c std::vector, @c std::valarray,
+ * @c std::span, etc.) are accessed element by element, while all other leaves are broadcast.
+ * Each @ref expression_ whose operator can be applied to the elements of its subexpressions is
+ * fused, so that the whole tree is traversed once per element and no temporaries are created.
+ * Expressions whose operator cannot be applied element-wise are evaluated once and treated as
+ * leaves.
+ *
+ * If all operators of the fused tree are arithmetic or bitwise @c std function objects (or a
+ * comparison at the root), and all leaves have the same element type as @p out, the tree is
+ * evaluated with SIMD vectors of @p isa, or the widest instruction set supported by the CPU if
+ * @p isa is not supported.
+ *
+ * @p out may alias any of the leaves, as each element only depends on the elements of the leaves
+ * at the same index.
+ *
+ * @tparam Expression Type of the expression.
+ * @tparam Output Type of the output range.
+ * @param ex Expression to evaluate.
+ * @param out Contiguous range to write the result to.
+ * @param isa Instruction set to use.
+ * @return @p out.
+ * @throws std::length_error if the ranges of @p ex or @p out have different sizes.
+ */
+template<Deferred Expression, detail::ContiguousStorage Output>
+constexpr Output& elementwise_evaluate(Expression const& ex, Output& out, simd_isa isa)
+{
+  using kernel_type = detail::kernel_t<Expression>;
+  static_assert(detail::has_range_leaf<kernel_type>::value,
+                "Expression does not have any range leaves");
+
+  kernel_type const kernel(ex);
+  auto const n = detail::combine_sizes(kernel.size(), detail::storage_size(out));
+  if consteval
+  {
+    detail::run_kernel(kernel, detail::storage_data(out), n, simd_isa::scalar);
+  }
+  else
+  {
+    detail::run_kernel(kernel, detail::storage_data(out), n, detail::supported_simd_isa(isa));
+  }
+  return out;
+}
+
+/**
+ * @brief Evaluates @p ex element-wise and stores the result in @p out.
+ * @copydetails elementwise_evaluate(Expression const&, Output&, simd_isa)
+ */
+template<Deferred Expression, detail::ContiguousStorage Output>
+constexpr Output& elementwise_evaluate(Expression const& ex, Output& out)
+{
+  if consteval
+  {
+    return elementwise_evaluate(ex, out, simd_isa::scalar);
+  }
+  else
+  {
+    return elementwise_evaluate(ex, out, detected_simd_isa());
+  }
+}
+
+/**
+ * @brief Evaluates @p ex element-wise.
+ * @copydetails elementwise_evaluate(Expression const&, Output&, simd_isa)
+ * @tparam Expression Type of the expression.
+ * @param ex Expression to evaluate.
+ * @return A @c std::vector with the result.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr auto elementwise_evaluate(Expression const& ex)
+{
+  using kernel_type = detail::kernel_t<Expression>;
+  using result_type = elementwise_result_t<Expression>;
+  static_assert(detail::has_range_leaf<kernel_type>::value,
+                "Expression does not have any range leaves");
+
+  kernel_type const kernel(ex);
+  std::vector<result_type> out(kernel.size());
+  if constexpr (std::is_same_v<result_type, bool>)
+  {
+    // std::vector<bool> is not contiguous
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+      out[i] = kernel(i);
+    }
+  }
+  else if consteval
+  {
+    detail::run_kernel(kernel, out.data(), out.size(), simd_isa::scalar);
+  }
+  else
+  {
+    detail::run_kernel(kernel, out.data(), out.size(), detected_simd_isa());
+  }
+  return out;
+}
+
+} // namespace deferred
+
+#endif
@@ -72,11 +72,17 @@ public:
     return m_op;
   }
 
-  [[nodiscard]] constexpr expression_types const& subexpressions() const noexcept
+  [[nodiscard]] constexpr expression_types const& subexpressions() const& noexcept
   {
     return m_expressions;
   }
 
+  /// @copydoc subexpressions() const&
+  [[nodiscard]] constexpr expression_types&& subexpressions() && noexcept
+  {
+    return std::move(m_expressions);
+  }
+
   /**
    * @brief Visits the expression with a visitor.
    * @tparam Visitor The type of the visitor.
@@ -95,6 +101,16 @@ public:
 
 namespace detail {
 
+/**
+ * @brief Checks if @p T is an @ref expression_.
+ */
+template<typename T>
+inline constexpr bool is_expression_v = false;
+
+/// @brief Specialization for @ref expression_.
+template<typename Operator, typename... Expressions>
+inline constexpr bool is_expression_v<expression_<Operator, Expressions...>> = true;
+
 /**
  * @brief Deduce the deferred type for @p T.
  *
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_FOLD_HPP
+#define DEFERRED_FOLD_HPP
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "constant.hpp"
+#include "evaluate.hpp"
+#include "expression.hpp"
+#include "type_traits/is_constant_expression.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/**
+ * @brief Checks if @p T is a constant subtree that can be replaced by a single @ref constant_.
+ */
+template<typename T>
+inline constexpr bool is_foldable_v = []() consteval {
+  if constexpr (is_constant_v<T> || !is_constant_expression_v<T>)
+  {
+    return false;
+  }
+  else
+  {
+    return !std::is_void_v<decltype(evaluate(std::declval<T const&>()))>;
+  }
+}();
+
+// Checks if T is foldable or is an expression_ that contains a foldable subtree.
+template<typename T>
+struct contains_foldable : public std::bool_constant<is_foldable_v<T>>
+{ };
+
+template<typename Operator, typename... Expressions>
+struct contains_foldable<expression_<Operator, Expressions...>> :
+  public std::bool_constant<is_foldable_v<expression_<Operator, Expressions...>>
+                            || (contains_foldable<std::remove_cvref_t<Expressions>>::value || ...)>
+{ };
+
+template<typename T>
+inline constexpr bool contains_foldable_v = contains_foldable<T>::value;
+
+template<typename Expression, typename E>
+constexpr decltype(auto) fold_impl(E&& e);
+
+/// @brief Folds the subexpressions of the @ref expression_ @p e.
+template<typename E, std::size_t... I>
+constexpr auto fold_subexpressions(E const& e, std::index_sequence<I...>)
+{
+  using expression_types = typename E::expression_types;
+  using folded_type =
+    expression_<typename E::operator_type,
+                decltype(fold_impl<std::tuple_element_t<I, expression_types>>(
+                  std::get<I>(e.subexpressions())))...>;
+  return folded_type(e.operator_(),
+                     fold_impl<std::tuple_element_t<I, expression_types>>(
+                       std::get<I>(e.subexpressions()))...);
+}
+
+/**
+ * @brief Folds @p e, which is stored as @p Expression.
+ *
+ * Nodes that do not change keep the type they are stored as, i.e., referenced nodes remain
+ * references and owned nodes are copied.
+ */
+template<typename Expression, typename E>
+constexpr decltype(auto) fold_impl(E&& e)
+{
+  using expression_type = std::remove_cvref_t<E>;
+  if constexpr (is_foldable_v<expression_type>)
+  {
+    using result_type = decltype(evaluate(e));
+    return constant_<result_type>(evaluate(e));
+  }
+  else if constexpr (contains_foldable_v<expression_type>)
+  {
+    using expression_types = typename expression_type::expression_types;
+    return fold_subexpressions(e, std::make_index_sequence<std::tuple_size_v<expression_types>>{});
+  }
+  else if constexpr (std::is_lvalue_reference_v<Expression>)
+  {
+    return static_cast<Expression>(e);
+  }
+  else
+  {
+    return expression_type(e);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Evaluates the constant subtrees of @p expr and replaces them with a @ref constant_.
+ *
+ * A subtree is constant if @ref is_constant_expression is @c true for it, i.e., it has no
+ * @ref variable_ and its operators are stateless; such operators are assumed to have no side
+ * effects. Subtrees are searched through @ref expression_ nodes; other nodes (e.g.,
+ * @ref conditional_expression) are only folded if they are constant as a whole.
+ *
+ * The returned expression has a different type than @p expr. Nodes that are not folded are
+ * referenced if @p expr references them and copied otherwise.
+ *
+ * Example:
+ * @code
+ * auto x  = variable<double>();
+ * auto ex = fold(x * (constant(2.0) * constant(3.0)) + invoke([] { return std::sqrt(2.0); }));
+ * // equivalent to x * constant(6.0) + constant(1.414...)
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to fold.
+ * @return A new expression in which constant subtrees are replaced by @ref constant_.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr decltype(auto) fold(Expression&& expr)
+{
+  using expression_type = std::remove_cvref_t<Expression>;
+  if constexpr (!detail::contains_foldable_v<expression_type>
+                && !std::is_lvalue_reference_v<Expression>)
+  {
+    return expression_type(std::forward<Expression>(expr));
+  }
+  else
+  {
+    return detail::fold_impl<Expression>(expr);
+  }
+}
+
+} // namespace deferred
+
+#endif
@@ -0,0 +1,234 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_LOGICAL_HPP
+#define DEFERRED_LOGICAL_HPP
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/**
+ * @brief Checks if @c operator&& is overloaded for @p T and @p U.
+ */
+template<typename T, typename U>
+concept OverloadedLogicalAnd = requires(T&& t, U&& u) {
+  operator&&(std::forward<T>(t), std::forward<U>(u));
+} || requires(T&& t, U&& u) { std::forward<T>(t).operator&&(std::forward<U>(u)); };
+
+/**
+ * @brief Checks if @c operator|| is overloaded for @p T and @p U.
+ */
+template<typename T, typename U>
+concept OverloadedLogicalOr = requires(T&& t, U&& u) {
+  operator||(std::forward<T>(t), std::forward<U>(u));
+} || requires(T&& t, U&& u) { std::forward<T>(t).operator||(std::forward<U>(u)); };
+
+/**
+ * @brief Checks if the built-in logical operator that @p Operator represents is used when folding
+ * values of types @p T, @p U, @p Ts... from the left.
+ *
+ * Only the built-in operators short-circuit; overloaded ones are called with all their operands
+ * evaluated, as they would be without deferred evaluation.
+ */
+template<typename Operator, typename T, typename U, typename... Ts>
+inline constexpr bool is_builtin_logical_v = false;
+
+/// @brief Specialization for @c std::logical_and.
+template<typename V, typename T, typename U, typename... Ts>
+inline constexpr bool is_builtin_logical_v<std::logical_and<V>, T, U, Ts...> =
+  !OverloadedLogicalAnd<T, U> && (!OverloadedLogicalAnd<bool, Ts> && ...);
+
+/// @brief Specialization for @c std::logical_or.
+template<typename V, typename T, typename U, typename... Ts>
+inline constexpr bool is_builtin_logical_v<std::logical_or<V>, T, U, Ts...> =
+  !OverloadedLogicalOr<T, U> && (!OverloadedLogicalOr<bool, Ts> && ...);
+
+/// @brief Checks if @p Operator is @c std::logical_and.
+template<typename Operator>
+inline constexpr bool is_logical_and_v = false;
+
+/// @brief Specialization for @c std::logical_and.
+template<typename V>
+inline constexpr bool is_logical_and_v<std::logical_and<V>> = true;
+
+/**
+ * @brief Result of applying @p Operator to the operands of @ref fold_left so far.
+ *
+ * Each operand is applied with @c operator<<, so that a fold expression folds the operands without
+ * recursive instantiations.
+ */
+template<typename Operator, typename T>
+struct fold_left_accumulator
+{
+  Operator const& op;
+  T value;
+
+  template<typename U>
+  [[nodiscard]] constexpr auto operator<<(U&& u) &&
+  {
+    using result_type = decltype(op(std::forward<T>(value), std::forward<U>(u)));
+    return fold_left_accumulator<Operator, result_type>{
+      op, op(std::forward<T>(value), std::forward<U>(u))};
+  }
+};
+
+/**
+ * @brief Applies the binary operator @p op to @p t, @p u, @p ts... from the left.
+ */
+template<typename Operator, typename T, typename U, typename... Ts>
+constexpr decltype(auto) fold_left(Operator const& op, T&& t, U&& u, Ts&&... ts)
+{
+  if constexpr (sizeof...(Ts) == 0)
+  {
+    return op(std::forward<T>(t), std::forward<U>(u));
+  }
+  else
+  {
+    using first_type = decltype(op(std::forward<T>(t), std::forward<U>(u)));
+    auto&& result    = (fold_left_accumulator<Operator, first_type>{
+                       op, op(std::forward<T>(t), std::forward<U>(u))}
+                     << ... << std::forward<Ts>(ts));
+    return std::move(result).value;
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Deferred logical expression that applies @c std::logical_and or @c std::logical_or to
+ * subexpressions @p Expressions... from the left.
+ *
+ * Subexpressions are evaluated from left to right, and evaluation stops as soon as the result is
+ * known (i.e., the first @c false operand for @c std::logical_and, the first @c true for
+ * @c std::logical_or). If the logical operator is overloaded for the results of the subexpressions,
+ * all of them are evaluated before the overloaded operator is called.
+ *
+ * @tparam Operator Type of the operator.
+ * @tparam Expressions Types of the subexpressions.
+ */
+template<typename Operator, typename... Expressions>
+class logical_expression
+{
+  static_assert(sizeof...(Expressions) >= 2, "Logical expressions require at least two operands");
+
+public:
+  using operator_type       = Operator;
+  using expression_types    = std::tuple<Expressions...>;
+  using subexpression_types = std::tuple<Operator, Expressions...>;
+
+private:
+  [[no_unique_address]] operator_type m_op;
+  [[no_unique_address]] expression_types m_expressions;
+
+  template<typename Self, std::size_t... I>
+  static constexpr decltype(auto) evaluate_impl(Self& self, std::index_sequence<I...>)
+  {
+    if constexpr (!detail::is_builtin_logical_v<Operator,
+                                                decltype(std::get<I>(self.m_expressions)())...>)
+    {
+      // evaluate all operands in order, as the overloaded operator does not short-circuit
+      auto values = std::tuple<decltype(std::get<I>(self.m_expressions)())...>{
+        std::get<I>(self.m_expressions)()...};
+      return detail::fold_left(self.m_op, std::get<I>(std::move(values))...);
+    }
+    else if constexpr (detail::is_logical_and_v<Operator>)
+    {
+      return (std::get<I>(self.m_expressions)() && ...);
+    }
+    else
+    {
+      return (std::get<I>(self.m_expressions)() || ...);
+    }
+  }
+
+public:
+  /**
+   * @brief Constructs a logical expression.
+   * @tparam Op Type of the operator.
+   * @tparam Ex Types of the subexpressions.
+   * @param op Operator.
+   * @param ex Subexpressions.
+   */
+  template<typename Op, typename... Ex>
+    requires(!std::is_same_v<std::remove_cvref_t<Op>, logical_expression>)
+  constexpr explicit logical_expression(Op&& op, Ex&&... ex) :
+    m_op(std::forward<Op>(op)), m_expressions(std::forward<Ex>(ex)...)
+  { }
+
+  logical_expression(logical_expression const&) = default;
+  logical_expression(logical_expression&&)      = default;
+
+  ~logical_expression() = default;
+
+  logical_expression& operator=(logical_expression const&) = delete;
+  logical_expression& operator=(logical_expression&&)      = delete;
+
+  [[nodiscard]] constexpr decltype(auto) operator()() const
+  {
+    return evaluate_impl(*this, std::index_sequence_for<Expressions...>{});
+  }
+
+  /// @copydoc operator()() const
+  [[nodiscard]] constexpr decltype(auto) operator()()
+  {
+    return evaluate_impl(*this, std::index_sequence_for<Expressions...>{});
+  }
+
+  [[nodiscard]] constexpr operator_type const& operator_() const noexcept
+  {
+    return m_op;
+  }
+
+  [[nodiscard]] constexpr expression_types const& subexpressions() const& noexcept
+  {
+    return m_expressions;
+  }
+
+  /// @copydoc subexpressions() const&
+  [[nodiscard]] constexpr expression_types&& subexpressions() && noexcept
+  {
+    return std::move(m_expressions);
+  }
+
+  /**
+   * @brief Visits the expression with a visitor.
+   * @tparam Visitor The type of the visitor.
+   * @param v The visitor.
+   * @param nesting The nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    std::apply([&v, nesting](
+                 auto const&... args) { (args.visit(std::forward<Visitor>(v), nesting + 1), ...); },
+               m_expressions);
+  }
+};
+
+/**
+ * @brief Creates a @ref logical_expression that applies @p op to @p args... from the left.
+ * @tparam Operator Type of the operator.
+ * @tparam Args Types of the operands.
+ * @param op Operator (@c std::logical_and or @c std::logical_or).
+ * @param args Operands.
+ * @return An expression representing the operation.
+ */
+template<typename Operator, typename... Args>
+[[nodiscard]] constexpr auto make_logical_expression(Operator&& op, Args&&... args)
+{
+  using expression_type = logical_expression<std::decay_t<Operator>, make_deferred_t<Args>...>;
+  return expression_type(std::forward<Operator>(op), std::forward<Args>(args)...);
+}
+
+} // namespace deferred
+
+#endif
@@ -28,6 +28,7 @@ struct fun_ptr_wrapper
   { }
 
   template<typename... T>
+    requires std::is_invocable_v<F const&, T...>
   [[nodiscard]] constexpr decltype(auto)
   operator()(T&&... t) const noexcept(noexcept(m_f(std::forward<T>(t)...)))
   {
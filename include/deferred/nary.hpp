@@ -0,0 +1,284 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_NARY_HPP
+#define DEFERRED_NARY_HPP
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.hpp"
+#include "invoke.hpp"
+#include "logical.hpp"
+#include "type_traits/is_pure_expression.hpp"
+
+namespace deferred {
+
+/**
+ * @brief Maximum number of operands of the nodes that chains of an associative operator are
+ * flattened to.
+ *
+ * Appending an operand to a node creates a node with one more operand, therefore the cost of
+ * compiling a chain grows with the square of the number of operands of its nodes. Once a node is
+ * full, it becomes the first operand of a new node.
+ */
+inline constexpr std::size_t max_nary_operands = 8;
+
+/**
+ * @brief Function object that applies the associative binary operator @p Operator to its
+ * arguments from the left.
+ *
+ * It is the operator of the @ref expression_ nodes that chains of the same associative operator
+ * (e.g., <tt>a + b + c + d</tt>) are flattened to, so that the depth of the tree grows with the
+ * length of the chain divided by @ref max_nary_operands. The result is the same as that of the
+ * chain.
+ *
+ * @tparam Operator Type of the binary operator.
+ */
+template<typename Operator>
+struct nary_operator
+{
+  using binary_operator_type = Operator;
+
+  [[no_unique_address]] Operator m_op;
+
+  template<typename T, typename U, typename... Ts>
+  [[nodiscard]] constexpr decltype(auto) operator()(T&& t, U&& u, Ts&&... ts) const
+  {
+    return detail::fold_left(m_op, std::forward<T>(t), std::forward<U>(u), std::forward<Ts>(ts)...);
+  }
+};
+
+/**
+ * @brief Function object that applies the associative binary operator @p Operator to its
+ * arguments pairwise.
+ *
+ * The arguments are split in two halves, each half is reduced recursively and the operator is
+ * applied to the two results. For floating-point sums, the rounding error grows with the logarithm
+ * of the number of arguments instead of linearly, therefore the result may differ from that of
+ * @ref nary_operator.
+ *
+ * @tparam Operator Type of the binary operator.
+ */
+template<typename Operator>
+struct pairwise_operator
+{
+  [[no_unique_address]] Operator m_op;
+
+private:
+  template<std::size_t Offset, std::size_t Count, typename Tuple>
+  [[nodiscard]] constexpr auto reduce(Tuple& args) const
+  {
+    if constexpr (Count == 1)
+    {
+      return std::forward<std::tuple_element_t<Offset, Tuple>>(std::get<Offset>(args));
+    }
+    else
+    {
+      constexpr std::size_t half = Count / 2;
+      return m_op(reduce<Offset, half>(args), reduce<Offset + half, Count - half>(args));
+    }
+  }
+
+public:
+  template<typename T, typename U, typename... Ts>
+  [[nodiscard]] constexpr auto operator()(T&& t, U&& u, Ts&&... ts) const
+  {
+    auto args =
+      std::forward_as_tuple(std::forward<T>(t), std::forward<U>(u), std::forward<Ts>(ts)...);
+    return reduce<0, sizeof...(Ts) + 2>(args);
+  }
+};
+
+/// @brief Specialization for @ref nary_operator.
+template<typename Operator>
+struct is_pure_operator<nary_operator<Operator>> : public is_pure_operator<Operator>
+{ };
+
+/// @brief Specialization for @ref pairwise_operator.
+template<typename Operator>
+struct is_pure_operator<pairwise_operator<Operator>> : public is_pure_operator<Operator>
+{ };
+
+namespace detail {
+
+/// @brief Checks if @p Operator is @c std::logical_and or @c std::logical_or.
+template<typename Operator>
+inline constexpr bool is_logical_operator_v = false;
+
+/// @brief Specialization for @c std::logical_and.
+template<typename V>
+inline constexpr bool is_logical_operator_v<std::logical_and<V>> = true;
+
+/// @brief Specialization for @c std::logical_or.
+template<typename V>
+inline constexpr bool is_logical_operator_v<std::logical_or<V>> = true;
+
+/// @brief Checks if @p E is an @ref expression_ with a @ref nary_operator.
+template<typename E>
+inline constexpr bool is_nary_expression_v = false;
+
+/// @brief Specialization for @ref expression_ with @ref nary_operator.
+template<typename Operator, typename... Expressions>
+inline constexpr bool is_nary_expression_v<expression_<nary_operator<Operator>, Expressions...>> =
+  true;
+
+/**
+ * @brief Checks if @p E is a node of the chain of @p Operator, i.e., an @ref expression_ with
+ * operator @p Operator or @ref nary_operator<Operator>.
+ */
+template<typename Operator, typename E>
+inline constexpr bool is_chain_v = false;
+
+/// @brief Specialization for binary @ref expression_.
+template<typename Operator, typename T, typename U>
+inline constexpr bool is_chain_v<Operator, expression_<Operator, T, U>> = true;
+
+/// @brief Specialization for @ref expression_ with @ref nary_operator.
+template<typename Operator, typename... Expressions>
+inline constexpr bool is_chain_v<Operator, expression_<nary_operator<Operator>, Expressions...>> =
+  true;
+
+/// @brief Specialization for @ref logical_expression.
+template<typename Operator, typename... Expressions>
+inline constexpr bool is_chain_v<Operator, logical_expression<Operator, Expressions...>> = true;
+
+/// @brief Checks if @p E is a chain of @p Operator with fewer than @ref max_nary_operands operands.
+template<typename Operator, typename E>
+inline constexpr bool is_appendable_chain_v = [] {
+  if constexpr (is_chain_v<Operator, E>)
+  {
+    return std::tuple_size_v<typename E::expression_types> < max_nary_operands;
+  }
+  else
+  {
+    return false;
+  }
+}();
+
+/// @brief Creates the node that appends @p u to the operands of the chain @p t.
+template<typename Operator, typename T, typename U, std::size_t... I>
+[[nodiscard]] constexpr auto append_operand(Operator op, T&& t, U&& u, std::index_sequence<I...>)
+{
+  using expression_types = typename T::expression_types;
+  if constexpr (is_logical_operator_v<Operator>)
+  {
+    using expression_type = logical_expression<Operator,
+                                               std::tuple_element_t<I, expression_types>...,
+                                               make_deferred_t<U>>;
+    return expression_type(
+      std::move(op), std::get<I>(std::move(t).subexpressions())..., std::forward<U>(u));
+  }
+  else
+  {
+    using expression_type = expression_<nary_operator<Operator>,
+                                        std::tuple_element_t<I, expression_types>...,
+                                        make_deferred_t<U>>;
+    return expression_type(nary_operator<Operator>{std::move(op)},
+                           std::get<I>(std::move(t).subexpressions())...,
+                           std::forward<U>(u));
+  }
+}
+
+/**
+ * @brief Creates an expression that applies the associative operator @p op to @p t and @p u.
+ *
+ * If @p t is a temporary chain of @p op with fewer than @ref max_nary_operands operands, then @p u
+ * is appended to its operands, instead of creating a node with @p t as an operand; if @p t is full,
+ * it becomes the first operand of a new chain. Chains that are lvalues are not flattened, as they
+ * are referenced by the new node.
+ */
+template<typename Operator, typename T, typename U>
+[[nodiscard]] constexpr auto invoke_associative(Operator op, T&& t, U&& u)
+{
+  using left_type = std::remove_cvref_t<T>;
+  if constexpr (!std::is_lvalue_reference_v<T> && is_appendable_chain_v<Operator, left_type>)
+  {
+    return append_operand(
+      std::move(op),
+      std::move(t),
+      std::forward<U>(u),
+      std::make_index_sequence<std::tuple_size_v<typename left_type::expression_types>>{});
+  }
+  else if constexpr (is_logical_operator_v<Operator>)
+  {
+    return make_logical_expression(std::move(op), std::forward<T>(t), std::forward<U>(u));
+  }
+  else if constexpr (!std::is_lvalue_reference_v<T> && is_chain_v<Operator, left_type>)
+  {
+    // full chains become the first operand of a new node
+    using expression_type = expression_<nary_operator<Operator>, left_type, make_deferred_t<U>>;
+    return expression_type(nary_operator<Operator>{std::move(op)}, std::move(t), std::forward<U>(u));
+  }
+  else
+  {
+    return invoke(std::move(op), std::forward<T>(t), std::forward<U>(u));
+  }
+}
+
+/**
+ * @brief Returns the operands of the chain @p expr, with the operands of the nested chain in place
+ * of its first operand.
+ */
+template<typename Operator, typename Expression>
+[[nodiscard]] constexpr auto chain_operands(Expression&& expr)
+{
+  using expression_types = typename std::remove_cvref_t<Expression>::expression_types;
+  using first_type       = std::tuple_element_t<0, expression_types>;
+  if constexpr (is_nary_expression_v<first_type> && is_chain_v<Operator, first_type>)
+  {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+      auto&& operands = std::forward<Expression>(expr).subexpressions();
+      return std::tuple_cat(
+        chain_operands<Operator>(std::get<0>(std::forward<decltype(operands)>(operands))),
+        std::tuple<std::tuple_element_t<I + 1, expression_types>...>(
+          std::get<I + 1>(std::forward<decltype(operands)>(operands))...));
+    }(std::make_index_sequence<std::tuple_size_v<expression_types> - 1>{});
+  }
+  else
+  {
+    return expression_types(std::forward<Expression>(expr).subexpressions());
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Creates an expression that evaluates the chain @p expr pairwise.
+ *
+ * @p expr is an @ref expression_ with a @ref nary_operator, e.g., <tt>a + b + c + d</tt>; the
+ * result is an @ref expression_ with the operands of the chain and a @ref pairwise_operator. It is
+ * intended for long floating-point sums and products.
+ *
+ * Example:
+ * @code
+ * auto sum = pairwise(x0 + x1 + x2 + x3); // (x0 + x1) + (x2 + x3)
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Chain to evaluate pairwise.
+ * @return An @ref expression_ that evaluates the operands of @p expr pairwise.
+ */
+template<typename Expression>
+  requires detail::is_nary_expression_v<std::remove_cvref_t<Expression>>
+[[nodiscard]] constexpr auto pairwise(Expression&& expr)
+{
+  using binary_operator_type =
+    typename std::remove_cvref_t<Expression>::operator_type::binary_operator_type;
+  using operator_type = pairwise_operator<binary_operator_type>;
+  auto op             = operator_type{expr.operator_().m_op};
+  // chains longer than max_nary_operands are nested, and all their operands are reduced pairwise
+  auto operands = detail::chain_operands<binary_operator_type>(std::forward<Expression>(expr));
+  using operands_type = decltype(operands);
+  return [&]<std::size_t... I>(std::index_sequence<I...>) {
+    using expression_type = expression_<operator_type, std::tuple_element_t<I, operands_type>...>;
+    return expression_type(std::move(op), std::get<I>(std::move(operands))...);
+  }(std::make_index_sequence<std::tuple_size_v<operands_type>>{});
+}
+
+} // namespace deferred
+
+#endif
@@ -7,13 +7,80 @@
 #include <functional>
 #include <utility>
 
+#include <type_traits>
+
 #include "invoke.hpp"
+#include "logical.hpp"
+#include "nary.hpp"
 #include "type_traits/is_deferred.hpp"
+#include "variable.hpp"
 
 namespace deferred {
 
+namespace detail {
+
+/**
+ * @brief Function object that calls @ref variable_::touch() after invoking @p Operator.
+ *
+ * It is used for the operators that modify a @ref variable_ in place, so that its version is
+ * incremented.
+ *
+ * @tparam Operator Type of the modifying operator.
+ * @tparam Variable Type of the variable.
+ */
+template<typename Operator, typename Variable>
+class touching_operator
+{
+  [[no_unique_address]] Operator m_op;
+  Variable* m_variable;
+
+public:
+  /**
+   * @brief Constructs a touching_operator.
+   * @param op Modifying operator.
+   * @param variable Variable that is modified by @p op.
+   */
+  constexpr touching_operator(Operator op, Variable& variable) noexcept :
+    m_op(std::move(op)), m_variable(&variable)
+  { }
+
+  template<typename T>
+  constexpr decltype(auto) operator()(T&& t) const
+  {
+    decltype(auto) result = m_op(std::forward<T>(t));
+    m_variable->touch();
+    return result;
+  }
+};
+
+/**
+ * @brief Creates an expression that invokes the modifying operator @p op with @p t.
+ *
+ * If @p t is a @ref variable_ lvalue, then it is touched after each evaluation.
+ */
+template<typename Operator, typename T>
+[[nodiscard]] constexpr auto invoke_modifying(Operator op, T&& t)
+{
+  using operand_type = std::remove_reference_t<T>;
+  if constexpr (std::is_lvalue_reference_v<T> && !std::is_const_v<operand_type>
+                && is_variable_v<operand_type>)
+  {
+    return invoke(touching_operator<Operator, operand_type>(std::move(op), t), t);
+  }
+  else
+  {
+    return invoke(std::move(op), std::forward<T>(t));
+  }
+}
+
+} // namespace detail
+
 /**
  * @brief Deferred binary operator +
+ *
+ * If @p t is a temporary chain of @c +, then @p u is appended to its operands (see
+ * @ref nary_operator).
+ *
  * @tparam T Type of the left operand.
  * @tparam U Type of the right operand.
  * @param t Left operand.
@@ -24,7 +91,7 @@ template<typename T, typename U>
   requires AnyDeferred<T, U>
 [[nodiscard]] constexpr auto operator+(T&& t, U&& u)
 {
-  return invoke(std::plus<>{}, std::forward<T>(t), std::forward<U>(u));
+  return detail::invoke_associative(std::plus<>{}, std::forward<T>(t), std::forward<U>(u));
 }
 
 /**
@@ -68,6 +135,10 @@ template<Deferred T>
 
 /**
  * @brief Deferred binary operator *
+ *
+ * If @p t is a temporary chain of @c *, then @p u is appended to its operands (see
+ * @ref nary_operator).
+ *
  * @tparam T Type of the left operand.
  * @tparam U Type of the right operand.
  * @param t Left operand.
@@ -78,7 +149,7 @@ template<typename T, typename U>
   requires AnyDeferred<T, U>
 [[nodiscard]] constexpr auto operator*(T&& t, U&& u)
 {
-  return invoke(std::multiplies<>{}, std::forward<T>(t), std::forward<U>(u));
+  return detail::invoke_associative(std::multiplies<>{}, std::forward<T>(t), std::forward<U>(u));
 }
 
 /**
@@ -120,7 +191,8 @@ template<typename T, typename U>
 template<Deferred T>
 [[nodiscard]] constexpr auto operator++(T&& t)
 {
-  return invoke([](auto&& x) { return ++std::forward<decltype(x)>(x); }, std::forward<T>(t));
+  return detail::invoke_modifying([](auto&& x) { return ++std::forward<decltype(x)>(x); },
+                                  std::forward<T>(t));
 }
 
 /**
@@ -133,7 +205,8 @@ template<Deferred T>
 template<Deferred T>
 [[nodiscard]] constexpr auto operator++(T&& t, int)
 {
-  return invoke([](auto&& x) { return std::forward<decltype(x)>(x)++; }, std::forward<T>(t));
+  return detail::invoke_modifying([](auto&& x) { return std::forward<decltype(x)>(x)++; },
+                                  std::forward<T>(t));
 }
 
 /**
@@ -145,7 +218,8 @@ template<Deferred T>
 template<Deferred T>
 [[nodiscard]] constexpr auto operator--(T&& t)
 {
-  return invoke([](auto&& x) { return --std::forward<decltype(x)>(x); }, std::forward<T>(t));
+  return detail::invoke_modifying([](auto&& x) { return --std::forward<decltype(x)>(x); },
+                                  std::forward<T>(t));
 }
 
 /**
@@ -158,7 +232,8 @@ template<Deferred T>
 template<Deferred T>
 [[nodiscard]] constexpr auto operator--(T&& t, int)
 {
-  return invoke([](auto&& x) { return std::forward<decltype(x)>(x)--; }, std::forward<T>(t));
+  return detail::invoke_modifying([](auto&& x) { return std::forward<decltype(x)>(x)--; },
+                                  std::forward<T>(t));
 }
 
 /**
@@ -253,6 +328,11 @@ template<typename T, typename U>
 
 /**
  * @brief Deferred binary operator &&
+ *
+ * @p u is only evaluated if @p t evaluates to @c true, unless @c operator&& is overloaded for the
+ * results of @p t and @p u. If @p t is a temporary chain of @c &&, then @p u is appended to its
+ * operands.
+ *
  * @tparam T Type of the left operand.
  * @tparam U Type of the right operand.
  * @param t Left operand.
@@ -263,11 +343,16 @@ template<typename T, typename U>
   requires AnyDeferred<T, U>
 [[nodiscard]] constexpr auto operator&&(T&& t, U&& u)
 {
-  return invoke(std::logical_and<>{}, std::forward<T>(t), std::forward<U>(u));
+  return detail::invoke_associative(std::logical_and<>{}, std::forward<T>(t), std::forward<U>(u));
 }
 
 /**
  * @brief Deferred binary operator ||
+ *
+ * @p u is only evaluated if @p t evaluates to @c false, unless @c operator|| is overloaded for the
+ * results of @p t and @p u. If @p t is a temporary chain of @c ||, then @p u is appended to its
+ * operands.
+ *
  * @tparam T Type of the left operand.
  * @tparam U Type of the right operand.
  * @param t Left operand.
@@ -278,7 +363,7 @@ template<typename T, typename U>
   requires AnyDeferred<T, U>
 [[nodiscard]] constexpr auto operator||(T&& t, U&& u)
 {
-  return invoke(std::logical_or<>{}, std::forward<T>(t), std::forward<U>(u));
+  return detail::invoke_associative(std::logical_or<>{}, std::forward<T>(t), std::forward<U>(u));
 }
 
 /**
@@ -295,6 +380,10 @@ template<Deferred T>
 
 /**
  * @brief Deferred binary operator &
+ *
+ * If @p t is a temporary chain of @c &, then @p u is appended to its operands (see
+ * @ref nary_operator).
+ *
  * @tparam T Type of the left operand.
  * @tparam U Type of the right operand.
  * @param t Left operand.
@@ -305,11 +394,15 @@ template<typename T, typename U>
   requires AnyDeferred<T, U>
 [[nodiscard]] constexpr auto operator&(T&& t, U&& u)
 {
-  return invoke(std::bit_and<>{}, std::forward<T>(t), std::forward<U>(u));
+  return detail::invoke_associative(std::bit_and<>{}, std::forward<T>(t), std::forward<U>(u));
 }
 
 /**
  * @brief Deferred binary operator |
+ *
+ * If @p t is a temporary chain of @c |, then @p u is appended to its operands (see
+ * @ref nary_operator).
+ *
  * @tparam T Type of the left operand.
  * @tparam U Type of the right operand.
  * @param t Left operand.
@@ -320,11 +413,15 @@ template<typename T, typename U>
   requires AnyDeferred<T, U>
 [[nodiscard]] constexpr auto operator|(T&& t, U&& u)
 {
-  return invoke(std::bit_or<>{}, std::forward<T>(t), std::forward<U>(u));
+  return detail::invoke_associative(std::bit_or<>{}, std::forward<T>(t), std::forward<U>(u));
 }
 
 /**
  * @brief Deferred binary operator ^
+ *
+ * If @p t is a temporary chain of @c ^, then @p u is appended to its operands (see
+ * @ref nary_operator).
+ *
  * @tparam T Type of the left operand.
  * @tparam U Type of the right operand.
  * @param t Left operand.
@@ -335,7 +432,7 @@ template<typename T, typename U>
   requires AnyDeferred<T, U>
 [[nodiscard]] constexpr auto operator^(T&& t, U&& u)
 {
-  return invoke(std::bit_xor<>{}, std::forward<T>(t), std::forward<U>(u));
+  return detail::invoke_associative(std::bit_xor<>{}, std::forward<T>(t), std::forward<U>(u));
 }
 
 /**
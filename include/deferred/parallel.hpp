@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_PARALLEL_HPP
+#define DEFERRED_PARALLEL_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.hpp"
+#include "thread_pool.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/**
+ * @brief Stores the result of evaluating a subexpression on another thread.
+ *
+ * References are stored as pointers, values in a @c std::optional.
+ *
+ * @tparam T Type of the result.
+ */
+template<typename T>
+class result_holder
+{
+  std::optional<T> m_value;
+
+public:
+  template<typename F>
+  void emplace(F&& f)
+  {
+    m_value.emplace(std::forward<F>(f)());
+  }
+
+  [[nodiscard]] T&& get() noexcept
+  {
+    return std::move(*m_value);
+  }
+};
+
+/// @brief Specialization for references.
+template<typename T>
+  requires std::is_reference_v<T>
+class result_holder<T>
+{
+  std::remove_reference_t<T>* m_ptr{};
+
+public:
+  template<typename F>
+  void emplace(F&& f)
+  {
+    m_ptr = std::addressof(std::forward<F>(f)());
+  }
+
+  [[nodiscard]] T&& get() noexcept
+  {
+    return static_cast<T&&>(*m_ptr);
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Deferred expression that evaluates the subexpressions of an @ref expression_
+ * concurrently on a @ref thread_pool and then applies its operator to the results.
+ *
+ * The subexpressions must be independent of each other, i.e., it must be safe to evaluate them
+ * concurrently.
+ *
+ * @tparam Expression Type of the @ref expression_.
+ */
+template<Deferred Expression>
+  requires detail::is_expression_v<std::remove_cvref_t<Expression>>
+class parallel_expression
+{
+public:
+  using expression_type = Expression;
+  // the thread pool is not a deferred type, therefore the expression is never constant
+  using subexpression_types = std::tuple<Expression, thread_pool*>;
+
+private:
+  Expression m_expression;
+  thread_pool* m_pool;
+
+  template<std::size_t... I>
+  decltype(auto) evaluate_parallel(std::index_sequence<I...>) const
+  {
+    auto const& subexpressions = m_expression.subexpressions();
+    std::tuple<detail::result_holder<decltype(std::get<I>(subexpressions)())>...> results;
+    fork_join(*m_pool, [&] {
+      std::get<I>(results).emplace([&]() -> decltype(auto) {
+        return std::get<I>(subexpressions)();
+      });
+    }...);
+    return std::invoke(m_expression.operator_(), std::get<I>(results).get()...);
+  }
+
+public:
+  /**
+   * @brief Constructs a parallel_expression.
+   * @tparam E Type of the expression.
+   * @param pool Thread pool to evaluate the subexpressions on.
+   * @param e Expression to evaluate.
+   */
+  template<typename E>
+  explicit parallel_expression(thread_pool& pool, E&& e) :
+    m_expression(std::forward<E>(e)), m_pool(&pool)
+  { }
+
+  /**
+   * @brief Evaluates the parallel expression.
+   *
+   * If evaluating a subexpression throws, the first exception is rethrown after all
+   * subexpressions have been evaluated.
+   *
+   * @return Result of the expression.
+   */
+  [[nodiscard]] decltype(auto) operator()() const
+  {
+    using expression_types = typename std::remove_cvref_t<Expression>::expression_types;
+    return evaluate_parallel(std::make_index_sequence<std::tuple_size_v<expression_types>>{});
+  }
+
+  /**
+   * @brief Visits the parallel expression with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    m_expression.visit(std::forward<Visitor>(v), nesting + 1);
+  }
+};
+
+/**
+ * @brief Creates a new @ref parallel_expression that evaluates the subexpressions of @p expr
+ * concurrently on @p pool.
+ *
+ * Example:
+ * @code
+ * auto ex = par_(invoke(combine, risk(x), price(x), hedge(x)));
+ * ex(); // risk, price, and hedge are evaluated concurrently
+ * @endcode
+ *
+ * @tparam Expression Type of the @ref expression_.
+ * @param pool Thread pool to evaluate the subexpressions on.
+ * @param expr Expression to evaluate.
+ * @return A @ref parallel_expression for @p expr.
+ */
+template<Deferred Expression>
+[[nodiscard]] auto par_(thread_pool& pool, Expression&& expr)
+{
+  return parallel_expression<make_deferred_t<Expression>>(pool, std::forward<Expression>(expr));
+}
+
+/**
+ * @brief Creates a new @ref parallel_expression that evaluates the subexpressions of @p expr
+ * concurrently on @ref default_thread_pool().
+ *
+ * @tparam Expression Type of the @ref expression_.
+ * @param expr Expression to evaluate.
+ * @return A @ref parallel_expression for @p expr.
+ */
+template<Deferred Expression>
+[[nodiscard]] auto par_(Expression&& expr)
+{
+  return par_(default_thread_pool(), std::forward<Expression>(expr));
+}
+
+} // namespace deferred
+
+#endif
@@ -0,0 +1,476 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_PROFILE_HPP
+#define DEFERRED_PROFILE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "conditional.hpp"
+#include "detail/node_label.hpp"
+#include "evaluate.hpp"
+#include "expression.hpp"
+#include "switch.hpp"
+#include "transform.hpp"
+#include "type_traits/is_pure_expression.hpp"
+
+namespace deferred {
+
+/**
+ * @brief Statistics of a node of a profiled expression.
+ *
+ * Times are wall-clock times of the node, including the evaluation of its subexpressions.
+ */
+struct node_statistics
+{
+  /// @brief Number of evaluations.
+  std::uint64_t calls{};
+  /// @brief Cumulative time of all evaluations.
+  std::chrono::nanoseconds total{};
+  /// @brief Time of the slowest evaluation.
+  std::chrono::nanoseconds max{};
+};
+
+/**
+ * @brief Entry of the report of @ref profile_report().
+ */
+struct node_profile
+{
+  /**
+   * @brief Label of the node: its operator, @c if_, @c switch_, @c while_, or its type. It is
+   * stored for the duration of the program.
+   */
+  std::string_view name;
+  /// @brief Nesting level of the node, as passed to the visitors of the expression.
+  std::size_t nesting{};
+  /// @brief Statistics of the node.
+  node_statistics statistics;
+  /**
+   * @brief For @ref conditional_expression and @ref switch_expression nodes, number of times each
+   * branch or case was taken in declaration order; the last element is the @c else or @c default.
+   * Empty for other nodes.
+   */
+  std::vector<std::uint64_t> hits;
+};
+
+namespace detail {
+
+/**
+ * @brief Expression that counts the evaluations of @p Expression.
+ *
+ * It is used for the branches of profiled @ref conditional_expression and @ref switch_expression
+ * nodes. It is transparent to visitors.
+ */
+template<Deferred Expression>
+class hit_counter
+{
+public:
+  using subexpression_types = std::tuple<Expression>;
+
+private:
+  [[no_unique_address]] Expression m_expression;
+  mutable std::uint64_t m_hits{};
+
+public:
+  template<typename E>
+  constexpr explicit hit_counter(E&& e) : m_expression(std::forward<E>(e))
+  { }
+
+  /// @brief Returns the number of evaluations.
+  [[nodiscard]] constexpr std::uint64_t hits() const noexcept
+  {
+    return m_hits;
+  }
+
+  [[nodiscard]] constexpr decltype(auto) operator()() const&
+  {
+    ++m_hits;
+    return m_expression();
+  }
+
+  [[nodiscard]] constexpr decltype(auto) operator()() &&
+  {
+    ++m_hits;
+    return std::forward<Expression>(m_expression)();
+  }
+
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    m_expression.visit(std::forward<Visitor>(v), nesting);
+  }
+};
+
+/// @brief Returns a copy of @p node, in which branches count how many times they are taken.
+template<typename Node>
+[[nodiscard]] constexpr Node count_hits(Node const& node)
+{
+  return node;
+}
+
+/// @brief Specialization for @ref conditional_expression.
+template<typename Else, typename... Branches>
+[[nodiscard]] constexpr auto count_hits(conditional_expression<Else, Branches...> const& e)
+{
+  auto count_branch = []<typename Branch>(Branch const& branch) {
+    using condition_type = typename Branch::condition_type;
+    using then_type      = typename Branch::then_type;
+    return conditional_branch<condition_type, hit_counter<then_type>>{
+      static_cast<condition_type>(branch.condition), hit_counter<then_type>(branch.then)};
+  };
+  return flat_apply(
+    [&](auto const&... branches) {
+      using branches_type = flat_tuple<decltype(count_branch(branches))...>;
+      if constexpr (!conditional_expression<Else, Branches...>::finalized)
+      {
+        return conditional_expression<no_else<>, decltype(count_branch(branches))...>(
+          branches_type(std::in_place, count_branch(branches)...));
+      }
+      else
+      {
+        return conditional_expression<hit_counter<Else>, decltype(count_branch(branches))...>(
+          branches_type(std::in_place, count_branch(branches)...),
+          hit_counter<Else>(e.else_branch()));
+      }
+    },
+    e.branches());
+}
+
+/// @brief Specialization for @ref switch_expression.
+template<typename Condition, typename Default, typename... Cases>
+[[nodiscard]] constexpr auto count_hits(switch_expression<Condition, Default, Cases...> const& e)
+{
+  using default_body_type = typename Default::body_type;
+  using default_type      = default_expression<hit_counter<default_body_type>>;
+  auto count_case         = []<typename Case>(Case const& c) {
+    using label_type = typename Case::label_expression_type;
+    using body_type  = typename Case::body_expression_type;
+    return case_expression<label_type, hit_counter<body_type>>(static_cast<label_type>(c.label()),
+                                                               hit_counter<body_type>(c.body()));
+  };
+  return flat_apply(
+    [&](auto const& df, auto const&... cases) {
+      return switch_expression<Condition, default_type, decltype(count_case(cases))...>(
+        static_cast<Condition>(e.condition()),
+        default_type(hit_counter<default_body_type>(df.body())),
+        count_case(cases)...);
+    },
+    e.cases());
+}
+
+/// @brief Returns the number of evaluations of each branch of @p node.
+template<typename Node>
+[[nodiscard]] std::vector<std::uint64_t> branch_hits(Node const&, std::uint64_t)
+{
+  return {};
+}
+
+/// @brief Specialization for @ref conditional_expression.
+template<typename Else, typename... Branches>
+[[nodiscard]] std::vector<std::uint64_t>
+branch_hits(conditional_expression<Else, Branches...> const& e, std::uint64_t calls)
+{
+  auto hits = flat_apply(
+    [](auto const&... branches) {
+      return std::vector<std::uint64_t>{branches.then.hits()...};
+    },
+    e.branches());
+  if constexpr (!conditional_expression<Else, Branches...>::finalized)
+  {
+    // evaluations in which no condition is true
+    std::uint64_t taken = 0;
+    for (auto const h : hits)
+    {
+      taken += h;
+    }
+    hits.push_back(calls - taken);
+  }
+  else
+  {
+    hits.push_back(e.else_branch().hits());
+  }
+  return hits;
+}
+
+/// @brief Specialization for @ref switch_expression.
+template<typename Condition, typename Default, typename... Cases>
+[[nodiscard]] std::vector<std::uint64_t>
+branch_hits(switch_expression<Condition, Default, Cases...> const& e, std::uint64_t)
+{
+  return flat_apply(
+    [](auto const& df, auto const&... cases) {
+      return std::vector<std::uint64_t>{cases.body().hits()..., df.body().hits()};
+    },
+    e.cases());
+}
+
+/// @brief Records the time of an evaluation in @ref node_statistics when it is destroyed.
+class profile_scope
+{
+  using clock = std::chrono::steady_clock;
+
+  node_statistics& m_statistics;
+  clock::time_point m_start{clock::now()};
+
+public:
+  explicit profile_scope(node_statistics& statistics) noexcept : m_statistics(statistics)
+  { }
+
+  profile_scope(profile_scope const&)            = delete;
+  profile_scope& operator=(profile_scope const&) = delete;
+
+  ~profile_scope()
+  {
+    auto const elapsed =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - m_start);
+    ++m_statistics.calls;
+    m_statistics.total += elapsed;
+    m_statistics.max = std::max(m_statistics.max, elapsed);
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Deferred expression that records the @ref node_statistics of @p Expression.
+ *
+ * It is created by @ref profiled_() for each @ref expression_, @ref logical_expression,
+ * @ref conditional_expression, @ref switch_expression, and @ref while_expression node of an
+ * expression. Visitors visit @p Expression with the same nesting level as the profiled
+ * expression, so that nesting levels are those of the original expression.
+ *
+ * The statistics are updated during evaluation, therefore the expression must not be evaluated
+ * concurrently.
+ *
+ * @tparam Expression Type of the expression.
+ */
+template<Deferred Expression>
+class profiled_expression
+{
+public:
+  using expression_type     = Expression;
+  using subexpression_types = std::tuple<Expression>;
+
+private:
+  Expression m_expression;
+  mutable node_statistics m_statistics;
+
+public:
+  /**
+   * @brief Constructs a profiled_expression.
+   * @tparam E Type of the expression.
+   * @param e Expression to profile.
+   */
+  template<typename E>
+  constexpr explicit profiled_expression(E&& e) : m_expression(std::forward<E>(e))
+  { }
+
+  /// @brief Returns the profiled expression.
+  [[nodiscard]] constexpr Expression const& expression() const noexcept
+  {
+    return m_expression;
+  }
+
+  /// @brief Returns the statistics since construction or the last @ref reset().
+  [[nodiscard]] constexpr node_statistics const& statistics() const noexcept
+  {
+    return m_statistics;
+  }
+
+  /**
+   * @brief Returns the number of times each branch or case was taken.
+   * @see node_profile::hits
+   */
+  [[nodiscard]] std::vector<std::uint64_t> hits() const
+  {
+    return detail::branch_hits(m_expression, m_statistics.calls);
+  }
+
+  /// @brief Resets the statistics of this node.
+  constexpr void reset() const noexcept
+  {
+    m_statistics = {};
+  }
+
+  /**
+   * @brief Evaluates the expression and records the time it takes.
+   * @return Result of the expression.
+   */
+  [[nodiscard]] decltype(auto) operator()() const&
+  {
+    detail::profile_scope scope(m_statistics);
+    return m_expression();
+  }
+
+  /// @copydoc operator()() const&
+  [[nodiscard]] decltype(auto) operator()() &&
+  {
+    detail::profile_scope scope(m_statistics);
+    return std::forward<Expression>(m_expression)();
+  }
+
+  /**
+   * @brief Visits the profiled expression with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    m_expression.visit(std::forward<Visitor>(v), nesting);
+  }
+};
+
+/// @brief Specialization for @ref profiled_expression, which records statistics.
+template<typename Expression>
+struct is_stateful_expression<profiled_expression<Expression>> : public std::true_type
+{ };
+
+/// @brief Specialization for @ref detail::hit_counter, which counts evaluations.
+template<typename Expression>
+struct is_stateful_expression<detail::hit_counter<Expression>> : public std::true_type
+{ };
+
+namespace detail {
+
+/// @brief Checks if @p T is a @ref profiled_expression.
+template<typename T>
+inline constexpr bool is_profiled_expression_v = false;
+
+/// @brief Specialization for @ref profiled_expression.
+template<typename Expression>
+inline constexpr bool is_profiled_expression_v<profiled_expression<Expression>> = true;
+
+/// @brief Rule of @ref transform that wraps nodes in a @ref profiled_expression.
+struct profile_rule
+{
+  template<typename Node>
+    requires is_rebuildable_v<Node>
+  constexpr auto operator()(Node const& node) const
+  {
+    using counted_type = decltype(count_hits(node));
+    return profiled_expression<counted_type>(count_hits(node));
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Creates a copy of @p expr in which each node is profiled.
+ *
+ * Each @ref expression_, @ref logical_expression, @ref conditional_expression,
+ * @ref switch_expression, and @ref while_expression node is wrapped in a
+ * @ref profiled_expression that records the number of evaluations and the cumulative and maximum
+ * time of the node; branches and cases also count how many times they are taken. Variables and
+ * constants are not profiled, as they are not evaluated separately from their parents. The
+ * statistics are collected with @ref profile_report().
+ *
+ * If @c DEFERRED_DISABLE_PROFILING is defined, @p expr is returned as it is and profiling adds no
+ * overhead.
+ *
+ * Example:
+ * @code
+ * auto ex = profiled_(if_(x > 0, x * 2).else_(x + 1));
+ * ex();
+ * for (auto const& node : profile_report(ex))
+ * {
+ *   print(std::string(node.nesting, ' '), node.name, node.statistics.calls);
+ * }
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to profile.
+ * @return The profiled expression.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr decltype(auto) profiled_(Expression&& expr)
+{
+#ifdef DEFERRED_DISABLE_PROFILING
+  return static_cast<make_deferred_t<Expression>>(std::forward<Expression>(expr));
+#else
+  return transform(std::forward<Expression>(expr), detail::profile_rule{});
+#endif
+}
+
+/**
+ * @brief Returns the statistics of the profiled nodes of @p expr.
+ *
+ * The nodes are in the order they are visited, i.e., each node is followed by its subexpressions,
+ * and have the nesting level they are visited with, so that the result can be printed as a tree.
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression created with @ref profiled_().
+ * @return A @ref node_profile for each profiled node, or an empty vector if there are none.
+ */
+template<Deferred Expression>
+[[nodiscard]] std::vector<node_profile> profile_report(Expression const& expr)
+{
+  std::vector<node_profile> report;
+  expr.visit([&report]<typename Node>(Node const& node, std::size_t nesting) {
+    if constexpr (detail::is_profiled_expression_v<Node>)
+    {
+      report.push_back({detail::node_label_v<typename Node::expression_type>,
+                        nesting,
+                        node.statistics(),
+                        node.hits()});
+    }
+  });
+  return report;
+}
+
+/// @brief Resets the statistics of the profiled nodes of @p expr.
+template<Deferred Expression>
+constexpr void profile_reset(Expression const& expr)
+{
+  expr.visit([]<typename Node>(Node const& node, std::size_t) {
+    if constexpr (detail::is_profiled_expression_v<Node>)
+    {
+      node.reset();
+    }
+  });
+}
+
+/**
+ * @brief Evaluates a profiled copy of @p expr and stores its statistics in @p report.
+ *
+ * Example:
+ * @code
+ * std::vector<node_profile> report;
+ * auto result = evaluate_profiled(ex, report);
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to evaluate.
+ * @param report Output for the result of @ref profile_report().
+ * @return The result of evaluating @p expr.
+ */
+template<Deferred Expression>
+auto evaluate_profiled(Expression&& expr, std::vector<node_profile>& report)
+{
+  decltype(auto) profiled = profiled_(std::forward<Expression>(expr));
+  if constexpr (std::is_void_v<decltype(evaluate(profiled))>)
+  {
+    evaluate(profiled);
+    report = profile_report(profiled);
+  }
+  else
+  {
+    auto result = evaluate(profiled);
+    report      = profile_report(profiled);
+    return result;
+  }
+}
+
+} // namespace deferred
+
+#endif
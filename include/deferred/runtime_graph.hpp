@@ -0,0 +1,991 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_RUNTIME_GRAPH_HPP
+#define DEFERRED_RUNTIME_GRAPH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "variable.hpp"
+
+#if !defined(DEFERRED_DISABLE_COMPUTED_GOTO) && (defined(__GNUC__) || defined(__clang__))
+/// @brief Defined if the interpreter of @ref runtime_program dispatches with computed gotos.
+#  define DEFERRED_COMPUTED_GOTO 1
+#endif
+
+namespace deferred {
+
+/**
+ * @brief Operators of a @ref runtime_graph.
+ *
+ * They are the operators of @c operators.hpp and are named after the function objects of
+ * @c <functional>.
+ */
+enum class runtime_operator : std::uint8_t
+{
+  plus,
+  minus,
+  unary_plus,
+  negate,
+  multiplies,
+  divides,
+  modulus,
+  pre_increment,
+  post_increment,
+  pre_decrement,
+  post_decrement,
+  equal_to,
+  not_equal_to,
+  greater,
+  less,
+  greater_equal,
+  less_equal,
+  logical_and,
+  logical_or,
+  logical_not,
+  bit_and,
+  bit_or,
+  bit_xor,
+  bit_not,
+  shift_left,
+  shift_right
+};
+
+/**
+ * @brief Handle to a node of a @ref runtime_graph.
+ */
+struct runtime_node
+{
+  /// @brief Index of the node in its graph.
+  std::uint32_t id;
+};
+
+/**
+ * @brief Variables that the variable nodes of a @ref runtime_graph are bound to, by name.
+ * @tparam T Type of the values.
+ */
+template<typename T>
+using runtime_bindings = std::map<std::string, variable_<T>*, std::less<>>;
+
+template<typename T>
+class runtime_program;
+
+namespace detail {
+
+/// @brief Instructions of a @ref runtime_program.
+enum class runtime_opcode : std::uint8_t
+{
+  // r[dst] = r[a]
+  move,
+  // r[dst] = variable a
+  load,
+  // r[dst] = ++variable a, r[dst] = variable a++, ...
+  pre_increment,
+  post_increment,
+  pre_decrement,
+  post_decrement,
+  // r[dst] = r[a] op r[b]
+  plus,
+  minus,
+  multiplies,
+  divides,
+  modulus,
+  equal_to,
+  not_equal_to,
+  greater,
+  less,
+  greater_equal,
+  less_equal,
+  bit_and,
+  bit_or,
+  bit_xor,
+  shift_left,
+  shift_right,
+  // r[dst] = op r[a]
+  negate,
+  logical_not,
+  bit_not,
+  // r[dst] = bool(r[a])
+  test,
+  // goto a
+  jump,
+  // if (!r[a]) goto b
+  jump_if_false,
+  // if (r[a]) goto b
+  jump_if_true,
+  // if (r[a] != r[b]) goto dst
+  jump_if_not_equal,
+  // return r[a]
+  ret
+};
+
+/// @brief Number of opcodes.
+inline constexpr std::size_t runtime_opcode_count =
+  static_cast<std::size_t>(runtime_opcode::ret) + 1;
+
+/// @brief Instruction of a @ref runtime_program with up to three register or slot operands.
+struct runtime_instruction
+{
+  runtime_opcode op;
+  std::uint32_t dst;
+  std::uint32_t a;
+  std::uint32_t b;
+};
+
+/// @brief Checks if @p op is an operator with one operand.
+[[nodiscard]] constexpr bool is_unary(runtime_operator op) noexcept
+{
+  switch (op)
+  {
+    case runtime_operator::unary_plus:
+    case runtime_operator::negate:
+    case runtime_operator::pre_increment:
+    case runtime_operator::post_increment:
+    case runtime_operator::pre_decrement:
+    case runtime_operator::post_decrement:
+    case runtime_operator::logical_not:
+    case runtime_operator::bit_not:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// @brief Checks if @p op modifies its operand, which must be a variable.
+[[nodiscard]] constexpr bool is_modifying(runtime_operator op) noexcept
+{
+  return op == runtime_operator::pre_increment || op == runtime_operator::post_increment
+         || op == runtime_operator::pre_decrement || op == runtime_operator::post_decrement;
+}
+
+/// @brief Checks if @p op requires integral operands.
+[[nodiscard]] constexpr bool is_integral_only(runtime_operator op) noexcept
+{
+  return op == runtime_operator::modulus || op == runtime_operator::bit_and
+         || op == runtime_operator::bit_or || op == runtime_operator::bit_xor
+         || op == runtime_operator::bit_not || op == runtime_operator::shift_left
+         || op == runtime_operator::shift_right;
+}
+
+/// @brief Returns the opcode that implements @p op, if it is not a short-circuit operator.
+[[nodiscard]] constexpr runtime_opcode to_opcode(runtime_operator op) noexcept
+{
+  switch (op)
+  {
+    case runtime_operator::minus:
+      return runtime_opcode::minus;
+    case runtime_operator::negate:
+      return runtime_opcode::negate;
+    case runtime_operator::multiplies:
+      return runtime_opcode::multiplies;
+    case runtime_operator::divides:
+      return runtime_opcode::divides;
+    case runtime_operator::modulus:
+      return runtime_opcode::modulus;
+    case runtime_operator::pre_increment:
+      return runtime_opcode::pre_increment;
+    case runtime_operator::post_increment:
+      return runtime_opcode::post_increment;
+    case runtime_operator::pre_decrement:
+      return runtime_opcode::pre_decrement;
+    case runtime_operator::post_decrement:
+      return runtime_opcode::post_decrement;
+    case runtime_operator::equal_to:
+      return runtime_opcode::equal_to;
+    case runtime_operator::not_equal_to:
+      return runtime_opcode::not_equal_to;
+    case runtime_operator::greater:
+      return runtime_opcode::greater;
+    case runtime_operator::less:
+      return runtime_opcode::less;
+    case runtime_operator::greater_equal:
+      return runtime_opcode::greater_equal;
+    case runtime_operator::less_equal:
+      return runtime_opcode::less_equal;
+    case runtime_operator::logical_not:
+      return runtime_opcode::logical_not;
+    case runtime_operator::bit_and:
+      return runtime_opcode::bit_and;
+    case runtime_operator::bit_or:
+      return runtime_opcode::bit_or;
+    case runtime_operator::bit_xor:
+      return runtime_opcode::bit_xor;
+    case runtime_operator::bit_not:
+      return runtime_opcode::bit_not;
+    case runtime_operator::shift_left:
+      return runtime_opcode::shift_left;
+    case runtime_operator::shift_right:
+      return runtime_opcode::shift_right;
+    default:
+      return runtime_opcode::plus;
+  }
+}
+
+template<typename T>
+class runtime_compiler;
+
+} // namespace detail
+
+/**
+ * @brief Expression graph that is constructed at runtime, e.g., from a configuration file.
+ *
+ * Nodes are constants, named variables, the operators of @c operators.hpp (see
+ * @ref runtime_operator), @c if_, @c switch_, and @c while_. All nodes have values of type @p T;
+ * comparisons and logical operators return @c 1 or @c 0, and @c while_ returns <tt>T{}</tt>.
+ * Operands have to be added before the nodes that use them, therefore the graph is acyclic, and
+ * they can be shared between nodes.
+ *
+ * A graph is not evaluated directly; @ref compile() translates it to a @ref runtime_program.
+ *
+ * Example:
+ * @code
+ * runtime_graph<int> g;
+ * auto x  = g.variable("x");
+ * auto ex = g.operation(runtime_operator::plus, x, g.constant(1));
+ * auto x_ = variable(41);
+ * auto p  = g.compile(ex, {{"x", &x_}});
+ * p(); // 42
+ * @endcode
+ *
+ * @tparam T Type of the values; an arithmetic type other than @c bool.
+ */
+template<typename T>
+class runtime_graph
+{
+  static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                "runtime_graph requires an arithmetic type other than bool");
+
+  friend class detail::runtime_compiler<T>;
+
+public:
+  using value_type = T;
+
+  /// @brief Kinds of nodes.
+  enum class node_kind : std::uint8_t
+  {
+    constant,
+    variable,
+    operation,
+    if_,
+    switch_,
+    while_
+  };
+
+  /// @brief Node of the graph.
+  struct node_type
+  {
+    node_kind kind;
+    /// @brief Operator of an operation node.
+    runtime_operator op{};
+    /// @brief Value of a constant node.
+    T value{};
+    /// @brief Name of a variable node.
+    std::string name;
+    /**
+     * @brief Operands in evaluation order.
+     *
+     * They are the condition, then, and else of @c if_, the condition and body of @c while_, and
+     * the condition, default, and case bodies of @c switch_.
+     */
+    std::vector<std::uint32_t> operands;
+    /// @brief Labels of the cases of a @c switch_.
+    std::vector<T> labels;
+  };
+
+private:
+  std::vector<node_type> m_nodes;
+
+  void check(runtime_node n) const
+  {
+    if (n.id >= m_nodes.size())
+    {
+      throw std::invalid_argument("deferred::runtime_graph: node does not exist");
+    }
+  }
+
+  runtime_node add(node_type&& n)
+  {
+    for (auto const operand : n.operands)
+    {
+      check(runtime_node{operand});
+    }
+    m_nodes.push_back(std::move(n));
+    return runtime_node{static_cast<std::uint32_t>(m_nodes.size() - 1)};
+  }
+
+public:
+  /// @brief Returns the number of nodes.
+  [[nodiscard]] std::size_t size() const noexcept
+  {
+    return m_nodes.size();
+  }
+
+  /// @brief Returns the node @p n.
+  [[nodiscard]] node_type const& operator[](runtime_node n) const
+  {
+    check(n);
+    return m_nodes[n.id];
+  }
+
+  /**
+   * @brief Adds a constant.
+   * @param value Value of the constant.
+   * @return The new node.
+   */
+  runtime_node constant(T value)
+  {
+    return add(node_type{node_kind::constant, {}, value, {}, {}, {}});
+  }
+
+  /**
+   * @brief Adds a variable that is bound by name when the graph is compiled.
+   *
+   * Variables with the same name are bound to the same @ref variable_.
+   *
+   * @param name Name of the variable.
+   * @return The new node.
+   */
+  runtime_node variable(std::string_view name)
+  {
+    return add(node_type{node_kind::variable, {}, T{}, std::string(name), {}, {}});
+  }
+
+  /**
+   * @brief Adds an operation with one operand.
+   * @param op Operator; increment and decrement require a variable operand.
+   * @param operand Operand.
+   * @return The new node.
+   * @throws std::invalid_argument if @p op does not take one operand or @p operand is invalid.
+   */
+  runtime_node operation(runtime_operator op, runtime_node operand)
+  {
+    if (!detail::is_unary(op))
+    {
+      throw std::invalid_argument("deferred::runtime_graph: operator is not unary");
+    }
+    if (detail::is_integral_only(op) && !std::is_integral_v<T>)
+    {
+      throw std::invalid_argument("deferred::runtime_graph: operator requires integral values");
+    }
+    if (detail::is_modifying(op) && (*this)[operand].kind != node_kind::variable)
+    {
+      throw std::invalid_argument("deferred::runtime_graph: operand is not a variable");
+    }
+    return add(node_type{node_kind::operation, op, T{}, {}, {operand.id}, {}});
+  }
+
+  /**
+   * @brief Adds an operation with two operands.
+   *
+   * The right operand of @c logical_and and @c logical_or is only evaluated if needed.
+   *
+   * @param op Operator.
+   * @param lhs Left operand.
+   * @param rhs Right operand.
+   * @return The new node.
+   * @throws std::invalid_argument if @p op does not take two operands or an operand is invalid.
+   */
+  runtime_node operation(runtime_operator op, runtime_node lhs, runtime_node rhs)
+  {
+    if (detail::is_unary(op))
+    {
+      throw std::invalid_argument("deferred::runtime_graph: operator is not binary");
+    }
+    if (detail::is_integral_only(op) && !std::is_integral_v<T>)
+    {
+      throw std::invalid_argument("deferred::runtime_graph: operator requires integral values");
+    }
+    return add(node_type{node_kind::operation, op, T{}, {}, {lhs.id, rhs.id}, {}});
+  }
+
+  /**
+   * @brief Adds a conditional that returns @p then_ if @p condition is non-zero, otherwise
+   * @p else_.
+   * @param condition Condition.
+   * @param then_ Node to evaluate if the condition is non-zero.
+   * @param else_ Node to evaluate otherwise.
+   * @return The new node.
+   */
+  runtime_node if_(runtime_node condition, runtime_node then_, runtime_node else_)
+  {
+    return add(node_type{node_kind::if_, {}, T{}, {}, {condition.id, then_.id, else_.id}, {}});
+  }
+
+  /**
+   * @brief Adds a switch that returns the body of the first case whose label is equal to
+   * @p condition, otherwise @p default_.
+   * @tparam Cases Type of the range of (label, body) pairs.
+   * @param condition Condition.
+   * @param cases Range of (label, body) pairs.
+   * @param default_ Node to evaluate if no label is equal to the condition.
+   * @return The new node.
+   */
+  template<std::ranges::input_range Cases>
+  runtime_node switch_(runtime_node condition, Cases&& cases, runtime_node default_)
+  {
+    node_type n{node_kind::switch_, {}, T{}, {}, {condition.id, default_.id}, {}};
+    for (auto&& [label, body] : cases)
+    {
+      n.labels.push_back(static_cast<T>(label));
+      n.operands.push_back(runtime_node(body).id);
+    }
+    return add(std::move(n));
+  }
+
+  /// @copydoc switch_
+  runtime_node switch_(runtime_node condition,
+                       std::initializer_list<std::pair<T, runtime_node>> cases,
+                       runtime_node default_)
+  {
+    return switch_<std::initializer_list<std::pair<T, runtime_node>>&>(condition, cases, default_);
+  }
+
+  /**
+   * @brief Adds a loop that evaluates @p body while @p condition is non-zero.
+   * @param condition Condition.
+   * @param body Body.
+   * @return The new node, whose value is <tt>T{}</tt>.
+   */
+  runtime_node while_(runtime_node condition, runtime_node body)
+  {
+    return add(node_type{node_kind::while_, {}, T{}, {}, {condition.id, body.id}, {}});
+  }
+
+  /**
+   * @brief Compiles the subgraph of @p root to a @ref runtime_program.
+   *
+   * Variables are resolved to slots that refer to the variables in @p bindings.
+   *
+   * @param root Node that the program returns the value of.
+   * @param bindings Variables by name.
+   * @return A program that evaluates @p root.
+   * @throws std::invalid_argument if @p root is invalid or a variable is not in @p bindings.
+   */
+  [[nodiscard]] runtime_program<T> compile(runtime_node root,
+                                           runtime_bindings<T> const& bindings) const;
+};
+
+/**
+ * @brief Register-based bytecode that is compiled from a @ref runtime_graph.
+ *
+ * Every value is stored in its own register; constants are loaded into their registers once.
+ * The program is a deferred expression that returns @p T and can be a subexpression of other
+ * expressions.
+ *
+ * Registers are reused between evaluations, therefore the program must not be evaluated
+ * concurrently.
+ *
+ * @tparam T Type of the values.
+ */
+template<typename T>
+class runtime_program
+{
+  friend class detail::runtime_compiler<T>;
+
+public:
+  using result_type         = T;
+  using subexpression_types = void;
+
+private:
+  std::vector<detail::runtime_instruction> m_code;
+  std::vector<variable_<T>*> m_slots;
+  mutable std::vector<T> m_registers;
+
+  runtime_program() = default;
+
+public:
+  /// @brief Returns the number of instructions.
+  [[nodiscard]] std::size_t instruction_count() const noexcept
+  {
+    return m_code.size();
+  }
+
+  /// @brief Returns the number of registers.
+  [[nodiscard]] std::size_t register_count() const noexcept
+  {
+    return m_registers.size();
+  }
+
+  /**
+   * @brief Evaluates the program.
+   * @return Value of the root node.
+   */
+  T operator()() const;
+
+  /**
+   * @brief Visits the program with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+  }
+};
+
+namespace detail {
+
+/**
+ * @brief Translates a @ref runtime_graph to a @ref runtime_program.
+ *
+ * Nodes are emitted in evaluation order. The register of a node is reused by later uses of the
+ * node, unless it has side effects or its code may not have run (e.g., it is in a branch or a
+ * loop).
+ */
+template<typename T>
+class runtime_compiler
+{
+  using graph_type = runtime_graph<T>;
+  using node_kind  = typename graph_type::node_kind;
+
+  static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+  graph_type const& m_graph;
+  runtime_bindings<T> const& m_bindings;
+  runtime_program<T> m_program;
+  std::vector<std::uint32_t> m_constants;
+  std::vector<std::uint32_t> m_registers;
+  std::map<std::string_view, std::uint32_t> m_slots;
+  // incremented whenever registers of nodes may have become stale
+  std::size_t m_generation = 0;
+
+  std::uint32_t allocate(T value = T{})
+  {
+    m_program.m_registers.push_back(value);
+    return static_cast<std::uint32_t>(m_program.m_registers.size() - 1);
+  }
+
+  std::size_t emit(runtime_opcode op, std::uint32_t dst, std::uint32_t a = 0, std::uint32_t b = 0)
+  {
+    m_program.m_code.push_back(runtime_instruction{op, dst, a, b});
+    return m_program.m_code.size() - 1;
+  }
+
+  [[nodiscard]] std::uint32_t here() const noexcept
+  {
+    return static_cast<std::uint32_t>(m_program.m_code.size());
+  }
+
+  void invalidate()
+  {
+    std::ranges::fill(m_registers, none);
+    ++m_generation;
+  }
+
+  // compiles a node whose code may not run; returns true if it may have made registers stale
+  template<typename F>
+  bool conditionally(F&& f)
+  {
+    auto saved            = m_registers;
+    auto const generation = m_generation;
+    std::forward<F>(f)();
+    m_registers = std::move(saved);
+    return m_generation != generation;
+  }
+
+  std::uint32_t slot(std::string const& name)
+  {
+    if (auto const it = m_slots.find(name); it != m_slots.end())
+    {
+      return it->second;
+    }
+    auto const it = m_bindings.find(name);
+    if (it == m_bindings.end() || it->second == nullptr)
+    {
+      throw std::invalid_argument("deferred::runtime_graph: unbound variable " + name);
+    }
+    m_program.m_slots.push_back(it->second);
+    auto const s = static_cast<std::uint32_t>(m_program.m_slots.size() - 1);
+    m_slots.emplace(name, s);
+    return s;
+  }
+
+  std::uint32_t compile_operation(typename graph_type::node_type const& n)
+  {
+    if (n.op == runtime_operator::unary_plus)
+    {
+      return compile(n.operands[0]);
+    }
+    if (is_modifying(n.op))
+    {
+      auto const s   = slot(m_graph.m_nodes[n.operands[0]].name);
+      auto const dst = allocate();
+      emit(to_opcode(n.op), dst, s);
+      invalidate();
+      return dst;
+    }
+    if (n.op == runtime_operator::logical_and || n.op == runtime_operator::logical_or)
+    {
+      // the right operand is skipped if the left operand determines the result
+      auto const dst = allocate();
+      emit(runtime_opcode::test, dst, compile(n.operands[0]));
+      auto const skip = emit(n.op == runtime_operator::logical_and ? runtime_opcode::jump_if_false
+                                                                   : runtime_opcode::jump_if_true,
+                             0,
+                             dst);
+      auto const stale =
+        conditionally([&] { emit(runtime_opcode::test, dst, compile(n.operands[1])); });
+      m_program.m_code[skip].b = here();
+      if (stale)
+      {
+        invalidate();
+      }
+      return dst;
+    }
+    if (n.operands.size() == 1)
+    {
+      auto const a   = compile(n.operands[0]);
+      auto const dst = allocate();
+      emit(to_opcode(n.op), dst, a);
+      return dst;
+    }
+    auto const a   = compile(n.operands[0]);
+    auto const b   = compile(n.operands[1]);
+    auto const dst = allocate();
+    emit(to_opcode(n.op), dst, a, b);
+    return dst;
+  }
+
+  std::uint32_t compile_if(typename graph_type::node_type const& n)
+  {
+    auto const condition = compile(n.operands[0]);
+    auto const dst       = allocate();
+    auto const to_else   = emit(runtime_opcode::jump_if_false, 0, condition);
+    std::size_t to_end   = 0;
+    auto const then_     = conditionally([&] {
+      emit(runtime_opcode::move, dst, compile(n.operands[1]));
+      to_end = emit(runtime_opcode::jump, 0);
+    });
+    m_program.m_code[to_else].b = here();
+    auto const else_ =
+      conditionally([&] { emit(runtime_opcode::move, dst, compile(n.operands[2])); });
+    m_program.m_code[to_end].a = here();
+    if (then_ || else_)
+    {
+      invalidate();
+    }
+    return dst;
+  }
+
+  std::uint32_t compile_switch(typename graph_type::node_type const& n)
+  {
+    auto const condition = compile(n.operands[0]);
+    auto const dst       = allocate();
+    std::vector<std::size_t> to_end;
+    bool stale = false;
+    for (std::size_t i = 0; i < n.labels.size(); ++i)
+    {
+      auto const label = allocate(n.labels[i]);
+      auto const next  = emit(runtime_opcode::jump_if_not_equal, 0, condition, label);
+      stale |= conditionally([&] {
+        emit(runtime_opcode::move, dst, compile(n.operands[i + 2]));
+        to_end.push_back(emit(runtime_opcode::jump, 0));
+      });
+      m_program.m_code[next].dst = here();
+    }
+    stale |= conditionally([&] { emit(runtime_opcode::move, dst, compile(n.operands[1])); });
+    for (auto const i : to_end)
+    {
+      m_program.m_code[i].a = here();
+    }
+    if (stale)
+    {
+      invalidate();
+    }
+    return dst;
+  }
+
+  std::uint32_t compile_while(typename graph_type::node_type const& n)
+  {
+    // the condition and the body are evaluated repeatedly, so registers from before the loop or
+    // from a previous iteration may be stale
+    invalidate();
+    auto const start = here();
+    auto const exit  = emit(runtime_opcode::jump_if_false, 0, compile(n.operands[0]));
+    conditionally([&] { compile(n.operands[1]); });
+    emit(runtime_opcode::jump, 0, start);
+    m_program.m_code[exit].b = here();
+    invalidate();
+    return allocate();
+  }
+
+public:
+  runtime_compiler(graph_type const& graph, runtime_bindings<T> const& bindings) :
+    m_graph(graph),
+    m_bindings(bindings),
+    m_constants(graph.size(), none),
+    m_registers(graph.size(), none)
+  { }
+
+  /// @brief Emits the code of node @p id and returns the register that holds its value.
+  std::uint32_t compile(std::uint32_t id)
+  {
+    auto const& n = m_graph.m_nodes[id];
+    if (n.kind == node_kind::constant)
+    {
+      if (m_constants[id] == none)
+      {
+        m_constants[id] = allocate(n.value);
+      }
+      return m_constants[id];
+    }
+    if (m_registers[id] != none)
+    {
+      return m_registers[id];
+    }
+    auto const generation = m_generation;
+    std::uint32_t r       = none;
+    switch (n.kind)
+    {
+      case node_kind::variable:
+        r = allocate();
+        emit(runtime_opcode::load, r, slot(n.name));
+        break;
+      case node_kind::operation:
+        r = compile_operation(n);
+        break;
+      case node_kind::if_:
+        r = compile_if(n);
+        break;
+      case node_kind::switch_:
+        r = compile_switch(n);
+        break;
+      default:
+        r = compile_while(n);
+        break;
+    }
+    if (m_generation == generation)
+    {
+      // nodes with side effects are evaluated again by each use
+      m_registers[id] = r;
+    }
+    return r;
+  }
+
+  /// @brief Returns the program that returns the value of node @p root.
+  runtime_program<T> finish(std::uint32_t root) &&
+  {
+    emit(runtime_opcode::ret, 0, compile(root));
+    return std::move(m_program);
+  }
+};
+
+} // namespace detail
+
+template<typename T>
+runtime_program<T> runtime_graph<T>::compile(runtime_node root,
+                                             runtime_bindings<T> const& bindings) const
+{
+  check(root);
+  return detail::runtime_compiler<T>(*this, bindings).finish(root.id);
+}
+
+#ifdef DEFERRED_COMPUTED_GOTO
+#  if defined(__GNUC__)
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wpedantic"
+#  endif
+#  define DEFERRED_RUNTIME_CASE(name) op_##name:
+#  define DEFERRED_RUNTIME_DISPATCH() goto* s_labels[static_cast<std::size_t>(ip->op)]
+#else
+#  define DEFERRED_RUNTIME_CASE(name) case detail::runtime_opcode::name:
+#  define DEFERRED_RUNTIME_DISPATCH() continue
+#endif
+
+#define DEFERRED_RUNTIME_BINARY(name, expr)                                                        \
+  DEFERRED_RUNTIME_CASE(name)                                                                      \
+  {                                                                                                \
+    [[maybe_unused]] T const a = r[ip->a];                                                         \
+    [[maybe_unused]] T const b = r[ip->b];                                                         \
+    r[ip->dst]                 = static_cast<T>(expr);                                             \
+    ++ip;                                                                                          \
+    DEFERRED_RUNTIME_DISPATCH();                                                                   \
+  }
+
+#define DEFERRED_RUNTIME_INTEGRAL(name, expr)                                                      \
+  DEFERRED_RUNTIME_CASE(name)                                                                      \
+  {                                                                                                \
+    if constexpr (std::is_integral_v<T>)                                                           \
+    {                                                                                              \
+      [[maybe_unused]] T const a = r[ip->a];                                                       \
+      [[maybe_unused]] T const b = r[ip->b];                                                       \
+      r[ip->dst]                 = static_cast<T>(expr);                                           \
+    }                                                                                              \
+    ++ip;                                                                                          \
+    DEFERRED_RUNTIME_DISPATCH();                                                                   \
+  }
+
+template<typename T>
+T runtime_program<T>::operator()() const
+{
+  using detail::runtime_opcode;
+
+  auto const* const code = m_code.data();
+  auto const* ip         = code;
+  auto* const r          = m_registers.data();
+  auto* const* slots     = m_slots.data();
+
+#ifdef DEFERRED_COMPUTED_GOTO
+  // in the order of runtime_opcode
+  static void* const s_labels[] = {&&op_move,
+                                   &&op_load,
+                                   &&op_pre_increment,
+                                   &&op_post_increment,
+                                   &&op_pre_decrement,
+                                   &&op_post_decrement,
+                                   &&op_plus,
+                                   &&op_minus,
+                                   &&op_multiplies,
+                                   &&op_divides,
+                                   &&op_modulus,
+                                   &&op_equal_to,
+                                   &&op_not_equal_to,
+                                   &&op_greater,
+                                   &&op_less,
+                                   &&op_greater_equal,
+                                   &&op_less_equal,
+                                   &&op_bit_and,
+                                   &&op_bit_or,
+                                   &&op_bit_xor,
+                                   &&op_shift_left,
+                                   &&op_shift_right,
+                                   &&op_negate,
+                                   &&op_logical_not,
+                                   &&op_bit_not,
+                                   &&op_test,
+                                   &&op_jump,
+                                   &&op_jump_if_false,
+                                   &&op_jump_if_true,
+                                   &&op_jump_if_not_equal,
+                                   &&op_ret};
+  static_assert(std::size(s_labels) == detail::runtime_opcode_count);
+  DEFERRED_RUNTIME_DISPATCH();
+#else
+  for (;;)
+  {
+    switch (ip->op)
+    {
+#endif
+
+  DEFERRED_RUNTIME_CASE(move)
+  {
+    r[ip->dst] = r[ip->a];
+    ++ip;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_CASE(load)
+  {
+    r[ip->dst] = (*slots[ip->a])();
+    ++ip;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_CASE(pre_increment)
+  {
+    auto& v    = *slots[ip->a];
+    r[ip->dst] = ++v();
+    v.touch();
+    ++ip;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_CASE(post_increment)
+  {
+    auto& v    = *slots[ip->a];
+    r[ip->dst] = v()++;
+    v.touch();
+    ++ip;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_CASE(pre_decrement)
+  {
+    auto& v    = *slots[ip->a];
+    r[ip->dst] = --v();
+    v.touch();
+    ++ip;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_CASE(post_decrement)
+  {
+    auto& v    = *slots[ip->a];
+    r[ip->dst] = v()--;
+    v.touch();
+    ++ip;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_BINARY(plus, a + b)
+  DEFERRED_RUNTIME_BINARY(minus, a - b)
+  DEFERRED_RUNTIME_BINARY(multiplies, a * b)
+  DEFERRED_RUNTIME_BINARY(divides, a / b)
+  DEFERRED_RUNTIME_INTEGRAL(modulus, a % b)
+  DEFERRED_RUNTIME_BINARY(equal_to, a == b)
+  DEFERRED_RUNTIME_BINARY(not_equal_to, a != b)
+  DEFERRED_RUNTIME_BINARY(greater, a > b)
+  DEFERRED_RUNTIME_BINARY(less, a < b)
+  DEFERRED_RUNTIME_BINARY(greater_equal, a >= b)
+  DEFERRED_RUNTIME_BINARY(less_equal, a <= b)
+  DEFERRED_RUNTIME_INTEGRAL(bit_and, a & b)
+  DEFERRED_RUNTIME_INTEGRAL(bit_or, a | b)
+  DEFERRED_RUNTIME_INTEGRAL(bit_xor, a ^ b)
+  DEFERRED_RUNTIME_INTEGRAL(shift_left, a << b)
+  DEFERRED_RUNTIME_INTEGRAL(shift_right, a >> b)
+  DEFERRED_RUNTIME_BINARY(negate, -a)
+  DEFERRED_RUNTIME_BINARY(logical_not, !a)
+  DEFERRED_RUNTIME_INTEGRAL(bit_not, ~a)
+  DEFERRED_RUNTIME_BINARY(test, static_cast<bool>(a))
+  DEFERRED_RUNTIME_CASE(jump)
+  {
+    ip = code + ip->a;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_CASE(jump_if_false)
+  {
+    ip = static_cast<bool>(r[ip->a]) ? ip + 1 : code + ip->b;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_CASE(jump_if_true)
+  {
+    ip = static_cast<bool>(r[ip->a]) ? code + ip->b : ip + 1;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_CASE(jump_if_not_equal)
+  {
+    ip = (r[ip->a] != r[ip->b]) ? code + ip->dst : ip + 1;
+    DEFERRED_RUNTIME_DISPATCH();
+  }
+  DEFERRED_RUNTIME_CASE(ret)
+  {
+    return r[ip->a];
+  }
+
+#ifndef DEFERRED_COMPUTED_GOTO
+    }
+  }
+#endif
+}
+
+#undef DEFERRED_RUNTIME_INTEGRAL
+#undef DEFERRED_RUNTIME_BINARY
+#undef DEFERRED_RUNTIME_DISPATCH
+#undef DEFERRED_RUNTIME_CASE
+
+#if defined(DEFERRED_COMPUTED_GOTO) && defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+
+} // namespace deferred
+
+#endif
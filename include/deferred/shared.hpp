@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_SHARED_HPP
+#define DEFERRED_SHARED_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "evaluate.hpp"
+#include "expression.hpp"
+#include "type_traits/is_pure_expression.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/// Source of unique evaluation epochs across all threads.
+inline std::atomic<std::uint64_t> cse_epoch_source{0};
+
+/// Epoch of the current @ref evaluate_cse on this thread, @c 0 if there is none.
+inline thread_local std::uint64_t cse_epoch = 0;
+
+/**
+ * @brief Sets the evaluation epoch of the current thread to a new one for its lifetime.
+ */
+class cse_scope
+{
+  std::uint64_t m_previous;
+
+public:
+  cse_scope() noexcept :
+    m_previous(
+      std::exchange(cse_epoch, cse_epoch_source.fetch_add(1, std::memory_order_relaxed) + 1))
+  { }
+
+  cse_scope(cse_scope const&)            = delete;
+  cse_scope(cse_scope&&)                 = delete;
+  cse_scope& operator=(cse_scope const&) = delete;
+  cse_scope& operator=(cse_scope&&)      = delete;
+
+  ~cse_scope()
+  {
+    cse_epoch = m_previous;
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Deferred expression that evaluates @p Expression at most once per @ref evaluate_cse.
+ *
+ * When an lvalue @ref shared_expression is referenced from multiple places in an expression tree,
+ * evaluating the tree with @ref evaluate_cse evaluates it once and reuses the result. Outside of
+ * @ref evaluate_cse it is evaluated every time.
+ *
+ * A @ref shared_expression stores its result, therefore it must not be evaluated concurrently from
+ * multiple threads.
+ *
+ * @tparam Expression Type of the shared expression.
+ */
+template<Deferred Expression>
+class shared_expression
+{
+public:
+  using expression_type     = Expression;
+  using subexpression_types = std::tuple<Expression>;
+  using result_type = std::remove_cvref_t<decltype(evaluate(std::declval<Expression const&>()))>;
+
+  static_assert(!std::is_void_v<result_type>, "void expressions cannot be shared");
+
+private:
+  Expression m_expression;
+  mutable std::optional<result_type> m_result;
+  mutable std::uint64_t m_epoch{0};
+
+public:
+  /**
+   * @brief Constructs a shared_expression.
+   * @tparam E Type of the expression.
+   * @param e Expression to share.
+   */
+  template<typename E>
+  constexpr explicit shared_expression(E&& e) : m_expression(std::forward<E>(e))
+  { }
+
+  /**
+   * @brief Evaluates the shared expression.
+   * @return Reference to the result, which is valid until the next evaluation.
+   */
+  [[nodiscard]] constexpr result_type const& operator()() const
+  {
+    if !consteval
+    {
+      if (m_result && detail::cse_epoch != 0 && m_epoch == detail::cse_epoch)
+      {
+        return *m_result;
+      }
+      m_epoch = detail::cse_epoch;
+    }
+    m_result.reset();
+    m_result.emplace(evaluate(m_expression));
+    return *m_result;
+  }
+
+  /**
+   * @brief Visits the shared expression with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    m_expression.visit(std::forward<Visitor>(v), nesting + 1);
+  }
+};
+
+/// @brief Specialization for @ref shared_expression, which stores its result.
+template<typename Expression>
+struct is_stateful_expression<shared_expression<Expression>> : public std::true_type
+{ };
+
+/**
+ * @brief Creates a new @ref shared_expression that is evaluated at most once per
+ * @ref evaluate_cse.
+ *
+ * Example:
+ * @code
+ * auto s = shared_(v * k);
+ * auto e = s + s * s;
+ * evaluate_cse(e); // evaluates v * k once
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to share.
+ * @return A @ref shared_expression for @p expr.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr auto shared_(Expression&& expr)
+{
+  return shared_expression<make_deferred_t<Expression>>(std::forward<Expression>(expr));
+}
+
+/**
+ * @brief Evaluates @p t, evaluating each @ref shared_expression in it at most once.
+ *
+ * Nested calls start a new evaluation, so shared expressions are evaluated again inside them.
+ *
+ * @tparam T The type of the expression to evaluate.
+ * @param t The expression to evaluate.
+ * @return The result of evaluating the expression.
+ */
+template<typename T>
+constexpr auto evaluate_cse(T&& t)
+{
+  if consteval
+  {
+    return evaluate(std::forward<T>(t));
+  }
+  else
+  {
+    detail::cse_scope scope;
+    return evaluate(std::forward<T>(t));
+  }
+}
+
+} // namespace deferred
+
+#endif
@@ -0,0 +1,475 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_SIMD_HPP
+#define DEFERRED_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#if !defined(DEFERRED_DISABLE_SIMD) && (defined(__GNUC__) || defined(__clang__))                 \
+  && (defined(__x86_64__) || defined(__i386__))
+/// @brief Defined if explicit SIMD kernels for x86 are available.
+#  define DEFERRED_SIMD_X86 1
+#endif
+
+namespace deferred {
+
+/**
+ * @brief Instruction set used for element-wise evaluation.
+ */
+enum class simd_isa
+{
+  scalar,
+  sse2,
+  avx2,
+  avx512
+};
+
+/**
+ * @brief Returns the widest instruction set supported by the CPU that the library can use.
+ *
+ * The result is detected once, at the first call. If @c DEFERRED_DISABLE_SIMD is defined or the
+ * target is not x86, then @ref simd_isa::scalar is always returned.
+ */
+[[nodiscard]] inline simd_isa detected_simd_isa() noexcept
+{
+#ifdef DEFERRED_SIMD_X86
+  static simd_isa const isa = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+      return simd_isa::avx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+      return simd_isa::avx2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+      return simd_isa::sse2;
+    }
+    return simd_isa::scalar;
+  }();
+  return isa;
+#else
+  return simd_isa::scalar;
+#endif
+}
+
+/// @brief Returns the register width of @p isa in bytes.
+[[nodiscard]] constexpr std::size_t simd_width(simd_isa isa) noexcept
+{
+  switch (isa)
+  {
+    case simd_isa::sse2:
+      return 16;
+    case simd_isa::avx2:
+      return 32;
+    case simd_isa::avx512:
+      return 64;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief Returns the number of elements of type @p T processed per instruction with @p isa.
+ * @tparam T Element type.
+ * @param isa Instruction set.
+ */
+template<typename T>
+[[nodiscard]] constexpr std::size_t simd_lanes(simd_isa isa) noexcept
+{
+  return isa == simd_isa::scalar ? 1 : simd_width(isa) / sizeof(T);
+}
+
+template<typename Operator>
+struct nary_operator;
+
+namespace detail::simd {
+
+/**
+ * @brief Kind of operation supported by the SIMD kernels.
+ */
+enum class operator_kind
+{
+  none,
+  arithmetic,
+  comparison
+};
+
+/**
+ * @brief Checks if @p T is a @c std functional object that is either @c Op<> or @c Op<U>.
+ */
+template<template<typename> typename Op, typename T>
+inline constexpr bool is_functional_v = false;
+
+/// @brief Specialization for @c Op<U>.
+template<template<typename> typename Op, typename U>
+inline constexpr bool is_functional_v<Op, Op<U>> = true;
+
+/// @brief Specialization for @ref nary_operator, which folds its operands with @c Op<U>.
+template<template<typename> typename Op, typename U>
+inline constexpr bool is_functional_v<Op, nary_operator<Op<U>>> = true;
+
+/**
+ * @brief Returns the kind of @p Op when applied to vectors of @p T.
+ *
+ * Operators that would promote @p T or do not have a SIMD equivalent are not supported.
+ *
+ * @tparam Op Type of the operator.
+ * @tparam T Element type.
+ */
+template<typename Op, typename T>
+consteval operator_kind kind_of()
+{
+  if constexpr (!std::is_arithmetic_v<T> || std::is_same_v<T, bool>)
+  {
+    return operator_kind::none;
+  }
+  else if constexpr (is_functional_v<std::plus, Op> || is_functional_v<std::minus, Op>
+                     || is_functional_v<std::multiplies, Op> || is_functional_v<std::negate, Op>)
+  {
+    return operator_kind::arithmetic;
+  }
+  else if constexpr (is_functional_v<std::divides, Op>)
+  {
+    return std::is_floating_point_v<T> ? operator_kind::arithmetic : operator_kind::none;
+  }
+  else if constexpr (is_functional_v<std::bit_and, Op> || is_functional_v<std::bit_or, Op>
+                     || is_functional_v<std::bit_xor, Op> || is_functional_v<std::bit_not, Op>)
+  {
+    return std::is_integral_v<T> ? operator_kind::arithmetic : operator_kind::none;
+  }
+  else if constexpr (is_functional_v<std::equal_to, Op> || is_functional_v<std::not_equal_to, Op>
+                     || is_functional_v<std::less, Op> || is_functional_v<std::greater, Op>
+                     || is_functional_v<std::less_equal, Op>
+                     || is_functional_v<std::greater_equal, Op>)
+  {
+    return operator_kind::comparison;
+  }
+  else
+  {
+    return operator_kind::none;
+  }
+}
+
+/// @brief Checks if @p Op is an arithmetic operator that can be vectorized for @p T.
+template<typename Op, typename T>
+inline constexpr bool is_arithmetic_v = kind_of<Op, T>() == operator_kind::arithmetic;
+
+/// @brief Checks if @p Op is a comparison that can be vectorized for @p T.
+template<typename Op, typename T>
+inline constexpr bool is_comparison_v = kind_of<Op, T>() == operator_kind::comparison;
+
+#ifdef DEFERRED_SIMD_X86
+
+#  define DEFERRED_SIMD_INLINE [[gnu::always_inline]] inline
+
+// Vectors are always passed by reference: helpers are inlined into functions compiled for
+// different instruction sets, and passing them by value would depend on the caller's ABI.
+
+/**
+ * @brief SIMD vector of @p Bytes bytes with elements of type @p T.
+ */
+template<typename T, std::size_t Bytes>
+struct vector
+{
+  typedef T type __attribute__((vector_size(Bytes), may_alias));
+  /// @brief Mask type for comparisons between vectors of type @ref type.
+  using mask = decltype(type{} < type{});
+};
+
+/// @brief Alias for @ref vector::type.
+template<typename T, std::size_t Bytes>
+using vector_t = typename vector<T, Bytes>::type;
+
+/// @brief Checks if @p p is aligned to @p bytes.
+template<typename T>
+[[nodiscard]] inline bool is_aligned(T const* p, std::size_t bytes) noexcept
+{
+  return reinterpret_cast<std::uintptr_t>(p) % bytes == 0;
+}
+
+/// @brief Loads @p v from @p p, which is aligned to the vector size if @p Aligned is @c true.
+template<bool Aligned, typename V, typename T>
+DEFERRED_SIMD_INLINE void load(V& v, T const* p) noexcept
+{
+  if constexpr (Aligned)
+  {
+    v = *reinterpret_cast<V const*>(p);
+  }
+  else
+  {
+    __builtin_memcpy(&v, p, sizeof(V));
+  }
+}
+
+/// @brief Stores @p v to @p p, which is aligned to the vector size if @p Aligned is @c true.
+template<bool Aligned, typename V, typename T>
+DEFERRED_SIMD_INLINE void store(T* p, V const& v) noexcept
+{
+  if constexpr (Aligned)
+  {
+    *reinterpret_cast<V*>(p) = v;
+  }
+  else
+  {
+    __builtin_memcpy(p, &v, sizeof(V));
+  }
+}
+
+/// @brief Sets all elements of @p v to @p t.
+template<typename V, typename T>
+DEFERRED_SIMD_INLINE void broadcast(V& v, T const& t) noexcept
+{
+  v = V{} + t;
+}
+
+/// @brief Applies the unary operator @p Op to @p v.
+template<typename Op, typename V>
+DEFERRED_SIMD_INLINE void apply(Op const&, V& v) noexcept
+{
+  if constexpr (is_functional_v<std::negate, Op>)
+  {
+    v = -v;
+  }
+  else
+  {
+    static_assert(is_functional_v<std::bit_not, Op>);
+    v = ~v;
+  }
+}
+
+/// @brief Applies the binary operator @p Op to @p v and @p u and stores the result in @p v.
+template<typename Op, typename V>
+DEFERRED_SIMD_INLINE void apply(Op const&, V& v, V const& u) noexcept
+{
+  if constexpr (is_functional_v<std::plus, Op>)
+  {
+    v = v + u;
+  }
+  else if constexpr (is_functional_v<std::minus, Op>)
+  {
+    v = v - u;
+  }
+  else if constexpr (is_functional_v<std::multiplies, Op>)
+  {
+    v = v * u;
+  }
+  else if constexpr (is_functional_v<std::divides, Op>)
+  {
+    v = v / u;
+  }
+  else if constexpr (is_functional_v<std::bit_and, Op>)
+  {
+    v = v & u;
+  }
+  else if constexpr (is_functional_v<std::bit_or, Op>)
+  {
+    v = v | u;
+  }
+  else
+  {
+    static_assert(is_functional_v<std::bit_xor, Op>);
+    v = v ^ u;
+  }
+}
+
+/// @brief Compares @p v and @p u with @p Op and stores the result in @p m.
+template<typename Op, typename M, typename V>
+DEFERRED_SIMD_INLINE void compare(Op const&, M& m, V const& v, V const& u) noexcept
+{
+  if constexpr (is_functional_v<std::equal_to, Op>)
+  {
+    m = v == u;
+  }
+  else if constexpr (is_functional_v<std::not_equal_to, Op>)
+  {
+    m = v != u;
+  }
+  else if constexpr (is_functional_v<std::less, Op>)
+  {
+    m = v < u;
+  }
+  else if constexpr (is_functional_v<std::greater, Op>)
+  {
+    m = v > u;
+  }
+  else if constexpr (is_functional_v<std::less_equal, Op>)
+  {
+    m = v <= u;
+  }
+  else
+  {
+    static_assert(is_functional_v<std::greater_equal, Op>);
+    m = v >= u;
+  }
+}
+
+/**
+ * @brief Evaluates @p kernel for all elements in @f$[i, n)@f$ in blocks of @p V and stores them in
+ * @p out.
+ * @return The index of the first element that was not evaluated.
+ */
+template<typename V, bool AlignedLoad, bool AlignedStore, typename Kernel, typename T>
+DEFERRED_SIMD_INLINE std::size_t
+run_blocks(Kernel const& kernel, T* out, std::size_t i, std::size_t n) noexcept
+{
+  constexpr std::size_t lanes = sizeof(V) / sizeof(out[0]);
+  for (; i + lanes <= n; i += lanes)
+  {
+    V v;
+    kernel.template load<V, AlignedLoad>(v, i);
+    store<AlignedStore>(out + i, v);
+  }
+  return i;
+}
+
+/**
+ * @brief Evaluates @p kernel for all elements in @f$[0, n)@f$ in blocks of @p Bytes and stores
+ * them in @p out.
+ *
+ * Elements are evaluated one by one until @p out is aligned and for the remaining tail. If all
+ * ranges of @p kernel are aligned as well, aligned loads are used.
+ */
+template<std::size_t Bytes, typename Kernel, typename T>
+DEFERRED_SIMD_INLINE void run_arithmetic(Kernel const& kernel, T* out, std::size_t n)
+{
+  using V                     = vector_t<T, Bytes>;
+  constexpr std::size_t lanes = Bytes / sizeof(T);
+  std::size_t i               = 0;
+  for (; i < n && i < lanes && !is_aligned(out + i, Bytes); ++i)
+  {
+    out[i] = kernel(i);
+  }
+  if (!is_aligned(out + i, Bytes))
+  {
+    i = run_blocks<V, false, false>(kernel, out, i, n);
+  }
+  else if (kernel.is_aligned(i, Bytes))
+  {
+    i = run_blocks<V, true, true>(kernel, out, i, n);
+  }
+  else
+  {
+    i = run_blocks<V, false, true>(kernel, out, i, n);
+  }
+  for (; i < n; ++i)
+  {
+    out[i] = kernel(i);
+  }
+}
+
+/**
+ * @brief Evaluates the comparison @p kernel with operands of type @p E for all elements in
+ * @f$[0, n)@f$ in blocks of @p Bytes and stores them in @p out.
+ */
+template<std::size_t Bytes, typename E, typename Kernel>
+DEFERRED_SIMD_INLINE void run_comparison(Kernel const& kernel, bool* out, std::size_t n)
+{
+  using V                     = vector_t<E, Bytes>;
+  constexpr std::size_t lanes = Bytes / sizeof(E);
+  std::size_t i               = 0;
+  auto const aligned          = kernel.is_aligned(0, Bytes);
+  for (; i + lanes <= n; i += lanes)
+  {
+    typename vector<E, Bytes>::mask m;
+    if (aligned)
+    {
+      kernel.template compare<V, true>(m, i);
+    }
+    else
+    {
+      kernel.template compare<V, false>(m, i);
+    }
+    for (std::size_t j = 0; j < lanes; ++j)
+    {
+      out[i + j] = m[j] != 0;
+    }
+  }
+  for (; i < n; ++i)
+  {
+    out[i] = kernel(i);
+  }
+}
+
+/**
+ * @brief Evaluates @p kernel with vectors of @p Bytes bytes of elements of type @p E.
+ */
+template<std::size_t Bytes, typename E, typename Kernel, typename T>
+DEFERRED_SIMD_INLINE void run_width(Kernel const& kernel, T* out, std::size_t n)
+{
+  if constexpr (std::is_same_v<T, bool>)
+  {
+    run_comparison<Bytes, E>(kernel, out, n);
+  }
+  else
+  {
+    run_arithmetic<Bytes>(kernel, out, n);
+  }
+}
+
+/// @copydoc run_width
+template<typename E, typename Kernel, typename T>
+[[gnu::target("sse2")]] void run_sse2(Kernel const& kernel, T* out, std::size_t n)
+{
+  run_width<16, E>(kernel, out, n);
+}
+
+/// @copydoc run_width
+template<typename E, typename Kernel, typename T>
+[[gnu::target("avx2")]] void run_avx2(Kernel const& kernel, T* out, std::size_t n)
+{
+  run_width<32, E>(kernel, out, n);
+}
+
+/// @copydoc run_width
+template<typename E, typename Kernel, typename T>
+[[gnu::target("avx512f")]] void run_avx512(Kernel const& kernel, T* out, std::size_t n)
+{
+  run_width<64, E>(kernel, out, n);
+}
+
+#  undef DEFERRED_SIMD_INLINE
+
+#endif
+
+/**
+ * @brief Evaluates @p kernel, whose operands are of type @p E, for all elements in @f$[0, n)@f$
+ * using @p isa and stores them in @p out.
+ * @return @c true if the kernel was evaluated, @c false if @p isa is @ref simd_isa::scalar.
+ */
+template<typename E, typename Kernel, typename T>
+bool run([[maybe_unused]] simd_isa isa,
+         [[maybe_unused]] Kernel const& kernel,
+         [[maybe_unused]] T* out,
+         [[maybe_unused]] std::size_t n)
+{
+#ifdef DEFERRED_SIMD_X86
+  switch (isa)
+  {
+    case simd_isa::avx512:
+      run_avx512<E>(kernel, out, n);
+      return true;
+    case simd_isa::avx2:
+      run_avx2<E>(kernel, out, n);
+      return true;
+    case simd_isa::sse2:
+      run_sse2<E>(kernel, out, n);
+      return true;
+    default:
+      break;
+  }
+#endif
+  return false;
+}
+
+} // namespace detail::simd
+
+} // namespace deferred
+
+#endif
@@ -0,0 +1,368 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_SIMPLIFY_HPP
+#define DEFERRED_SIMPLIFY_HPP
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "constant.hpp"
+#include "evaluate.hpp"
+#include "expression.hpp"
+#include "nary.hpp"
+#include "transform.hpp"
+#include "type_traits/is_pure_expression.hpp"
+
+namespace deferred {
+
+/**
+ * @brief Checks if @p T satisfies the algebraic identities that @ref simplify relies on.
+ *
+ * They are <tt>x * 1 == x</tt>, <tt>x + 0 == x</tt>, <tt>x - 0 == x</tt>, and
+ * <tt>-(-x) == x</tt>. It is @c true for arithmetic types and can be specialized for user-defined
+ * types. For floating-point types, <tt>x + 0</tt> is not simplified, as <tt>-0.0 + 0</tt> is
+ * <tt>+0.0</tt>.
+ *
+ * @tparam T The type to check.
+ */
+template<typename T>
+struct has_algebraic_identities : public std::is_arithmetic<T>
+{ };
+
+/**
+ * @brief Alias for @c has_algebraic_identities::value.
+ * @tparam T The type to check.
+ */
+template<typename T>
+inline constexpr bool has_algebraic_identities_v = has_algebraic_identities<T>::value;
+
+namespace detail {
+
+/// @brief Checks if @p T is a @ref constant_c with value @c 0.
+template<typename T>
+inline constexpr bool is_zero_constant_v = false;
+
+/// @brief Specialization for @ref constant_c.
+template<typename T, T V>
+inline constexpr bool is_zero_constant_v<constant_<std::integral_constant<T, V>>> = (V == 0);
+
+/// @brief Checks if @p T is a @ref constant_c with value @c 1.
+template<typename T>
+inline constexpr bool is_one_constant_v = false;
+
+/// @brief Specialization for @ref constant_c.
+template<typename T, T V>
+inline constexpr bool is_one_constant_v<constant_<std::integral_constant<T, V>>> = (V == 1);
+
+/// @brief Checks if @p E is an @ref expression_ with operator @p Operator.
+template<typename Operator, typename E>
+inline constexpr bool is_operation_v = false;
+
+/// @brief Specialization for @ref expression_.
+template<typename Operator, typename... Expressions>
+inline constexpr bool is_operation_v<Operator, expression_<Operator, Expressions...>> = true;
+
+/// @brief Type of the value of the expression @p E.
+template<typename E>
+using value_t = std::remove_cvref_t<decltype(evaluate(std::declval<E const&>()))>;
+
+/// @brief Type of the @p I-th operand of the @ref expression_ @p E, without references.
+template<std::size_t I, typename E>
+using operand_t = std::remove_cvref_t<std::tuple_element_t<I, typename E::expression_types>>;
+
+/// @brief Checks if replacing the expression @p N with its operand @p E preserves its value.
+template<typename N, typename E>
+inline constexpr bool is_identity_v =
+  std::is_same_v<value_t<N>, value_t<E>> && has_algebraic_identities_v<value_t<E>>;
+
+/// @brief Binary operator of the chain with operator @p Operator.
+template<typename Operator>
+struct chain_operator
+{
+  using type = Operator;
+};
+
+/// @brief Specialization for @ref nary_operator.
+template<typename Operator>
+struct chain_operator<nary_operator<Operator>>
+{
+  using type = Operator;
+};
+
+/// @brief Checks if the @ref expression_ @p E is a chain of additions or multiplications.
+template<typename E>
+inline constexpr bool is_arithmetic_chain_v =
+  std::is_same_v<typename chain_operator<typename E::operator_type>::type, std::plus<>>
+  || std::is_same_v<typename chain_operator<typename E::operator_type>::type, std::multiplies<>>;
+
+/**
+ * @brief Checks if the operand @p E is the identity element of a chain of @p Operator with value
+ * type @p V, i.e., @c 0 for additions that are not floating-point and @c 1 for multiplications.
+ */
+template<typename Operator, typename V, typename E>
+inline constexpr bool is_identity_element_v =
+  (std::is_same_v<Operator, std::plus<>> && !std::is_floating_point_v<V> && is_zero_constant_v<E>)
+  || (std::is_same_v<Operator, std::multiplies<>> && is_one_constant_v<E>);
+
+/**
+ * @brief Checks if the operand @p E is the absorbing element of a chain of @p Operator with value
+ * type @p V, i.e., @c 0 for integral multiplications.
+ */
+template<typename Operator, typename V, typename E>
+inline constexpr bool is_absorbing_element_v = std::is_same_v<Operator, std::multiplies<>>
+                                               && std::is_integral_v<V>
+                                               && !std::is_same_v<V, bool> && is_zero_constant_v<E>;
+
+/**
+ * @brief Removes the identity elements from the operands of the chain @p e, whose operands are
+ * simplified, or replaces it with @c 0 if it has an absorbing element.
+ *
+ * Operands are removed only if the rest of them have the value type of @p e, so that the value of
+ * the chain does not change. Chains are only replaced with @c 0 if they are pure.
+ */
+template<typename E>
+constexpr decltype(auto) simplify_chain(E e)
+{
+  using operator_type        = typename chain_operator<typename E::operator_type>::type;
+  using expression_types     = typename E::expression_types;
+  using value_type           = value_t<E>;
+  constexpr std::size_t size = std::tuple_size_v<expression_types>;
+  return [&]<std::size_t... I>(std::index_sequence<I...>) -> decltype(auto) {
+    constexpr bool identities = has_algebraic_identities_v<value_type>;
+    constexpr bool absorbed =
+      identities && (is_absorbing_element_v<operator_type, value_type, operand_t<I, E>> || ...)
+      && is_pure_expression_v<E>;
+    constexpr std::array<bool, size> removed{
+      is_identity_element_v<operator_type, value_type, operand_t<I, E>>...};
+    constexpr bool preserved =
+      identities
+      && ((removed[I] || std::is_same_v<value_t<operand_t<I, E>>, value_type>) && ...);
+    constexpr std::size_t kept = ((removed[I] ? 0 : 1) + ...);
+    // indices of the operands that are kept
+    constexpr auto indices = [&] {
+      std::array<std::size_t, kept> result{};
+      std::size_t n = 0;
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        if (!removed[i])
+        {
+          result[n++] = i;
+        }
+      }
+      return result;
+    }();
+
+    if constexpr (absorbed)
+    {
+      return constant_<value_type>(value_type{});
+    }
+    else if constexpr (!preserved || kept == size)
+    {
+      return E(std::move(e));
+    }
+    else if constexpr (kept == 0)
+    {
+      // all operands are identity elements, e.g., 0 + 0
+      if constexpr (std::is_same_v<value_t<operand_t<0, E>>, value_type>)
+      {
+        return operand<0>(e);
+      }
+      else
+      {
+        return E(std::move(e));
+      }
+    }
+    else if constexpr (kept == 1)
+    {
+      return operand<indices[0]>(e);
+    }
+    else
+    {
+      return [&]<std::size_t... J>(std::index_sequence<J...>) {
+        using simplified_type = expression_<typename E::operator_type,
+                                            std::tuple_element_t<indices[J], expression_types>...>;
+        return simplified_type(e.operator_(), operand<indices[J]>(e)...);
+      }(std::make_index_sequence<kept>{});
+    }
+  }(std::make_index_sequence<size>{});
+}
+
+/// @brief Simplifications of an @ref expression_.
+enum class simplification
+{
+  none,
+  // replaced by its first operand
+  first,
+  // replaced by the operand of its operand
+  nested
+};
+
+/// @brief Finds the simplification of the @ref expression_ @p N.
+template<typename N>
+consteval simplification find_simplification()
+{
+  using operator_type            = typename N::operator_type;
+  constexpr std::size_t operands = std::tuple_size_v<typename N::expression_types>;
+  if constexpr (operands == 2 && std::is_same_v<operator_type, std::minus<>>)
+  {
+    // x - 0
+    if (is_zero_constant_v<operand_t<1, N>> && is_identity_v<N, operand_t<0, N>>)
+    {
+      return simplification::first;
+    }
+  }
+  else if constexpr (operands == 1)
+  {
+    using operand_type = operand_t<0, N>;
+    if constexpr (std::is_same_v<operator_type, std::negate<>>
+                  && is_operation_v<std::negate<>, operand_type>)
+    {
+      // -(-x)
+      if (is_identity_v<N, operand_t<0, operand_type>>)
+      {
+        return simplification::nested;
+      }
+    }
+    else if constexpr (std::is_same_v<operator_type, std::logical_not<>>
+                       && is_operation_v<std::logical_not<>, operand_type>)
+    {
+      // !(!b)
+      if (std::is_same_v<value_t<operand_t<0, operand_type>>, bool>)
+      {
+        return simplification::nested;
+      }
+    }
+  }
+  return simplification::none;
+}
+
+/// @brief Applies the simplification of the @ref expression_ @p e, whose operands are simplified.
+template<typename E>
+constexpr decltype(auto) simplify_expression(E e)
+{
+  constexpr auto s = find_simplification<E>();
+  if constexpr (is_arithmetic_chain_v<E>)
+  {
+    return simplify_chain(std::move(e));
+  }
+  else if constexpr (s == simplification::first)
+  {
+    return operand<0>(e);
+  }
+  else if constexpr (s == simplification::nested)
+  {
+    return operand<0>(operand<0>(e));
+  }
+  else
+  {
+    return e;
+  }
+}
+
+template<typename Expression, typename E>
+constexpr decltype(auto) simplify_impl(E&& e);
+
+/// @brief Simplifies the operands of the @ref expression_ @p e.
+template<typename E, std::size_t... I>
+constexpr auto simplify_operands(E const& e, std::index_sequence<I...>)
+{
+  using expression_types = typename E::expression_types;
+  using simplified_type =
+    expression_<typename E::operator_type,
+                decltype(simplify_impl<std::tuple_element_t<I, expression_types>>(
+                  std::get<I>(e.subexpressions())))...>;
+  return simplified_type(e.operator_(),
+                         simplify_impl<std::tuple_element_t<I, expression_types>>(
+                           std::get<I>(e.subexpressions()))...);
+}
+
+/**
+ * @brief Simplifies @p e, which is stored as @p Expression.
+ *
+ * Nodes other than @ref expression_ keep the type they are stored as, i.e., referenced nodes
+ * remain references and owned nodes are copied.
+ */
+template<typename Expression, typename E>
+constexpr decltype(auto) simplify_impl(E&& e)
+{
+  using expression_type = std::remove_cvref_t<E>;
+  if constexpr (is_expression_v<expression_type>)
+  {
+    using expression_types = typename expression_type::expression_types;
+    return simplify_expression(
+      simplify_operands(e, std::make_index_sequence<std::tuple_size_v<expression_types>>{}));
+  }
+  else if constexpr (std::is_lvalue_reference_v<Expression>)
+  {
+    return static_cast<Expression>(e);
+  }
+  else
+  {
+    return expression_type(e);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Removes algebraic identities from the @ref expression_ nodes of @p expr.
+ *
+ * The following patterns are simplified, bottom-up:
+ * - @c 1 operands of multiplications and @c 0 operands of additions are removed, also from chains
+ *   of more than two operands (e.g., <tt>x + 0 + y</tt> becomes <tt>x + y</tt>), where @c 0 and
+ *   @c 1 are @ref constant_c, as their value must be known when @p expr is simplified,
+ * - multiplications with a @c 0 operand are replaced with @c 0 if they have no side effects and
+ *   their type is integral,
+ * - <tt>x - 0</tt>, <tt>-(-x)</tt>, and <tt>!(!b)</tt>, where @c b is @c bool, are replaced by
+ *   @c x and @c b.
+ *
+ * Arithmetic patterns are only simplified if the type of the result satisfies
+ * @ref has_algebraic_identities and the remaining operands have the same type, so that the value
+ * of @p expr does not change.
+ *
+ * The returned expression has a different type than @p expr. Nodes that are not
+ * @ref expression_ are referenced if @p expr references them and copied otherwise.
+ *
+ * Example:
+ * @code
+ * auto x  = variable<int>();
+ * auto ex = (x + constant_c<0>) * constant_c<1> - -(-x);
+ * auto s  = simplify(ex); // equivalent to x - x
+ * node_count(ex) - node_count(s); // number of eliminated nodes
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to simplify.
+ * @return A new expression without the identities.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr decltype(auto) simplify(Expression&& expr)
+{
+  return detail::simplify_impl<Expression>(expr);
+}
+
+/**
+ * @brief Returns the number of nodes that are visited by @c expr.visit().
+ *
+ * A @ref variable_ counts as two nodes, itself and its value.
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to count the nodes of.
+ * @return Number of nodes of @p expr.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr std::size_t node_count(Expression const& expr)
+{
+  std::size_t n = 0;
+  expr.visit([&n](auto const&, std::size_t) { ++n; });
+  return n;
+}
+
+} // namespace deferred
+
+#endif
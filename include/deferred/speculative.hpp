@@ -0,0 +1,411 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_SPECULATIVE_HPP
+#define DEFERRED_SPECULATIVE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "conditional.hpp"
+#include "detail/map_result.hpp"
+#include "evaluate.hpp"
+#include "expression.hpp"
+#include "thread_pool.hpp"
+#include "type_traits/is_pure_expression.hpp"
+
+namespace deferred {
+
+/**
+ * @brief Branches of a @ref conditional_expression that a @ref speculative_expression evaluates
+ * while the conditions are being evaluated.
+ */
+enum class speculation
+{
+  /// The @c then expression of the @c if branch.
+  then_branch,
+  /// The @c then expression of the @c if branch and the @c else branch.
+  then_and_else
+};
+
+namespace detail {
+
+/**
+ * @brief Result of an expression that is speculatively evaluated on a @ref thread_pool.
+ *
+ * The speculation is either claimed by a worker, which evaluates the expression, or by the owner,
+ * which cancels it. The state is shared with the submitted task, which may outlive this object if
+ * the speculation is cancelled.
+ *
+ * @tparam T Type of the result.
+ */
+template<typename T>
+class speculative_result
+{
+  using value_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+  enum class status : unsigned char
+  {
+    pending,
+    running,
+    done,
+    cancelled
+  };
+
+  struct state
+  {
+    std::atomic<status> m_status{status::pending};
+    std::optional<value_type> m_value;
+    std::exception_ptr m_exception;
+
+    [[nodiscard]] bool claim(status s) noexcept
+    {
+      auto expected = status::pending;
+      return m_status.compare_exchange_strong(expected, s, std::memory_order_acq_rel);
+    }
+  };
+
+  std::shared_ptr<state> m_state;
+
+  void wait() const noexcept
+  {
+    auto s = m_state->m_status.load(std::memory_order_acquire);
+    while (s == status::running)
+    {
+      m_state->m_status.wait(s, std::memory_order_acquire);
+      s = m_state->m_status.load(std::memory_order_acquire);
+    }
+  }
+
+public:
+  speculative_result() = default;
+
+  speculative_result(speculative_result const&)            = delete;
+  speculative_result(speculative_result&&)                 = delete;
+  speculative_result& operator=(speculative_result const&) = delete;
+  speculative_result& operator=(speculative_result&&)      = delete;
+
+  ~speculative_result()
+  {
+    discard();
+  }
+
+  /**
+   * @brief Submits @p f to @p pool.
+   * @tparam F Type of the callable.
+   * @param pool Thread pool to evaluate @p f on.
+   * @param f Callable that evaluates the expression.
+   */
+  template<typename F>
+  void launch(thread_pool& pool, F f)
+  {
+    m_state = std::make_shared<state>();
+    pool.submit([s = m_state, f = std::move(f)]() noexcept {
+      if (!s->claim(status::running))
+      {
+        return;
+      }
+      try
+      {
+        if constexpr (std::is_void_v<T>)
+        {
+          f();
+          s->m_value.emplace();
+        }
+        else
+        {
+          s->m_value.emplace(f());
+        }
+      }
+      catch (...)
+      {
+        s->m_exception = std::current_exception();
+      }
+      s->m_status.store(status::done, std::memory_order_release);
+      s->m_status.notify_all();
+    });
+  }
+
+  /**
+   * @brief Returns the result of the speculation.
+   *
+   * If the speculation has not started, it is cancelled and @p f is invoked on the calling thread
+   * instead. Otherwise, it waits for the speculation to finish and rethrows its exception, if any.
+   *
+   * @tparam F Type of the callable.
+   * @param f Callable that evaluates the expression.
+   * @return Result of the expression.
+   */
+  template<typename F>
+  T get(F&& f)
+  {
+    if (!m_state || m_state->claim(status::cancelled))
+    {
+      return std::forward<F>(f)();
+    }
+    wait();
+    if (m_state->m_exception)
+    {
+      std::rethrow_exception(m_state->m_exception);
+    }
+    if constexpr (!std::is_void_v<T>)
+    {
+      return std::move(*m_state->m_value);
+    }
+  }
+
+  /**
+   * @brief Discards the speculation.
+   *
+   * If the speculation has not started, it is cancelled. Otherwise, it waits for the speculation
+   * to finish, as it may reference the expression, and discards its result.
+   */
+  void discard() noexcept
+  {
+    if (m_state && !m_state->claim(status::cancelled))
+    {
+      wait();
+    }
+    m_state.reset();
+  }
+};
+
+/// @brief Checks if @p T is a @ref conditional_expression.
+template<typename T>
+inline constexpr bool is_conditional_expression_v = false;
+
+/// @brief Specialization for @ref conditional_expression.
+template<typename Else, typename... Branches>
+inline constexpr bool is_conditional_expression_v<conditional_expression<Else, Branches...>> =
+  true;
+
+/**
+ * @brief Checks if the conditions of the @ref conditional_expression @p T are pure.
+ */
+template<typename T>
+inline constexpr bool has_pure_conditions_v = false;
+
+/// @brief Specialization for @ref conditional_expression.
+template<typename Else, typename... Branches>
+inline constexpr bool has_pure_conditions_v<conditional_expression<Else, Branches...>> =
+  (is_pure_expression_v<typename Branches::condition_type> && ...);
+
+/// @brief Type of the result of evaluating @p E.
+template<typename E>
+using evaluate_result_t = decltype(evaluate(std::declval<E const&>()));
+
+} // namespace detail
+
+/**
+ * @brief Deferred expression that speculatively evaluates the likely branch of a
+ * @ref conditional_expression on a @ref thread_pool while the conditions are being evaluated.
+ *
+ * The likely branch is the @c then expression of the @c if branch and, if @p Mode is
+ * @ref speculation::then_and_else, the @c else branch. If the chosen branch was speculated, its
+ * result is used, or it is evaluated on the calling thread if no worker has started it yet. Losing
+ * speculations that have not started are cancelled, and those that have started are waited for
+ * and their results and exceptions are discarded.
+ *
+ * Speculation requires that the conditions and the speculated branches are pure (see
+ * @ref is_pure_expression), as they are evaluated concurrently.
+ *
+ * @tparam Mode Branches to speculate.
+ * @tparam Conditional Type of the @ref conditional_expression.
+ */
+template<speculation Mode, Deferred Conditional>
+  requires detail::is_conditional_expression_v<std::remove_cvref_t<Conditional>>
+class speculative_expression
+{
+  using conditional_type = std::remove_cvref_t<Conditional>;
+  using branches_storage = typename conditional_type::branches_storage;
+  using first_branch     = detail::flat_tuple_element_t<0, branches_storage>;
+  using then_type        = typename first_branch::then_type;
+
+  constexpr static inline bool finalized      = conditional_type::finalized;
+  constexpr static inline bool speculate_else = Mode == speculation::then_and_else;
+
+  template<typename C>
+  struct else_result
+  {
+    using type = void;
+  };
+
+  template<typename C>
+    requires C::finalized
+  struct else_result<C>
+  {
+    using type = detail::evaluate_result_t<decltype(std::declval<C const&>().else_branch())>;
+  };
+
+  using then_result_type = detail::evaluate_result_t<then_type>;
+  using else_result_type = typename else_result<conditional_type>::type;
+
+  static_assert(detail::has_pure_conditions_v<conditional_type>,
+                "Conditions must be pure to be evaluated concurrently with a speculation");
+  static_assert(is_pure_expression_v<then_type>, "Speculated branch must be pure");
+  static_assert(!speculate_else || finalized, "Speculating the else branch requires else_");
+
+public:
+  using conditional_expression_type = Conditional;
+  using result_type                 = typename conditional_type::result_type;
+  // the thread pool is not a deferred type, therefore the expression is never constant
+  using subexpression_types = std::tuple<Conditional, thread_pool*>;
+
+private:
+  Conditional m_conditional;
+  thread_pool* m_pool;
+
+  using base_result_type = typename conditional_type::base_result_type;
+
+  // Evaluates a branch that was not speculated.
+  template<typename Result, typename Then, typename... Speculations>
+  static result_type evaluate_unspeculated(Then const& then, Speculations&... speculations)
+  {
+    if constexpr (!is_pure_expression_v<Then>)
+    {
+      // the branch may modify state that the speculations read
+      (speculations.discard(), ...);
+    }
+    return detail::map_result<Result>([&] { return evaluate(then); });
+  }
+
+  template<std::size_t I, typename ThenSpeculation, typename ElseSpeculation>
+  result_type evaluate_impl(ThenSpeculation& then_speculation,
+                            ElseSpeculation& else_speculation) const
+  {
+    if constexpr (I < branches_storage::size)
+    {
+      auto const& branch = detail::get<I>(m_conditional.branches());
+      if (evaluate(branch.condition))
+      {
+        if constexpr (I == 0)
+        {
+          else_speculation.discard();
+          return detail::map_result<base_result_type>(
+            [&] { return then_speculation.get([&] { return evaluate(branch.then); }); });
+        }
+        else
+        {
+          return evaluate_unspeculated<base_result_type>(
+            branch.then, then_speculation, else_speculation);
+        }
+      }
+      return evaluate_impl<I + 1>(then_speculation, else_speculation);
+    }
+    else if constexpr (!finalized)
+    {
+      then_speculation.discard();
+      if constexpr (!std::is_void_v<result_type>)
+      {
+        return std::nullopt;
+      }
+    }
+    else if constexpr (speculate_else)
+    {
+      then_speculation.discard();
+      return detail::map_result<result_type>([&] {
+        return else_speculation.get([&] { return evaluate(m_conditional.else_branch()); });
+      });
+    }
+    else
+    {
+      return evaluate_unspeculated<result_type>(m_conditional.else_branch(), then_speculation);
+    }
+  }
+
+public:
+  /**
+   * @brief Constructs a speculative_expression.
+   * @tparam C Type of the conditional expression.
+   * @param pool Thread pool to evaluate the speculated branches on.
+   * @param conditional Conditional expression to evaluate.
+   */
+  template<typename C>
+  explicit speculative_expression(thread_pool& pool, C&& conditional) :
+    m_conditional(std::forward<C>(conditional)), m_pool(&pool)
+  { }
+
+  /**
+   * @brief Evaluates the speculative expression.
+   * @return Result of the conditional expression.
+   */
+  [[nodiscard]] result_type operator()() const
+  {
+    detail::speculative_result<then_result_type> then_speculation;
+    detail::speculative_result<else_result_type> else_speculation;
+    then_speculation.launch(*m_pool, [&then = detail::get<0>(m_conditional.branches()).then] {
+      return evaluate(then);
+    });
+    if constexpr (speculate_else)
+    {
+      static_assert(is_pure_expression_v<decltype(m_conditional.else_branch())>,
+                    "Speculated branch must be pure");
+      else_speculation.launch(*m_pool, [&else_branch = m_conditional.else_branch()] {
+        return evaluate(else_branch);
+      });
+    }
+    return evaluate_impl<0>(then_speculation, else_speculation);
+  }
+
+  /**
+   * @brief Visits the speculative expression with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    m_conditional.visit(std::forward<Visitor>(v), nesting + 1);
+  }
+};
+
+/**
+ * @brief Creates a new @ref speculative_expression that speculatively evaluates the likely branches
+ * of @p conditional on @p pool.
+ *
+ * Example:
+ * @code
+ * auto ex = speculative_(pool, if_(in_range(x), interpolate(x)).else_(extrapolate(x)));
+ * ex(); // interpolate(x) is evaluated while in_range(x) is being evaluated
+ * @endcode
+ *
+ * @tparam Mode Branches to speculate.
+ * @tparam Conditional Type of the @ref conditional_expression.
+ * @param pool Thread pool to evaluate the speculated branches on.
+ * @param conditional Conditional expression to evaluate.
+ * @return A @ref speculative_expression for @p conditional.
+ */
+template<speculation Mode = speculation::then_branch, Deferred Conditional>
+[[nodiscard]] auto speculative_(thread_pool& pool, Conditional&& conditional)
+{
+  return speculative_expression<Mode, make_deferred_t<Conditional>>(
+    pool, std::forward<Conditional>(conditional));
+}
+
+/**
+ * @brief Creates a new @ref speculative_expression that speculatively evaluates the likely branches
+ * of @p conditional on @ref default_thread_pool().
+ *
+ * @tparam Mode Branches to speculate.
+ * @tparam Conditional Type of the @ref conditional_expression.
+ * @param conditional Conditional expression to evaluate.
+ * @return A @ref speculative_expression for @p conditional.
+ */
+template<speculation Mode = speculation::then_branch, Deferred Conditional>
+[[nodiscard]] auto speculative_(Conditional&& conditional)
+{
+  return speculative_<Mode>(default_thread_pool(), std::forward<Conditional>(conditional));
+}
+
+} // namespace deferred
+
+#endif
@@ -4,11 +4,14 @@
 #ifndef DEFERRED_SWITCH_HPP
 #define DEFERRED_SWITCH_HPP
 
+#include <array>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 
+#include "detail/flat_tuple.hpp"
 #include "detail/map_result.hpp"
+#include "detail/switch_table.hpp"
 #include "evaluate.hpp"
 #include "expression.hpp"
 #include "type_traits/homogenized_type.hpp"
@@ -39,6 +42,12 @@ public:
   constexpr explicit default_expression(T&& t) : m_expression(std::forward<T>(t))
   { }
 
+  /// @brief Returns the body expression.
+  [[nodiscard]] constexpr Expression const& body() const noexcept
+  {
+    return m_expression;
+  }
+
   [[nodiscard]] constexpr decltype(auto) operator()() const
   {
     return evaluate(m_expression);
@@ -112,6 +121,18 @@ public:
     return t == evaluate(m_label);
   }
 
+  /// @brief Returns the label expression.
+  [[nodiscard]] constexpr LabelExpression const& label() const noexcept
+  {
+    return m_label;
+  }
+
+  /// @brief Returns the body expression.
+  [[nodiscard]] constexpr BodyExpression const& body() const noexcept
+  {
+    return m_body;
+  }
+
   /// @brief Returns the result of the body expression.
   [[nodiscard]] constexpr decltype(auto) operator()() const
   {
@@ -152,6 +173,12 @@ concept CaseExpression = requires(std::remove_cvref_t<T> t) {
 /**
  * @brief Deferred switch
  *
+ * If all labels are @ref constant_ of integral or enumeration type, they are evaluated once at
+ * construction and cases are found through a lookup table in @f$O(1)@f$ or @f$O(\log N)@f$. If
+ * they are @ref constant_ strings and the condition is @c std::string or @c std::string_view, or
+ * they are of the same hashable type as the condition, cases are found through a hash table and
+ * confirmed with a single label comparison. Otherwise, cases are checked in order.
+ *
  * @tparam ConditionExpression Type of the condition expression.
  * @tparam DefaultExpression Type of the default case expression.
  * @tparam CaseExpression Types of the case expressions.
@@ -165,6 +192,9 @@ public:
   using case_expression_types     = std::tuple<CaseExpression...>;
   using subexpression_types = std::tuple<ConditionExpression, DefaultExpression, CaseExpression...>;
 
+  /// @brief Type of the storage of the default and case expressions.
+  using cases_storage = detail::flat_tuple<DefaultExpression, CaseExpression...>;
+
   /**
    * @brief Result type of the switch expression (common type or variant).
    */
@@ -173,8 +203,152 @@ public:
                        decltype(std::declval<typename CaseExpression::body_type>()())...>;
 
 private:
+  using condition_value_type =
+    std::remove_cvref_t<decltype(evaluate(std::declval<ConditionExpression const&>()))>;
+
+  /// @brief Key type of the lookup table, or @c void if there is none.
+  using table_key_type =
+    detail::switch_table_key_t<condition_value_type,
+                               typename CaseExpression::label_expression_type...>;
+
+  /// @brief Key type of the hash table, or @c void if there is none.
+  using hash_key_type = std::conditional_t<
+    std::is_void_v<table_key_type>,
+    detail::switch_hash_key_t<condition_value_type,
+                              typename CaseExpression::label_expression_type...>,
+    void>;
+
+  constexpr static inline bool has_table      = !std::is_void_v<table_key_type>;
+  constexpr static inline bool has_hash_table = !std::is_void_v<hash_key_type>;
+
+  struct no_table
+  { };
+
+  using table_type = typename std::conditional_t<
+    has_table,
+    std::type_identity<detail::switch_table<table_key_type, sizeof...(CaseExpression)>>,
+    std::conditional_t<
+      has_hash_table,
+      std::type_identity<detail::switch_hash_table<hash_key_type, sizeof...(CaseExpression)>>,
+      std::type_identity<no_table>>>::type;
+
   [[no_unique_address]] ConditionExpression m_condition;
-  [[no_unique_address]] std::tuple<DefaultExpression, CaseExpression...> m_cases;
+  [[no_unique_address]] cases_storage m_cases;
+  [[no_unique_address]] table_type m_table;
+
+  /// @brief Creates the lookup table from the labels.
+  [[nodiscard]] constexpr table_type make_table() const
+  {
+    if constexpr (has_table)
+    {
+      return detail::flat_apply(
+        [](auto const&, auto const&... cases) {
+          return table_type(std::array<table_key_type, sizeof...(CaseExpression)>{
+            static_cast<table_key_type>(evaluate(cases.label()))...});
+        },
+        m_cases);
+    }
+    else if constexpr (has_hash_table)
+    {
+      return detail::flat_apply(
+        [](auto const&, auto const&... cases) {
+          return table_type(std::array<hash_key_type, sizeof...(CaseExpression)>{
+            hash_key_type(cases.label()())...});
+        },
+        m_cases);
+    }
+    else
+    {
+      return {};
+    }
+  }
+
+  /// @brief Compares @p t with the label of the @p I-th case; index @c 0 is the default.
+  template<std::size_t I>
+  [[nodiscard]] static constexpr bool compare_case(switch_expression const& self,
+                                                   condition_value_type const& t)
+  {
+    if constexpr (I == 0)
+    {
+      return false;
+    }
+    else
+    {
+      return static_cast<bool>(detail::get<I>(self.m_cases).compare(t));
+    }
+  }
+
+  /// @brief Evaluates the @p I-th case; index @c 0 is the default.
+  template<std::size_t I>
+  [[nodiscard]] static constexpr result_type evaluate_case(switch_expression const& self)
+  {
+    return detail::map_result<result_type>([&] { return detail::get<I>(self.m_cases)(); });
+  }
+
+  /**
+   * @brief Evaluates the case @p index, which is in <tt>[Begin, End)</tt>.
+   *
+   * The case is found with a binary search, so that the depth of instantiations is logarithmic in
+   * the number of cases.
+   */
+  template<std::size_t Begin, std::size_t End>
+  [[nodiscard]] static constexpr result_type evaluate_case(switch_expression const& self,
+                                                           std::size_t index)
+  {
+    if constexpr (End - Begin == 1)
+    {
+      return evaluate_case<Begin>(self);
+    }
+    else
+    {
+      constexpr std::size_t middle = Begin + (End - Begin) / 2;
+      if (index < middle)
+      {
+        return evaluate_case<Begin, middle>(self, index);
+      }
+      return evaluate_case<middle, End>(self, index);
+    }
+  }
+
+  template<std::size_t... I>
+  [[nodiscard]] static constexpr auto make_jump_table(std::index_sequence<I...>)
+  {
+    return std::array<result_type (*)(switch_expression const&), sizeof...(I)>{
+      &evaluate_case<I>...};
+  }
+
+  template<std::size_t... I>
+  [[nodiscard]] static constexpr auto make_compare_table(std::index_sequence<I...>)
+  {
+    return std::array<bool (*)(switch_expression const&, condition_value_type const&),
+                      sizeof...(I)>{&compare_case<I>...};
+  }
+
+  /// @brief Functions that evaluate each case, indexed by the lookup table.
+  static constexpr auto s_jump_table =
+    make_jump_table(std::make_index_sequence<1 + sizeof...(CaseExpression)>{});
+
+  /**
+   * @brief Functions that compare with the label of each case, indexed by the hash table.
+   *
+   * It is a variable template, so that it is only instantiated for switches with a hash table.
+   */
+  template<typename Indices = std::make_index_sequence<1 + sizeof...(CaseExpression)>>
+  static constexpr auto s_compare_table = make_compare_table(Indices{});
+
+  /// @brief Finds the case whose label matches @p t through the lookup or hash table.
+  [[nodiscard]] constexpr std::size_t find_case(condition_value_type const& t) const
+  {
+    if constexpr (has_table)
+    {
+      return m_table.find(static_cast<table_key_type>(t));
+    }
+    else
+    {
+      return m_table.find(hash_key_type(t),
+                          [&](std::size_t i) { return s_compare_table<>[i](*this, t); });
+    }
+  }
 
 public:
   /**
@@ -189,7 +363,8 @@ public:
   template<typename Condition, typename Default, typename... Case>
   constexpr explicit switch_expression(Condition&& condition, Default&& df, Case&&... cs) :
     m_condition(std::forward<Condition>(condition)),
-    m_cases(std::forward<Default>(df), std::forward<Case>(cs)...)
+    m_cases(std::in_place, std::forward<Default>(df), std::forward<Case>(cs)...),
+    m_table(make_table())
   { }
 
   /**
@@ -210,7 +385,7 @@ public:
                                                   DefaultExpression,
                                                   CaseExpression...,
                                                   std::decay_t<NewCases>...>;
-    return std::apply(
+    return detail::flat_apply(
       [&](auto const& df, auto const&... cases) {
         return expanded_expression(m_condition, df, cases..., std::forward<NewCases>(new_cases)...);
       },
@@ -229,7 +404,7 @@ public:
                                                   DefaultExpression,
                                                   CaseExpression...,
                                                   std::decay_t<NewCases>...>;
-    return std::apply(
+    return detail::flat_apply(
       [&](auto&& df, auto&&... cases) {
         return expanded_expression(std::forward<ConditionExpression>(m_condition),
                                    std::forward<decltype(df)>(df),
@@ -239,28 +414,35 @@ public:
       std::move(m_cases));
   }
 
-private:
+  /// @brief Returns the condition expression.
+  [[nodiscard]] constexpr ConditionExpression const& condition() const noexcept
+  {
+    return m_condition;
+  }
+
   /**
-   * @brief Traverses the cases until one matches.
+   * @brief Returns the default expression followed by the case expressions.
    *
-   * If none does, the default (@c std::tuple_element<0>) is returned.
+   * They are accessed with @ref detail::get and @ref detail::flat_apply.
    */
-  template<std::size_t I, typename T>
-  [[nodiscard]] constexpr result_type choose_case(T const& t) const
+  [[nodiscard]] constexpr cases_storage const& cases() const noexcept
   {
-    if constexpr (I < std::tuple_size_v<decltype(m_cases)>)
-    {
-      if (std::get<I>(m_cases).compare(t))
-      {
-        return detail::map_result<result_type>([&] { return std::get<I>(m_cases)(); });
-      }
+    return m_cases;
+  }
 
-      return choose_case<I + 1>(t);
-    }
-    else
-    {
-      return detail::map_result<result_type>([&] { return std::get<0>(m_cases)(); });
-    }
+private:
+  /**
+   * @brief Compares @p t with the labels of the cases in order until one matches.
+   * @return Index of the matching case, or @c 0 (the default) if none does.
+   */
+  template<typename T, std::size_t... I>
+  [[nodiscard]] constexpr std::size_t choose_case(T const& t, std::index_sequence<I...>) const
+  {
+    std::size_t index = 0;
+    static_cast<void>(
+      ((static_cast<bool>(detail::get<I + 1>(m_cases).compare(t)) && (index = I + 1, true))
+       || ...));
+    return index;
   }
 
 public:
@@ -270,15 +452,31 @@ public:
    */
   [[nodiscard]] constexpr result_type operator()() const
   {
-    // start from second case, as first is the default
-    return choose_case<1>(evaluate(m_condition));
+    if constexpr (has_table || has_hash_table)
+    {
+      return s_jump_table[find_case(evaluate(m_condition))](*this);
+    }
+    else
+    {
+      return evaluate_case<0, 1 + sizeof...(CaseExpression)>(
+        *this,
+        choose_case(evaluate(m_condition), std::index_sequence_for<CaseExpression...>{}));
+    }
   }
 
   /// @copydoc switch_expression::operator()() const
   [[nodiscard]] constexpr result_type operator()()
   {
-    // start from second case, as first is the default
-    return choose_case<1>(evaluate(m_condition));
+    if constexpr (has_table || has_hash_table)
+    {
+      return s_jump_table[find_case(evaluate(m_condition))](*this);
+    }
+    else
+    {
+      return evaluate_case<0, 1 + sizeof...(CaseExpression)>(
+        *this,
+        choose_case(evaluate(m_condition), std::index_sequence_for<CaseExpression...>{}));
+    }
   }
 
   /**
@@ -292,7 +490,7 @@ public:
   {
     std::forward<Visitor>(v)(*this, nesting);
     m_condition.visit(std::forward<Visitor>(v), nesting + 1);
-    std::apply(
+    detail::flat_apply(
       [&](auto const&... args) { (args.visit(std::forward<Visitor>(v), nesting + 1), ...); },
       m_cases);
   }
@@ -0,0 +1,317 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_TAPE_HPP
+#define DEFERRED_TAPE_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/// @brief Number of @ref expression_ nodes in @p E, which are the steps of its tape.
+template<typename E>
+inline constexpr std::size_t tape_size_v = 0;
+
+/// @brief Specialization for @ref expression_.
+template<typename Operator, typename... Expressions>
+inline constexpr std::size_t tape_size_v<expression_<Operator, Expressions...>> =
+  (tape_size_v<std::remove_cvref_t<Expressions>> + ... + 1);
+
+/// @brief Stores the result of a step, which is either a value or a reference.
+template<typename R>
+class tape_slot
+{
+  std::optional<R> m_value;
+
+public:
+  template<typename F>
+  constexpr void set(F&& f)
+  {
+    m_value.emplace(std::forward<F>(f)());
+  }
+
+  [[nodiscard]] constexpr R get()
+  {
+    return std::move(*m_value);
+  }
+};
+
+/// @brief Specialization for reference results.
+template<typename R>
+  requires std::is_reference_v<R>
+class tape_slot<R>
+{
+  std::remove_reference_t<R>* m_value = nullptr;
+
+public:
+  template<typename F>
+  constexpr void set(F&& f)
+  {
+    m_value = std::addressof(std::forward<F>(f)());
+  }
+
+  [[nodiscard]] constexpr R get() const noexcept
+  {
+    return static_cast<R>(*m_value);
+  }
+};
+
+/// @brief Specialization for @c void results, which can only be the root and are not stored.
+template<>
+class tape_slot<void>
+{ };
+
+/// @brief Tuple of the slots of the steps of @p E in post-order.
+template<typename E>
+struct tape_slots
+{
+  using type = std::tuple<>;
+};
+
+/// @brief Specialization for @ref expression_.
+template<typename Operator, typename... Expressions>
+struct tape_slots<expression_<Operator, Expressions...>>
+{
+  using type = decltype(std::tuple_cat(
+    std::declval<typename tape_slots<std::remove_cvref_t<Expressions>>::type>()...,
+    std::declval<std::tuple<
+      tape_slot<decltype(std::declval<expression_<Operator, Expressions...> const&>()())>>>()));
+};
+
+/// @brief Step of a tape, which evaluates the @ref expression_ node @c node.
+template<typename Buffer>
+struct tape_step
+{
+  void (*function)(void const*, Buffer&) = nullptr;
+  void const* node                       = nullptr;
+};
+
+/**
+ * @brief Steps of the tape of the subtree @p E, whose first step is @p Start.
+ *
+ * Steps are numbered in post-order, therefore the step of @p E is the last of its subtree and the
+ * steps of its operands precede it.
+ */
+template<typename E, std::size_t Start, typename Buffer>
+struct tape_steps
+{
+  using expression_types          = typename E::expression_types;
+  static constexpr std::size_t id = Start + tape_size_v<E> - 1;
+
+  template<std::size_t I>
+  using operand_t = std::remove_cvref_t<std::tuple_element_t<I, expression_types>>;
+
+  /// @brief Returns the first step of the @p I-th operand.
+  template<std::size_t I>
+  [[nodiscard]] static consteval std::size_t operand_start() noexcept
+  {
+    return []<std::size_t... J>(std::index_sequence<J...>) {
+      return (Start + ... + tape_size_v<operand_t<J>>);
+    }(std::make_index_sequence<I>{});
+  }
+
+  /// @brief Evaluates the @p I-th operand, or reads its result if it is a step.
+  template<std::size_t I>
+  [[nodiscard]] static constexpr decltype(auto) operand(E const& e, Buffer& buffer)
+  {
+    using operand_type = operand_t<I>;
+    if constexpr (is_expression_v<operand_type>)
+    {
+      return std::get<operand_start<I>() + tape_size_v<operand_type> - 1>(buffer).get();
+    }
+    else
+    {
+      return std::get<I>(e.subexpressions())();
+    }
+  }
+
+  /// @brief Applies the operator of @p e to its operands.
+  [[nodiscard]] static constexpr decltype(auto) compute(E const& e, Buffer& buffer)
+  {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) -> decltype(auto) {
+      return e.operator_()(operand<I>(e, buffer)...);
+    }(std::make_index_sequence<std::tuple_size_v<expression_types>>{});
+  }
+
+  /// @brief Computes the step and stores its result.
+  static void step(void const* node, Buffer& buffer)
+  {
+    auto const& e = *static_cast<E const*>(node);
+    std::get<id>(buffer).set([&]() -> decltype(auto) { return compute(e, buffer); });
+  }
+
+  /// @brief Stores the step and address of each node of @p e in @p steps, if it is in its bounds.
+  template<std::size_t N>
+  static constexpr void link(E const& e, std::array<tape_step<Buffer>, N>& steps)
+  {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (
+        [&] {
+          using operand_type = operand_t<I>;
+          if constexpr (is_expression_v<operand_type>)
+          {
+            tape_steps<operand_type, operand_start<I>(), Buffer>::link(
+              std::get<I>(e.subexpressions()), steps);
+          }
+        }(),
+        ...);
+    }(std::make_index_sequence<std::tuple_size_v<expression_types>>{});
+    if constexpr (id < N)
+    {
+      steps[id] = {&step, std::addressof(e)};
+    }
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Deferred expression that evaluates the @ref expression_ nodes of @p Expression from a
+ * flat tape, without recursion.
+ *
+ * The @ref expression_ nodes are ordered so that each node follows its operands (post-order) and
+ * they are evaluated in a loop; results are stored in a buffer that has a slot per node and is
+ * allocated on the stack. Each node is evaluated by its own function, therefore the cost of
+ * evaluation grows linearly with the number of nodes instead of depending on how much the compiler
+ * inlines, and the stack depth does not grow with the depth of the tree.
+ *
+ * Other nodes (e.g., @ref variable_, @ref conditional_expression) are leaves of the tape and are
+ * evaluated as usual, when the node that they are operands of is evaluated.
+ *
+ * @tparam Expression Type of the expression.
+ */
+template<Deferred Expression>
+class tape_expression
+{
+  using expression_type = std::remove_cvref_t<Expression>;
+
+public:
+  using subexpression_types = std::tuple<Expression>;
+
+  /// @brief Number of steps, i.e., @ref expression_ nodes.
+  static constexpr std::size_t size = detail::tape_size_v<expression_type>;
+
+private:
+  using buffer_type = typename detail::tape_slots<expression_type>::type;
+  using root_steps  = detail::tape_steps<expression_type, 0, buffer_type>;
+
+  // the root is computed by operator() so that its result is returned directly
+  static constexpr std::size_t step_count = size > 0 ? size - 1 : 0;
+
+  Expression m_expression;
+  std::array<detail::tape_step<buffer_type>, step_count> m_steps{};
+
+  constexpr void link()
+  {
+    if constexpr (size > 0)
+    {
+      root_steps::link(m_expression, m_steps);
+    }
+  }
+
+public:
+  /**
+   * @brief Constructs a tape_expression.
+   * @tparam E Type of the expression.
+   * @param e Expression to evaluate.
+   */
+  template<typename E>
+    requires(!std::is_same_v<std::remove_cvref_t<E>, tape_expression>)
+  constexpr explicit tape_expression(E&& e) : m_expression(std::forward<E>(e))
+  {
+    link();
+  }
+
+  constexpr tape_expression(tape_expression const& other) : m_expression(other.m_expression)
+  {
+    link();
+  }
+
+  constexpr tape_expression(tape_expression&& other) noexcept(
+    std::is_nothrow_move_constructible_v<Expression>) :
+    m_expression(std::forward<Expression>(other.m_expression))
+  {
+    link();
+  }
+
+  tape_expression& operator=(tape_expression const&) = delete;
+  tape_expression& operator=(tape_expression&&)      = delete;
+
+  ~tape_expression() = default;
+
+  /// @brief Returns the expression.
+  [[nodiscard]] constexpr expression_type const& expression() const noexcept
+  {
+    return m_expression;
+  }
+
+  /**
+   * @brief Evaluates the expression.
+   * @return Result of the expression.
+   */
+  constexpr decltype(auto) operator()() const
+  {
+    if constexpr (size == 0)
+    {
+      return m_expression();
+    }
+    else
+    {
+      buffer_type buffer;
+      for (auto const& step : m_steps)
+      {
+        step.function(step.node, buffer);
+      }
+      return root_steps::compute(m_expression, buffer);
+    }
+  }
+
+  /**
+   * @brief Visits the tape expression with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    m_expression.visit(std::forward<Visitor>(v), nesting + 1);
+  }
+};
+
+/**
+ * @brief Creates a new @ref tape_expression that evaluates @p expr from a flat tape.
+ *
+ * It is intended for deep trees (e.g., generated code), for which recursive evaluation may not
+ * be inlined and results in deep call chains.
+ *
+ * Example:
+ * @code
+ * auto ex = compile(generated_expression(x)); // hundreds of nested operators
+ * ex();                                       // evaluates one node per iteration
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to evaluate.
+ * @return A @ref tape_expression for @p expr.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr auto compile(Expression&& expr)
+{
+  return tape_expression<make_deferred_t<Expression>>(std::forward<Expression>(expr));
+}
+
+} // namespace deferred
+
+#endif
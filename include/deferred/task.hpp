@@ -0,0 +1,513 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_TASK_HPP
+#define DEFERRED_TASK_HPP
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <semaphore>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace deferred {
+
+template<typename T>
+class task;
+
+namespace detail {
+
+/**
+ * @brief Common part of the promise of @ref task.
+ *
+ * When the coroutine finishes, it transfers execution to the coroutine that awaits it.
+ */
+class task_promise_base
+{
+  struct final_awaiter
+  {
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    template<typename Promise>
+    [[nodiscard]] std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> h) const noexcept
+    {
+      if (auto continuation = h.promise().m_continuation)
+      {
+        return continuation;
+      }
+      return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept
+    { }
+  };
+
+  std::coroutine_handle<> m_continuation;
+
+public:
+  [[nodiscard]] std::suspend_always initial_suspend() const noexcept
+  {
+    return {};
+  }
+
+  [[nodiscard]] final_awaiter final_suspend() const noexcept
+  {
+    return {};
+  }
+
+  /// @brief Sets the coroutine to resume when this one finishes.
+  void set_continuation(std::coroutine_handle<> continuation) noexcept
+  {
+    m_continuation = continuation;
+  }
+};
+
+/**
+ * @brief Promise of @ref task that stores a result of type @p T or an exception.
+ * @tparam T Type of the result, which may be a reference.
+ */
+template<typename T>
+class task_promise : public task_promise_base
+{
+  using stored_type =
+    std::conditional_t<std::is_reference_v<T>, std::remove_reference_t<T>*, std::remove_cv_t<T>>;
+
+  std::variant<std::monostate, stored_type, std::exception_ptr> m_result;
+
+public:
+  [[nodiscard]] task<T> get_return_object() noexcept;
+
+  template<typename U>
+    requires std::is_convertible_v<U&&, T>
+  void return_value(U&& u)
+  {
+    if constexpr (std::is_reference_v<T>)
+    {
+      m_result.template emplace<1>(std::addressof(static_cast<T>(std::forward<U>(u))));
+    }
+    else
+    {
+      m_result.template emplace<1>(std::forward<U>(u));
+    }
+  }
+
+  void unhandled_exception() noexcept
+  {
+    m_result.template emplace<2>(std::current_exception());
+  }
+
+  /// @brief Returns the result or rethrows the exception.
+  [[nodiscard]] T result()
+  {
+    if (m_result.index() == 2)
+    {
+      std::rethrow_exception(std::get<2>(m_result));
+    }
+    if constexpr (std::is_reference_v<T>)
+    {
+      return static_cast<T>(*std::get<1>(m_result));
+    }
+    else
+    {
+      return std::move(std::get<1>(m_result));
+    }
+  }
+};
+
+/// @brief Specialization for tasks without a result.
+template<>
+class task_promise<void> : public task_promise_base
+{
+  std::exception_ptr m_exception;
+
+public:
+  [[nodiscard]] task<void> get_return_object() noexcept;
+
+  void return_void() const noexcept
+  { }
+
+  void unhandled_exception() noexcept
+  {
+    m_exception = std::current_exception();
+  }
+
+  /// @brief Rethrows the exception, if any.
+  void result() const
+  {
+    if (m_exception)
+    {
+      std::rethrow_exception(m_exception);
+    }
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Lazily started coroutine that produces a result of type @p T.
+ *
+ * The coroutine starts when the task is awaited and resumes the awaiting coroutine when it
+ * finishes, on the thread it finished on. Exceptions are rethrown to the awaiting coroutine.
+ *
+ * @tparam T Type of the result, which may be a reference or @c void.
+ */
+template<typename T = void>
+class [[nodiscard]] task
+{
+public:
+  using value_type   = T;
+  using promise_type = detail::task_promise<T>;
+
+private:
+  std::coroutine_handle<promise_type> m_handle;
+
+  struct awaiter
+  {
+    std::coroutine_handle<promise_type> m_handle;
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+      return !m_handle || m_handle.done();
+    }
+
+    [[nodiscard]] std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<> continuation) const noexcept
+    {
+      m_handle.promise().set_continuation(continuation);
+      return m_handle;
+    }
+
+    decltype(auto) await_resume() const
+    {
+      return m_handle.promise().result();
+    }
+  };
+
+public:
+  constexpr task() noexcept = default;
+
+  explicit task(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle)
+  { }
+
+  task(task const&) = delete;
+
+  task(task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr))
+  { }
+
+  task& operator=(task const&) = delete;
+
+  task& operator=(task&& other) noexcept
+  {
+    if (this != &other)
+    {
+      if (m_handle)
+      {
+        m_handle.destroy();
+      }
+      m_handle = std::exchange(other.m_handle, nullptr);
+    }
+    return *this;
+  }
+
+  ~task()
+  {
+    if (m_handle)
+    {
+      m_handle.destroy();
+    }
+  }
+
+  /// @brief Returns the coroutine handle.
+  [[nodiscard]] std::coroutine_handle<promise_type> handle() const noexcept
+  {
+    return m_handle;
+  }
+
+  /// @brief Starts the task if it has not started and returns its result when it finishes.
+  auto operator co_await() const& noexcept
+  {
+    return awaiter{m_handle};
+  }
+};
+
+namespace detail {
+
+template<typename T>
+task<T> task_promise<T>::get_return_object() noexcept
+{
+  return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept
+{
+  return task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+/**
+ * @brief Receives the notification that a @ref completion_task finished.
+ */
+class completion_handler
+{
+public:
+  /// @brief Returns the coroutine to resume after the notification.
+  virtual std::coroutine_handle<> complete() noexcept = 0;
+
+protected:
+  ~completion_handler() = default;
+};
+
+/**
+ * @brief Coroutine that awaits a @ref task and then notifies a @ref completion_handler.
+ *
+ * The result of the task remains in the task, so it is retrieved after the notification.
+ */
+class completion_task
+{
+public:
+  struct promise_type
+  {
+    completion_handler* m_handler{};
+
+    struct final_awaiter
+    {
+      [[nodiscard]] bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      [[nodiscard]] std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<promise_type> h) const noexcept
+      {
+        // the frame may be destroyed as soon as the handler is notified
+        return h.promise().m_handler->complete();
+      }
+
+      void await_resume() const noexcept
+      { }
+    };
+
+    [[nodiscard]] completion_task get_return_object() noexcept
+    {
+      return completion_task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    [[nodiscard]] std::suspend_always initial_suspend() const noexcept
+    {
+      return {};
+    }
+
+    [[nodiscard]] final_awaiter final_suspend() const noexcept
+    {
+      return {};
+    }
+
+    void return_void() const noexcept
+    { }
+
+    [[noreturn]] void unhandled_exception() const noexcept
+    {
+      // the awaited task stores its exceptions, so there are none here
+      std::terminate();
+    }
+  };
+
+private:
+  std::coroutine_handle<promise_type> m_handle;
+
+public:
+  completion_task() noexcept = default;
+
+  explicit completion_task(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle)
+  { }
+
+  completion_task(completion_task&& other) noexcept :
+    m_handle(std::exchange(other.m_handle, nullptr))
+  { }
+
+  completion_task(completion_task const&)            = delete;
+  completion_task& operator=(completion_task const&) = delete;
+  completion_task& operator=(completion_task&&)      = delete;
+
+  ~completion_task()
+  {
+    if (m_handle)
+    {
+      m_handle.destroy();
+    }
+  }
+
+  /// @brief Starts the coroutine, which notifies @p handler when it finishes.
+  void start(completion_handler& handler) noexcept
+  {
+    m_handle.promise().m_handler = &handler;
+    m_handle.resume();
+  }
+};
+
+/// @brief Creates a @ref completion_task that awaits @p t without retrieving its result.
+template<typename T>
+completion_task make_completion_task(task<T> const& t)
+{
+  struct ignore_result
+  {
+    std::coroutine_handle<typename task<T>::promise_type> m_handle;
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+      return m_handle.done();
+    }
+
+    [[nodiscard]] std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<> continuation) const noexcept
+    {
+      m_handle.promise().set_continuation(continuation);
+      return m_handle;
+    }
+
+    void await_resume() const noexcept
+    { }
+  };
+  co_await ignore_result{t.handle()};
+}
+
+/// @brief Completion handler that releases a semaphore.
+class sync_wait_handler final : public completion_handler
+{
+  std::binary_semaphore m_done{0};
+
+public:
+  std::coroutine_handle<> complete() noexcept override
+  {
+    m_done.release();
+    return std::noop_coroutine();
+  }
+
+  void wait() noexcept
+  {
+    m_done.acquire();
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Starts @p t and blocks the calling thread until it finishes.
+ * @tparam T Type of the result.
+ * @param t Task to wait for.
+ * @return The result of @p t.
+ */
+template<typename T>
+T sync_wait(task<T> const& t)
+{
+  if (!t.handle().done())
+  {
+    auto completion = detail::make_completion_task(t);
+    detail::sync_wait_handler handler;
+    completion.start(handler);
+    handler.wait();
+  }
+  return t.handle().promise().result();
+}
+
+/// @copydoc sync_wait(task<T> const&)
+template<typename T>
+T sync_wait(task<T>&& t)
+{
+  return sync_wait(std::as_const(t));
+}
+
+/**
+ * @brief Awaitable that starts multiple tasks and resumes the awaiting coroutine when all of them
+ * have finished.
+ *
+ * The tasks are started one after the other on the awaiting thread; tasks that suspend (e.g.,
+ * waiting on another thread) proceed concurrently.
+ *
+ * @tparam T Types of the results of the tasks.
+ */
+template<typename... T>
+class when_all_awaitable final : private detail::completion_handler
+{
+  std::tuple<task<T>...> m_tasks;
+  std::array<detail::completion_task, sizeof...(T)> m_completions;
+  std::atomic<std::size_t> m_remaining{sizeof...(T) + 1};
+  std::coroutine_handle<> m_continuation;
+
+  std::coroutine_handle<> complete() noexcept override
+  {
+    if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      return m_continuation;
+    }
+    return std::noop_coroutine();
+  }
+
+public:
+  explicit when_all_awaitable(task<T>... tasks) :
+    m_tasks(std::move(tasks)...),
+    m_completions(std::apply(
+      [](auto const&... t) {
+        return std::array<detail::completion_task, sizeof...(T)>{
+          detail::make_completion_task(t)...};
+      },
+      m_tasks))
+  { }
+
+  when_all_awaitable(when_all_awaitable const&)            = delete;
+  when_all_awaitable(when_all_awaitable&&)                 = delete;
+  when_all_awaitable& operator=(when_all_awaitable const&) = delete;
+  when_all_awaitable& operator=(when_all_awaitable&&)      = delete;
+
+  ~when_all_awaitable() = default;
+
+  [[nodiscard]] bool await_ready() const noexcept
+  {
+    return sizeof...(T) == 0;
+  }
+
+  [[nodiscard]] bool await_suspend(std::coroutine_handle<> continuation) noexcept
+  {
+    m_continuation = continuation;
+    for (auto& c : m_completions)
+    {
+      c.start(*this);
+    }
+    // the awaiting coroutine resumes here if all tasks have already finished
+    return m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+  }
+
+  /// @brief Returns the results, rethrowing the exception of the first task that threw.
+  [[nodiscard]] std::tuple<T...> await_resume()
+  {
+    return std::apply(
+      [](auto const&... t) { return std::tuple<T...>{t.handle().promise().result()...}; },
+      m_tasks);
+  }
+};
+
+/**
+ * @brief Returns an awaitable that starts @p tasks... and produces the tuple of their results
+ * when all of them have finished.
+ *
+ * @tparam T Types of the results of the tasks, which must not be @c void.
+ * @param tasks Tasks to start.
+ */
+template<typename... T>
+[[nodiscard]] when_all_awaitable<T...> when_all(task<T>... tasks)
+{
+  return when_all_awaitable<T...>(std::move(tasks)...);
+}
+
+} // namespace deferred
+
+#endif
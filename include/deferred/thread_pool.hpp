@@ -0,0 +1,411 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_THREAD_POOL_HPP
+#define DEFERRED_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail/work_stealing_deque.hpp"
+
+namespace deferred {
+
+namespace detail {
+
+/// @brief Type-erased task that deletes itself after it is executed.
+class pool_task
+{
+public:
+  virtual ~pool_task() = default;
+
+  /// @brief Executes the task and deletes it.
+  virtual void run() = 0;
+};
+
+/// @brief Task that executes a callable of type @p F.
+template<typename F>
+class pool_task_impl final : public pool_task
+{
+  F m_f;
+
+public:
+  template<typename G>
+  explicit pool_task_impl(G&& g) : m_f(std::forward<G>(g))
+  { }
+
+  void run() override
+  {
+    std::unique_ptr<pool_task_impl> self(this);
+    m_f();
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Work-stealing pool of worker threads that execute submitted tasks.
+ *
+ * Each worker has its own @ref detail::work_stealing_deque. Tasks submitted from a worker are
+ * pushed to its deque and popped in LIFO order, while idle workers steal the oldest tasks from
+ * randomly selected victims. Tasks submitted from other threads go to a shared queue. Workers that
+ * find no tasks sleep until a task is submitted.
+ *
+ * Threads that wait for tasks to finish (e.g., in @ref fork_join) execute pending tasks while
+ * waiting, so that tasks can fork and join other tasks without deadlocking the pool.
+ */
+class thread_pool
+{
+  struct worker
+  {
+    detail::work_stealing_deque<detail::pool_task*> tasks;
+    std::uint64_t rng_state;
+
+    explicit worker(std::uint64_t seed) noexcept : rng_state(seed)
+    { }
+  };
+
+  /// Worker of the current thread, @c nullptr if it is not a worker thread.
+  static inline thread_local worker* s_worker = nullptr;
+  /// Pool of the current thread, @c nullptr if it is not a worker thread.
+  static inline thread_local thread_pool* s_pool = nullptr;
+
+  std::vector<std::unique_ptr<worker>> m_workers;
+
+  std::mutex m_queue_mutex;
+  std::deque<detail::pool_task*> m_queue;
+
+  // incremented on every submission, so that workers do not miss a task while going to sleep
+  std::atomic<std::uint64_t> m_epoch{0};
+  std::atomic<std::size_t> m_sleepers{0};
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_sleep_cv;
+  bool m_stop{false};
+
+  std::vector<std::jthread> m_threads;
+
+  /// @brief Returns the worker of the calling thread if it belongs to this pool.
+  [[nodiscard]] worker* current_worker() const noexcept
+  {
+    return s_pool == this ? s_worker : nullptr;
+  }
+
+  [[nodiscard]] detail::pool_task* pop_queue()
+  {
+    std::lock_guard lock(m_queue_mutex);
+    if (m_queue.empty())
+    {
+      return nullptr;
+    }
+    auto* task = m_queue.front();
+    m_queue.pop_front();
+    return task;
+  }
+
+  /// @brief Steals a task, starting from a random victim.
+  [[nodiscard]] detail::pool_task* steal(worker* self) noexcept
+  {
+    auto const n = m_workers.size();
+    std::size_t start = 0;
+    if (self != nullptr)
+    {
+      // xorshift64
+      auto& x = self->rng_state;
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      start = static_cast<std::size_t>(x % n);
+    }
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      auto& victim = *m_workers[(start + i) % n];
+      if (&victim == self)
+      {
+        continue;
+      }
+      if (auto* task = victim.tasks.steal())
+      {
+        return task;
+      }
+    }
+    return nullptr;
+  }
+
+  /// @brief Finds a task for @p self from its own deque, other workers, or the shared queue.
+  [[nodiscard]] detail::pool_task* find_task(worker* self)
+  {
+    if (self != nullptr)
+    {
+      if (auto* task = self->tasks.pop())
+      {
+        return task;
+      }
+    }
+    if (auto* task = steal(self))
+    {
+      return task;
+    }
+    return pop_queue();
+  }
+
+  void work(std::size_t index)
+  {
+    s_worker = m_workers[index].get();
+    s_pool   = this;
+    while (true)
+    {
+      auto const epoch = m_epoch.load();
+      if (auto* task = find_task(s_worker))
+      {
+        task->run();
+        continue;
+      }
+      std::unique_lock lock(m_sleep_mutex);
+      if (m_stop)
+      {
+        return;
+      }
+      ++m_sleepers;
+      m_sleep_cv.wait(lock, [&] { return m_stop || m_epoch.load() != epoch; });
+      --m_sleepers;
+    }
+  }
+
+  void push(detail::pool_task* task)
+  {
+    if (auto* self = current_worker())
+    {
+      self->tasks.push(task);
+    }
+    else
+    {
+      std::lock_guard lock(m_queue_mutex);
+      m_queue.push_back(task);
+    }
+    ++m_epoch;
+    if (m_sleepers.load() != 0)
+    {
+      std::lock_guard lock(m_sleep_mutex);
+      m_sleep_cv.notify_one();
+    }
+  }
+
+public:
+  /// @brief Returns the default number of worker threads.
+  [[nodiscard]] static std::size_t default_concurrency() noexcept
+  {
+    return std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  /**
+   * @brief Constructs a thread_pool with @p n worker threads.
+   * @param n Number of worker threads.
+   */
+  explicit thread_pool(std::size_t n = default_concurrency())
+  {
+    m_workers.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      m_workers.push_back(std::make_unique<worker>(0x9e3779b97f4a7c15 * (i + 1)));
+    }
+    m_threads.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      m_threads.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  thread_pool(thread_pool const&)            = delete;
+  thread_pool(thread_pool&&)                 = delete;
+  thread_pool& operator=(thread_pool const&) = delete;
+  thread_pool& operator=(thread_pool&&)      = delete;
+
+  /// @brief Executes the pending tasks and joins the worker threads.
+  ~thread_pool()
+  {
+    {
+      std::lock_guard lock(m_sleep_mutex);
+      m_stop = true;
+    }
+    m_sleep_cv.notify_all();
+    m_threads.clear();
+    // tasks that were submitted after the workers stopped looking for them
+    while (auto* task = find_task(nullptr))
+    {
+      task->run();
+    }
+  }
+
+  /// @brief Returns the number of worker threads.
+  [[nodiscard]] std::size_t size() const noexcept
+  {
+    return m_workers.size();
+  }
+
+  /**
+   * @brief Submits @p f for execution.
+   *
+   * @p f must not throw.
+   *
+   * @tparam F Type of the task.
+   * @param f Task to execute.
+   */
+  template<typename F>
+  void submit(F&& f)
+  {
+    auto task = std::make_unique<detail::pool_task_impl<std::decay_t<F>>>(std::forward<F>(f));
+    push(task.get());
+    task.release();
+  }
+
+  /**
+   * @brief Executes a pending task on the calling thread.
+   *
+   * Worker threads execute their most recent task first, while other threads steal.
+   *
+   * @return @c true if a task was executed, @c false if there were no pending tasks.
+   */
+  bool run_pending_task()
+  {
+    auto* task = find_task(current_worker());
+    if (task == nullptr)
+    {
+      return false;
+    }
+    task->run();
+    return true;
+  }
+};
+
+/**
+ * @brief Returns the thread pool that is shared by the library.
+ */
+[[nodiscard]] inline thread_pool& default_thread_pool()
+{
+  static thread_pool pool;
+  return pool;
+}
+
+namespace detail {
+
+/**
+ * @brief Shared state of a @ref fork_join that counts the unfinished tasks and stores the first
+ * exception.
+ */
+class join_state
+{
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::size_t m_remaining;
+  std::exception_ptr m_exception;
+
+public:
+  explicit join_state(std::size_t n) noexcept : m_remaining(n)
+  { }
+
+  /// @brief Runs @p f, storing its exception if it is the first one.
+  template<typename F>
+  void run(F& f) noexcept
+  {
+    try
+    {
+      f();
+    }
+    catch (...)
+    {
+      std::lock_guard lock(m_mutex);
+      if (!m_exception)
+      {
+        m_exception = std::current_exception();
+      }
+    }
+  }
+
+  /// @brief Marks a task as finished.
+  void finish() noexcept
+  {
+    // notifying while holding the lock guarantees that the waiting thread has not destroyed this
+    std::lock_guard lock(m_mutex);
+    if (--m_remaining == 0)
+    {
+      m_cv.notify_all();
+    }
+  }
+
+  /**
+   * @brief Waits for all tasks to finish, executing pending tasks of @p pool while there are any,
+   * and rethrows the first exception.
+   */
+  void join(thread_pool& pool)
+  {
+    std::unique_lock lock(m_mutex);
+    while (m_remaining != 0)
+    {
+      lock.unlock();
+      auto const executed = pool.run_pending_task();
+      lock.lock();
+      if (!executed)
+      {
+        // the unfinished tasks are executing on other threads
+        m_cv.wait(lock, [this] { return m_remaining == 0; });
+      }
+    }
+    if (m_exception)
+    {
+      std::rethrow_exception(m_exception);
+    }
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Executes @p f... concurrently on @p pool and waits for all of them to finish.
+ *
+ * The first callable is executed on the calling thread, which also executes pending tasks of
+ * @p pool while waiting for the rest. If any of @p f... throws, the first exception is rethrown
+ * after all of them have finished.
+ *
+ * @tparam F Types of the callables.
+ * @param pool Thread pool to execute the callables on.
+ * @param f Callables to execute.
+ */
+template<typename... F>
+void fork_join(thread_pool& pool, F&&... f)
+{
+  if constexpr (sizeof...(F) == 1)
+  {
+    (std::forward<F>(f)(), ...);
+  }
+  else
+  {
+    detail::join_state state(sizeof...(F) - 1);
+    // all but the first callable are submitted to the pool
+    auto fs = std::forward_as_tuple(f...);
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (pool.submit([&state, &g = std::get<I + 1>(fs)] {
+        state.run(g);
+        state.finish();
+      }),
+       ...);
+    }(std::make_index_sequence<sizeof...(F) - 1>{});
+    state.run(std::get<0>(fs));
+    state.join(pool);
+  }
+}
+
+} // namespace deferred
+
+#endif
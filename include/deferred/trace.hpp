@@ -0,0 +1,461 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_TRACE_HPP
+#define DEFERRED_TRACE_HPP
+
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail/node_label.hpp"
+#include "detail/trace_ring.hpp"
+#include "expression.hpp"
+#include "transform.hpp"
+#include "type_traits/is_pure_expression.hpp"
+
+namespace deferred {
+
+/**
+ * @brief Event of a @ref tracer.
+ */
+struct trace_event
+{
+  /// @brief Label of the node: its operator, @c if_, @c switch_, @c while_, or its type.
+  std::string_view name;
+  /// @brief Time since the construction of the tracer, in nanoseconds.
+  std::int64_t timestamp;
+  /// @brief Nesting level of the node, as passed to the visitors of the expression.
+  std::uint32_t nesting;
+  /// @brief @c 'B' when the evaluation of the node begins, @c 'E' when it ends.
+  char phase;
+};
+
+namespace detail {
+
+/// @brief Appends @p s to @p out as a JSON string.
+inline void append_json_string(std::string& out, std::string_view s)
+{
+  constexpr char hex[] = "0123456789abcdef";
+  out += '"';
+  for (auto const c : s)
+  {
+    if (c == '"' || c == '\\')
+    {
+      out += '\\';
+      out += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      out += "\\u00";
+      out += hex[(c >> 4) & 0xf];
+      out += hex[c & 0xf];
+    }
+    else
+    {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+/// @brief Appends the integer @p i to @p out.
+template<typename T>
+void append_integer(std::string& out, T i)
+{
+  char buffer[24];
+  auto const result = std::to_chars(buffer, buffer + sizeof(buffer), i);
+  out.append(buffer, result.ptr);
+}
+
+} // namespace detail
+
+/**
+ * @brief Records the begin and end events of the nodes of traced expressions (see @ref traced_())
+ * and exports them in the Chrome trace event format, which can be viewed in Perfetto or
+ * @c chrome://tracing.
+ *
+ * Each thread records in its own ring buffer, which is created the first time the thread records
+ * an event; recording neither blocks nor allocates afterwards. When a buffer is full, the oldest
+ * events of the thread are overwritten.
+ *
+ * The tracer must outlive the expressions that record to it, and the events must not be exported
+ * while expressions are evaluated.
+ */
+class tracer
+{
+  struct buffer
+  {
+    detail::trace_ring<trace_event> events;
+    std::thread::id thread;
+    std::uint32_t id;
+
+    buffer(std::size_t capacity, std::thread::id t, std::uint32_t i) :
+      events(capacity), thread(t), id(i)
+    { }
+  };
+
+  struct thread_cache
+  {
+    std::uint64_t tracer;
+    buffer* events;
+  };
+
+  /// Source of unique tracer identifiers, so that buffers of destroyed tracers are not reused.
+  static inline std::atomic<std::uint64_t> s_next_id{1};
+  /// Buffer of the tracer that the current thread recorded to last; zero-initialized.
+  static inline thread_local thread_cache s_cache;
+
+  using clock = std::chrono::steady_clock;
+
+  std::uint64_t m_id{s_next_id.fetch_add(1, std::memory_order_relaxed)};
+  std::size_t m_capacity;
+  clock::time_point m_start{clock::now()};
+  mutable std::mutex m_mutex;
+  std::vector<std::unique_ptr<buffer>> m_buffers;
+
+  /// @brief Returns the buffer of the calling thread, creating it if necessary.
+  [[nodiscard]] buffer& thread_buffer()
+  {
+    if (s_cache.tracer != m_id)
+    {
+      auto const id = std::this_thread::get_id();
+      std::lock_guard lock{m_mutex};
+      buffer* b = nullptr;
+      for (auto const& p : m_buffers)
+      {
+        if (p->thread == id)
+        {
+          b = p.get();
+          break;
+        }
+      }
+      if (b == nullptr)
+      {
+        m_buffers.push_back(std::make_unique<buffer>(
+          m_capacity, id, static_cast<std::uint32_t>(m_buffers.size())));
+        b = m_buffers.back().get();
+      }
+      s_cache = {m_id, b};
+    }
+    return *s_cache.events;
+  }
+
+public:
+  /// @brief Default number of events per thread.
+  static constexpr std::size_t default_capacity = 1 << 16;
+
+  /**
+   * @brief Constructs a tracer.
+   * @param capacity Number of events per thread, which is rounded up to a power of two.
+   */
+  explicit tracer(std::size_t capacity = default_capacity) :
+    m_capacity(std::bit_ceil(capacity == 0 ? std::size_t{1} : capacity))
+  { }
+
+  tracer(tracer const&)            = delete;
+  tracer& operator=(tracer const&) = delete;
+
+  /**
+   * @brief Records an event for the calling thread.
+   * @param name Name of the node, which must outlive the tracer.
+   * @param nesting Nesting level of the node.
+   * @param phase @c 'B' or @c 'E'.
+   */
+  void record(std::string_view name, std::uint32_t nesting, char phase)
+  {
+    auto const timestamp =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - m_start).count();
+    thread_buffer().events.push({name, timestamp, nesting, phase});
+  }
+
+  /// @brief Returns the number of events that have been overwritten in all threads.
+  [[nodiscard]] std::uint64_t dropped() const
+  {
+    std::lock_guard lock{m_mutex};
+    std::uint64_t n = 0;
+    for (auto const& b : m_buffers)
+    {
+      n += b->events.dropped();
+    }
+    return n;
+  }
+
+  /**
+   * @brief Returns the recorded events of each thread, from the oldest to the newest.
+   *
+   * The thread identifiers are the indices of the result, in the order threads recorded their
+   * first event.
+   */
+  [[nodiscard]] std::vector<std::vector<trace_event>> events() const
+  {
+    std::lock_guard lock{m_mutex};
+    std::vector<std::vector<trace_event>> result(m_buffers.size());
+    for (auto const& b : m_buffers)
+    {
+      b->events.for_each([&](trace_event const& e) { result[b->id].push_back(e); });
+    }
+    return result;
+  }
+
+  /**
+   * @brief Returns the recorded events in the Chrome trace event JSON format.
+   *
+   * End events whose begin event has been overwritten are omitted. Timestamps are in microseconds
+   * since the construction of the tracer.
+   */
+  [[nodiscard]] std::string chrome_trace() const
+  {
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first      = true;
+    auto const all  = events();
+    for (std::uint32_t tid = 0; tid < all.size(); ++tid)
+    {
+      std::size_t depth = 0;
+      for (auto const& e : all[tid])
+      {
+        if (e.phase == 'E')
+        {
+          if (depth == 0)
+          {
+            continue;
+          }
+          --depth;
+        }
+        else
+        {
+          ++depth;
+        }
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += "{\"name\":";
+        detail::append_json_string(out, e.name);
+        out += ",\"cat\":\"deferred\",\"ph\":\"";
+        out += e.phase;
+        out += "\",\"ts\":";
+        detail::append_integer(out, e.timestamp / 1000);
+        out += '.';
+        auto const fraction = e.timestamp % 1000;
+        out += static_cast<char>('0' + fraction / 100);
+        out += static_cast<char>('0' + fraction / 10 % 10);
+        out += static_cast<char>('0' + fraction % 10);
+        out += ",\"pid\":0,\"tid\":";
+        detail::append_integer(out, tid);
+        out += ",\"args\":{\"nesting\":";
+        detail::append_integer(out, e.nesting);
+        out += "}}";
+      }
+    }
+    out += "\n]}\n";
+    return out;
+  }
+};
+
+template<Deferred Expression>
+class traced_expression;
+
+namespace detail {
+
+/// @brief Sets the nesting level of @ref traced_expression nodes.
+struct trace_access
+{
+  template<typename Expression>
+  static constexpr void set_nesting(traced_expression<Expression> const& e,
+                                    std::size_t nesting) noexcept
+  {
+    e.m_nesting = static_cast<std::uint32_t>(nesting);
+  }
+};
+
+/// @brief Records the end event of a node when it is destroyed.
+class trace_scope
+{
+  tracer& m_tracer;
+  std::string_view m_name;
+  std::uint32_t m_nesting;
+
+public:
+  trace_scope(tracer& t, std::string_view name, std::uint32_t nesting) :
+    m_tracer(t), m_name(name), m_nesting(nesting)
+  {
+    m_tracer.record(m_name, m_nesting, 'B');
+  }
+
+  trace_scope(trace_scope const&)            = delete;
+  trace_scope& operator=(trace_scope const&) = delete;
+
+  ~trace_scope()
+  {
+    m_tracer.record(m_name, m_nesting, 'E');
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Deferred expression that records the begin and end of the evaluation of @p Expression
+ * to a @ref tracer.
+ *
+ * It is created by @ref traced_() for each @ref expression_, @ref logical_expression,
+ * @ref conditional_expression, @ref switch_expression, and @ref while_expression node of an
+ * expression. Visitors visit @p Expression with the same nesting level as the traced expression.
+ *
+ * @tparam Expression Type of the expression.
+ */
+template<Deferred Expression>
+class traced_expression
+{
+  friend struct detail::trace_access;
+
+public:
+  using expression_type     = Expression;
+  using subexpression_types = std::tuple<Expression>;
+
+private:
+  Expression m_expression;
+  tracer* m_tracer;
+  // set by traced_() from the visitor of the whole expression
+  mutable std::uint32_t m_nesting{};
+
+public:
+  /**
+   * @brief Constructs a traced_expression.
+   * @tparam E Type of the expression.
+   * @param e Expression to trace.
+   * @param t Tracer to record to.
+   */
+  template<typename E>
+  constexpr traced_expression(E&& e, tracer& t) : m_expression(std::forward<E>(e)), m_tracer(&t)
+  { }
+
+  /// @brief Returns the traced expression.
+  [[nodiscard]] constexpr Expression const& expression() const noexcept
+  {
+    return m_expression;
+  }
+
+  /// @brief Returns the nesting level that is recorded with the events.
+  [[nodiscard]] constexpr std::size_t nesting() const noexcept
+  {
+    return m_nesting;
+  }
+
+  /**
+   * @brief Evaluates the expression and records its begin and end.
+   * @return Result of the expression.
+   */
+  [[nodiscard]] decltype(auto) operator()() const&
+  {
+    detail::trace_scope scope(*m_tracer, detail::node_label_v<Expression>, m_nesting);
+    return m_expression();
+  }
+
+  /// @copydoc operator()() const&
+  [[nodiscard]] decltype(auto) operator()() &&
+  {
+    detail::trace_scope scope(*m_tracer, detail::node_label_v<Expression>, m_nesting);
+    return std::forward<Expression>(m_expression)();
+  }
+
+  /**
+   * @brief Visits the traced expression with a visitor.
+   * @tparam Visitor Type of the visitor.
+   * @param v The visitor.
+   * @param nesting Nesting level.
+   */
+  template<typename Visitor>
+  constexpr void visit(Visitor&& v, std::size_t nesting = 0) const
+  {
+    std::forward<Visitor>(v)(*this, nesting);
+    m_expression.visit(std::forward<Visitor>(v), nesting);
+  }
+};
+
+/// @brief Specialization for @ref traced_expression, which records events.
+template<typename Expression>
+struct is_stateful_expression<traced_expression<Expression>> : public std::true_type
+{ };
+
+namespace detail {
+
+/// @brief Checks if @p T is a @ref traced_expression.
+template<typename T>
+inline constexpr bool is_traced_expression_v = false;
+
+/// @brief Specialization for @ref traced_expression.
+template<typename Expression>
+inline constexpr bool is_traced_expression_v<traced_expression<Expression>> = true;
+
+/// @brief Rule of @ref transform that wraps nodes in a @ref traced_expression.
+struct trace_rule
+{
+  tracer* t;
+
+  template<typename Node>
+    requires is_rebuildable_v<Node>
+  constexpr auto operator()(Node const& node) const
+  {
+    return traced_expression<Node>(node, *t);
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Creates a copy of @p expr in which each node records its evaluation to @p t.
+ *
+ * Each @ref expression_, @ref logical_expression, @ref conditional_expression,
+ * @ref switch_expression, and @ref while_expression node is wrapped in a @ref traced_expression
+ * that records a begin and an end event with the label of the node, its nesting level, and the
+ * evaluating thread. Operations are labeled with the type of their operator and control flow nodes
+ * with the function that creates them (@c if_, @c switch_, @c while_), so that labels do not grow
+ * with the size of the subexpressions. Subexpressions that are evaluated on other threads (e.g., by
+ * @ref parallel_expression) are recorded to the buffers of those threads.
+ *
+ * If @c DEFERRED_DISABLE_TRACING is defined, @p expr is returned as it is and nothing is recorded.
+ *
+ * Example:
+ * @code
+ * tracer t;
+ * auto ex = traced_(rules, t);
+ * ex();
+ * write_file("trace.json", t.chrome_trace());
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @param expr Expression to trace.
+ * @param t Tracer to record to, which must outlive the result.
+ * @return The traced expression.
+ */
+template<Deferred Expression>
+[[nodiscard]] constexpr decltype(auto) traced_(Expression&& expr, [[maybe_unused]] tracer& t)
+{
+#ifdef DEFERRED_DISABLE_TRACING
+  return static_cast<make_deferred_t<Expression>>(std::forward<Expression>(expr));
+#else
+  decltype(auto) result = transform(std::forward<Expression>(expr), detail::trace_rule{&t});
+  result.visit([]<typename Node>(Node const& node, std::size_t nesting) {
+    if constexpr (detail::is_traced_expression_v<Node>)
+    {
+      detail::trace_access::set_nesting(node, nesting);
+    }
+  });
+  return result;
+#endif
+}
+
+} // namespace deferred
+
+#endif
@@ -0,0 +1,402 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_TRANSFORM_HPP
+#define DEFERRED_TRANSFORM_HPP
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "conditional.hpp"
+#include "constant.hpp"
+#include "expression.hpp"
+#include "logical.hpp"
+#include "nary.hpp"
+#include "switch.hpp"
+#include "variable.hpp"
+#include "while.hpp"
+
+namespace deferred {
+
+/**
+ * @brief Returns the @p I-th operand of the @ref expression_ or @ref logical_expression @p e as it
+ * is stored, i.e., a reference if @p e references it and a copy if @p e owns it.
+ *
+ * Rules of @ref transform should use it to build replacement nodes, as the nodes they are invoked
+ * with are temporaries.
+ *
+ * @tparam I Index of the operand.
+ * @tparam E Type of the expression.
+ * @param e Expression.
+ * @return The @p I-th operand.
+ */
+template<std::size_t I, typename E>
+[[nodiscard]] constexpr decltype(auto) operand(E const& e)
+{
+  using operand_type = std::tuple_element_t<I, typename E::expression_types>;
+  if constexpr (std::is_lvalue_reference_v<operand_type>)
+  {
+    return static_cast<operand_type>(std::get<I>(e.subexpressions()));
+  }
+  else
+  {
+    return operand_type(std::get<I>(e.subexpressions()));
+  }
+}
+
+/**
+ * @brief Patterns that match nodes by their kind.
+ *
+ * Any other type used as a pattern matches nodes of exactly that type.
+ */
+namespace pattern {
+
+/// @brief Matches any node.
+struct any
+{ };
+
+/// @brief Matches a @ref constant_.
+struct constant
+{ };
+
+/// @brief Matches a @ref variable_.
+struct variable
+{ };
+
+/**
+ * @brief Matches an @ref expression_ or a @ref logical_expression with operator @p Operator whose
+ * operands match @p Operands....
+ *
+ * Chains of an associative @p Operator (e.g., <tt>a + b + c</tt>) are matched with all their
+ * operands; chains longer than @ref max_nary_operands are nested.
+ */
+template<typename Operator, typename... Operands>
+struct operation
+{ };
+
+/// @brief Matches nodes of type @c T for which @c Trait<T>::value is @c true.
+template<template<typename> class Trait>
+struct satisfies
+{ };
+
+} // namespace pattern
+
+/**
+ * @brief Checks if the node @p T matches @p Pattern.
+ * @tparam Pattern The pattern.
+ * @tparam T The type to check.
+ */
+template<typename Pattern, typename T>
+struct matches : public std::is_same<Pattern, T>
+{ };
+
+/// @brief Specialization for @ref pattern::any.
+template<typename T>
+struct matches<pattern::any, T> : public std::true_type
+{ };
+
+/// @brief Specialization for @ref pattern::constant.
+template<typename T>
+struct matches<pattern::constant, constant_<T>> : public std::true_type
+{ };
+
+/// @brief Specialization for @ref pattern::variable.
+template<typename T>
+struct matches<pattern::variable, variable_<T>> : public std::true_type
+{ };
+
+/// @brief Specialization for @ref pattern::operation and @ref expression_.
+template<typename Operator, typename... Operands, typename... Expressions>
+  requires(sizeof...(Operands) == sizeof...(Expressions))
+struct matches<pattern::operation<Operator, Operands...>, expression_<Operator, Expressions...>> :
+  public std::conjunction<matches<Operands, std::remove_cvref_t<Expressions>>...>
+{ };
+
+/// @brief Specialization for @ref pattern::operation and @ref expression_ with @ref nary_operator.
+template<typename Operator, typename... Operands, typename... Expressions>
+  requires(sizeof...(Operands) == sizeof...(Expressions))
+struct matches<pattern::operation<Operator, Operands...>,
+               expression_<nary_operator<Operator>, Expressions...>> :
+  public std::conjunction<matches<Operands, std::remove_cvref_t<Expressions>>...>
+{ };
+
+/// @brief Specialization for @ref pattern::operation and @ref logical_expression.
+template<typename Operator, typename... Operands, typename... Expressions>
+  requires(sizeof...(Operands) == sizeof...(Expressions))
+struct matches<pattern::operation<Operator, Operands...>,
+               logical_expression<Operator, Expressions...>> :
+  public std::conjunction<matches<Operands, std::remove_cvref_t<Expressions>>...>
+{ };
+
+/// @brief Specialization for @ref pattern::satisfies.
+template<template<typename> class Trait, typename T>
+struct matches<pattern::satisfies<Trait>, T> : public std::bool_constant<Trait<T>::value>
+{ };
+
+/**
+ * @brief Alias for @c matches::value.
+ * @tparam Pattern The pattern.
+ * @tparam T The type to check.
+ */
+template<typename Pattern, typename T>
+inline constexpr bool matches_v = matches<Pattern, std::remove_cvref_t<T>>::value;
+
+/**
+ * @brief Rule of @ref transform that replaces the nodes that match @p Pattern with the result of
+ * @p F.
+ * @tparam Pattern The pattern.
+ * @tparam F Type of the callable that creates the replacement node.
+ */
+template<typename Pattern, typename F>
+class rule
+{
+  [[no_unique_address]] F m_f;
+
+public:
+  /**
+   * @brief Constructs a rule.
+   * @tparam G Type of the callable.
+   * @param g Callable that creates the replacement node.
+   */
+  template<typename G>
+  constexpr explicit rule(G&& g) : m_f(std::forward<G>(g))
+  { }
+
+  /// @brief Returns the replacement node for @p node.
+  template<typename Node>
+    requires matches_v<Pattern, Node>
+  constexpr decltype(auto) operator()(Node const& node) const
+  {
+    return std::invoke(m_f, node);
+  }
+};
+
+/**
+ * @brief Creates a @ref rule that replaces the nodes that match @p Pattern with the result of
+ * @p f.
+ * @tparam Pattern The pattern.
+ * @tparam F Type of the callable.
+ * @param f Callable that is invoked with a matching node and returns its replacement.
+ * @return A @ref rule for @p Pattern.
+ */
+template<typename Pattern, typename F>
+[[nodiscard]] constexpr auto make_rule(F&& f)
+{
+  return rule<Pattern, std::decay_t<F>>(std::forward<F>(f));
+}
+
+namespace detail {
+
+template<typename Stored, typename Node, typename... Rules>
+constexpr decltype(auto) transform_impl(Node&& node, Rules const&... rules);
+
+/// @brief Returns @p node as it is stored if none of the rules is invocable with it.
+template<typename Node>
+constexpr decltype(auto) apply_rules(Node&& node)
+{
+  if constexpr (std::is_lvalue_reference_v<Node>)
+  {
+    return static_cast<Node>(node);
+  }
+  else
+  {
+    return std::remove_cvref_t<Node>(std::move(node));
+  }
+}
+
+/// @brief Invokes the first of @p rule, @p rules... that is invocable with @p node.
+template<typename Node, typename Rule, typename... Rules>
+constexpr decltype(auto) apply_rules(Node&& node, Rule const& rule, Rules const&... rules)
+{
+  if constexpr (std::is_invocable_v<Rule const&, std::remove_cvref_t<Node> const&>)
+  {
+    return std::invoke(rule, std::as_const(node));
+  }
+  else
+  {
+    return apply_rules(std::forward<Node>(node), rules...);
+  }
+}
+
+/// @brief Checks if the children of @p T are transformed.
+template<typename T>
+inline constexpr bool is_rebuildable_v = false;
+
+template<typename Operator, typename... Expressions>
+inline constexpr bool is_rebuildable_v<expression_<Operator, Expressions...>> = true;
+
+template<typename Operator, typename... Expressions>
+inline constexpr bool is_rebuildable_v<logical_expression<Operator, Expressions...>> = true;
+
+template<typename Else, typename... Branches>
+inline constexpr bool is_rebuildable_v<conditional_expression<Else, Branches...>> = true;
+
+template<typename Condition, typename Default, typename... Cases>
+inline constexpr bool is_rebuildable_v<switch_expression<Condition, Default, Cases...>> = true;
+
+template<typename Condition, typename Body>
+inline constexpr bool is_rebuildable_v<while_expression<Condition, Body>> = true;
+
+/// @brief Type of transforming the node @p Node, which is stored as @p Stored.
+template<typename Stored, typename Node, typename... Rules>
+using transformed_t =
+  decltype(transform_impl<Stored>(std::declval<Node>(), std::declval<Rules const&>()...));
+
+/// @brief Rebuilds an @ref expression_ or @ref logical_expression with transformed operands.
+template<template<typename, typename...> class Operation,
+         typename Operator,
+         typename... Expressions,
+         typename... Rules>
+constexpr auto rebuild(Operation<Operator, Expressions...> const& e, Rules const&... rules)
+{
+  auto const& operands = e.subexpressions();
+  return [&]<std::size_t... I>(std::index_sequence<I...>) {
+    using rebuilt_type =
+      Operation<Operator,
+                transformed_t<Expressions, decltype(std::get<I>(operands)), Rules...>...>;
+    return rebuilt_type(e.operator_(),
+                        transform_impl<Expressions>(std::get<I>(operands), rules...)...);
+  }(std::index_sequence_for<Expressions...>{});
+}
+
+/// @brief Rebuilds a @ref conditional_expression with transformed branches.
+template<typename Else, typename... Branches, typename... Rules>
+constexpr auto rebuild(conditional_expression<Else, Branches...> const& e, Rules const&... rules)
+{
+  auto rebuild_branch = [&rules...]<typename Branch>(Branch const& branch) {
+    using condition_type = typename Branch::condition_type;
+    using then_type      = typename Branch::then_type;
+    using rebuilt_type =
+      conditional_branch<transformed_t<condition_type, decltype((branch.condition)), Rules...>,
+                         transformed_t<then_type, decltype((branch.then)), Rules...>>;
+    return rebuilt_type{transform_impl<condition_type>(branch.condition, rules...),
+                        transform_impl<then_type>(branch.then, rules...)};
+  };
+  return flat_apply(
+    [&](auto const&... branches) {
+      using branches_type = flat_tuple<decltype(rebuild_branch(branches))...>;
+      if constexpr (!conditional_expression<Else, Branches...>::finalized)
+      {
+        return conditional_expression<no_else<>, decltype(rebuild_branch(branches))...>(
+          branches_type(std::in_place, rebuild_branch(branches)...));
+      }
+      else
+      {
+        using else_type = transformed_t<Else, decltype(e.else_branch()), Rules...>;
+        return conditional_expression<else_type, decltype(rebuild_branch(branches))...>(
+          branches_type(std::in_place, rebuild_branch(branches)...),
+          transform_impl<Else>(e.else_branch(), rules...));
+      }
+    },
+    e.branches());
+}
+
+/// @brief Rebuilds a @ref switch_expression with transformed condition and cases.
+template<typename Condition, typename Default, typename... Cases, typename... Rules>
+constexpr auto rebuild(switch_expression<Condition, Default, Cases...> const& e,
+                       Rules const&... rules)
+{
+  using default_body_type = typename Default::body_type;
+  using default_type      = default_expression<
+    transformed_t<default_body_type, decltype(detail::get<0>(e.cases()).body()), Rules...>>;
+  auto rebuild_case = [&rules...]<typename Case>(Case const& c) {
+    using label_type = typename Case::label_expression_type;
+    using body_type  = typename Case::body_expression_type;
+    using rebuilt_type =
+      case_expression<transformed_t<label_type, decltype(c.label()), Rules...>,
+                      transformed_t<body_type, decltype(c.body()), Rules...>>;
+    return rebuilt_type(transform_impl<label_type>(c.label(), rules...),
+                        transform_impl<body_type>(c.body(), rules...));
+  };
+  return flat_apply(
+    [&](auto const& df, auto const&... cases) {
+      return switch_expression<transformed_t<Condition, decltype(e.condition()), Rules...>,
+                               default_type,
+                               decltype(rebuild_case(cases))...>(
+        transform_impl<Condition>(e.condition(), rules...),
+        default_type(transform_impl<default_body_type>(df.body(), rules...)),
+        rebuild_case(cases)...);
+    },
+    e.cases());
+}
+
+/// @brief Rebuilds a @ref while_expression with transformed condition and body.
+template<typename Condition, typename Body, typename... Rules>
+constexpr auto rebuild(while_expression<Condition, Body> const& e, Rules const&... rules)
+{
+  return while_expression<transformed_t<Condition, decltype(e.condition()), Rules...>,
+                          transformed_t<Body, decltype(e.body()), Rules...>>(
+    transform_impl<Condition>(e.condition(), rules...),
+    transform_impl<Body>(e.body(), rules...));
+}
+
+/**
+ * @brief Transforms @p node, which is stored as @p Stored.
+ *
+ * Nodes whose children are not transformed keep the type they are stored as, i.e., referenced
+ * nodes remain references and owned nodes are copied.
+ */
+template<typename Stored, typename Node, typename... Rules>
+constexpr decltype(auto) transform_impl(Node&& node, Rules const&... rules)
+{
+  using node_type = std::remove_cvref_t<Node>;
+  if constexpr (is_rebuildable_v<node_type>)
+  {
+    return apply_rules(rebuild(node, rules...), rules...);
+  }
+  else if constexpr (std::is_lvalue_reference_v<Stored>)
+  {
+    return apply_rules(static_cast<Stored>(node), rules...);
+  }
+  else
+  {
+    return apply_rules(node_type(node), rules...);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Transforms @p expr bottom-up with @p rules....
+ *
+ * The children of @ref expression_, @ref logical_expression, @ref conditional_expression,
+ * @ref switch_expression, and @ref while_expression nodes are transformed first, and the node is
+ * rebuilt from them. Then, the first of @p rules that is invocable with the node (e.g., a
+ * @ref rule whose pattern matches it, or a constrained callable) replaces it with the node it
+ * returns. Each node is transformed once; replacement nodes are not transformed again.
+ *
+ * Rules are invoked with temporaries, therefore they should build replacement nodes with
+ * @ref operand, which copies owned operands. Nodes that are not replaced keep how they are stored:
+ * referenced nodes (e.g., variables) remain references and owned nodes are copied.
+ *
+ * Example:
+ * @code
+ * // lookup(a) + lookup(b) -> batched_lookup(a, b)
+ * using lookup_pattern = pattern::operation<lookup_fn, pattern::any>;
+ * auto batch = make_rule<pattern::operation<std::plus<>, lookup_pattern, lookup_pattern>>(
+ *   [](auto const& e) {
+ *     return invoke(sum_of_batched_lookup,
+ *                   operand<0>(operand<0>(e)),
+ *                   operand<0>(operand<1>(e)));
+ *   });
+ * auto ex = transform(invoke(lookup, a) + invoke(lookup, b), batch);
+ * @endcode
+ *
+ * @tparam Expression Type of the expression.
+ * @tparam Rules Types of the rules.
+ * @param expr Expression to transform.
+ * @param rules Rules, in order of priority.
+ * @return The transformed expression.
+ */
+template<Deferred Expression, typename... Rules>
+[[nodiscard]] constexpr decltype(auto) transform(Expression&& expr, Rules const&... rules)
+{
+  return detail::transform_impl<Expression>(expr, rules...);
+}
+
+} // namespace deferred
+
+#endif
@@ -4,80 +4,75 @@
 #ifndef DEFERRED_TYPE_NAME_HPP
 #define DEFERRED_TYPE_NAME_HPP
 
-#include <string>
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <string_view>
-#include <type_traits>
-#include <typeinfo>
-
-#ifdef __GNUG__
-#  include <cstdlib>
-#  include <memory>
-
-#  include <cxxabi.h>
-#endif
 
 namespace deferred {
 
-/**
- * @brief Returns the unmangled name of @p T as a @c std::string.
- *
- * This solution initially appeared in
- * https://stackoverflow.com/questions/18369128/how-can-i-see-the-type-deduced-for-a-template-type-parameter/18369732#18369732
- */
+namespace detail {
+
+/// @brief Returns the signature of this function, which contains the name of @p T.
 template<typename T>
-[[nodiscard]] std::string type_name()
+[[nodiscard]] constexpr std::string_view type_signature() noexcept
 {
-  using namespace std::literals;
-
-  using TR = std::remove_reference_t<T>;
-
-#ifdef __GNUG__
-  std::unique_ptr<char, void (*)(void*)> own(
-    abi::__cxa_demangle(typeid(TR).name(), nullptr, nullptr, nullptr),
-    std::free);
-  std::string r = own != nullptr ? own.get() : typeid(TR).name();
+#if defined(__clang__) || defined(__GNUC__)
+  return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+  return __FUNCSIG__;
 #else
-  std::string r = typeid(TR).name();
+  static_assert(sizeof(T) == 0, "type_name is not supported by this compiler");
+  return {};
 #endif
+}
 
-  static constexpr auto const_suffix    = " const"sv;
-  static constexpr auto volatile_suffix = " volatile"sv;
-  static constexpr auto lref_suffix     = "&"sv;
-  static constexpr auto rref_suffix     = "&&"sv;
+/// @brief Type whose name is searched for in its signature to find where names begin and end.
+using type_signature_probe = double;
 
-  static constexpr std::size_t extra_size = (std::is_const_v<TR> ? const_suffix.size() : 0)
-                                            + (std::is_volatile_v<TR> ? volatile_suffix.size() : 0)
-                                            + (std::is_lvalue_reference_v<T>   ? lref_suffix.size()
-                                               : std::is_rvalue_reference_v<T> ? rref_suffix.size()
-                                                                               : 0);
+/// @brief Number of characters of the signature before the name of the type.
+inline constexpr std::size_t type_signature_prefix =
+  type_signature<type_signature_probe>().find("double");
 
-  if constexpr (extra_size > 0)
-  {
-    r.reserve(r.size() + extra_size);
-    if constexpr (std::is_const_v<TR>)
-    {
-      r += const_suffix;
-    }
-    if constexpr (std::is_volatile_v<TR>)
-    {
-      r += volatile_suffix;
-    }
-    if constexpr (std::is_lvalue_reference_v<T>)
-    {
-      r += lref_suffix;
-    }
-    else if constexpr (std::is_rvalue_reference_v<T>)
-    {
-      r += rref_suffix;
-    }
-  }
+static_assert(type_signature_prefix != std::string_view::npos,
+              "unexpected format of the function signature");
 
-  return r;
+/// @brief Number of characters of the signature after the name of the type.
+inline constexpr std::size_t type_signature_suffix =
+  type_signature<type_signature_probe>().size() - type_signature_prefix
+  - std::string_view("double").size();
+
+/// @brief Name of @p T, stored as a null-terminated array once per type.
+template<typename T>
+inline constexpr auto type_name_storage = [] {
+  constexpr auto signature = type_signature<T>();
+  constexpr auto name      = signature.substr(
+    type_signature_prefix, signature.size() - type_signature_prefix - type_signature_suffix);
+  std::array<char, name.size() + 1> storage{};
+  std::copy_n(name.data(), name.size(), storage.data());
+  return storage;
+}();
+
+} // namespace detail
+
+/**
+ * @brief Returns the name of @p T, including cv-qualifiers and references.
+ *
+ * The name is extracted at compile time from the signature of a function template, as it is
+ * formatted by the compiler (e.g., <tt>const int&</tt> with GCC, <tt>const int &</tt> with Clang).
+ * It is stored once per type for the duration of the program, therefore calling this function
+ * neither allocates nor formats.
+ */
+template<typename T>
+[[nodiscard]] constexpr std::string_view type_name() noexcept
+{
+  auto const& storage = detail::type_name_storage<T>;
+  return {storage.data(), storage.size() - 1};
 }
 
 /// @copydoc type_name()
 template<typename T>
-[[nodiscard]] auto type_name(T&& t)
+[[nodiscard]] constexpr std::string_view type_name(T&& t) noexcept
 {
   return type_name<decltype(t)>();
 }
@@ -20,35 +20,44 @@ template<typename T>
 using map_void_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
 
 /**
- * @brief Metafunction to create a unique list of types.
- * @tparam Ts Input types.
+ * @brief Set of the types @p Ts, which are distinct.
+ *
+ * Membership is checked through its bases, which does not instantiate a template per element.
+ *
+ * @tparam Ts Types of the set.
  */
 template<typename... Ts>
-struct unique_list
-{
-  using type = std::tuple<>;
-};
+struct type_set : std::type_identity<Ts>...
+{ };
 
 /**
- * @brief Recursive case for @ref unique_list.
- * @tparam T Current type.
- * @tparam Ts Remaining types.
+ * @brief Prepends @p T to a @ref type_set if it is not a member.
+ *
+ * It is only used in unevaluated contexts to fold over a list of types.
  */
 template<typename T, typename... Ts>
-struct unique_list<T, Ts...>
+auto operator+(std::type_identity<T>, type_set<Ts...>)
+  -> std::conditional_t<std::is_base_of_v<std::type_identity<T>, type_set<Ts...>>,
+                        type_set<Ts...>,
+                        type_set<T, Ts...>>;
+
+/// @brief Converts a @ref type_set to a @c std::tuple; it is only used in unevaluated contexts.
+template<typename... Ts>
+auto to_tuple(type_set<Ts...>) -> std::tuple<Ts...>;
+
+/**
+ * @brief Metafunction to create a unique list of types.
+ *
+ * The last occurrence of each type is kept. The types are folded from the right into a
+ * @ref type_set, therefore there is no recursive instantiation and each step checks membership
+ * without iterating over the types that are already in the set.
+ *
+ * @tparam Ts Input types.
+ */
+template<typename... Ts>
+struct unique_list
 {
-  /**
-   * @brief Tail of the unique list.
-   */
-  using tail = typename unique_list<Ts...>::type;
-
-  /**
-   * @brief Resulting type list after potentially prepending @p T.
-   */
-  using type = std::conditional_t<(std::is_same_v<T, Ts> || ...),
-                                  tail,
-                                  decltype(std::tuple_cat(std::declval<std::tuple<T>>(),
-                                                          std::declval<tail>()))>;
+  using type = decltype(to_tuple((std::type_identity<Ts>{} + ... + type_set<>{})));
 };
 
 /**
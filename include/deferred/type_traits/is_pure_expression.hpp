@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef DEFERRED_TYPE_TRAITS_IS_PURE_EXPRESSION_HPP
+#define DEFERRED_TYPE_TRAITS_IS_PURE_EXPRESSION_HPP
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace deferred {
+
+template<typename T>
+class variable_;
+
+/**
+ * @brief Checks if the operator @p T has no side effects.
+ *
+ * It is @c true for the function objects of @c \<functional\> that the library operators use and
+ * for @ref pure_function. It can be specialized for user-defined function objects.
+ *
+ * @tparam T The type to check.
+ */
+template<typename T>
+struct is_pure_operator : public std::false_type
+{ };
+
+/// @brief Specialization for the function objects of @c \<functional\>.
+template<template<typename> class Operator, typename T>
+struct is_pure_operator<Operator<T>> :
+  public std::disjunction<std::is_same<Operator<T>, std::plus<T>>,
+                          std::is_same<Operator<T>, std::minus<T>>,
+                          std::is_same<Operator<T>, std::multiplies<T>>,
+                          std::is_same<Operator<T>, std::divides<T>>,
+                          std::is_same<Operator<T>, std::modulus<T>>,
+                          std::is_same<Operator<T>, std::negate<T>>,
+                          std::is_same<Operator<T>, std::equal_to<T>>,
+                          std::is_same<Operator<T>, std::not_equal_to<T>>,
+                          std::is_same<Operator<T>, std::greater<T>>,
+                          std::is_same<Operator<T>, std::less<T>>,
+                          std::is_same<Operator<T>, std::greater_equal<T>>,
+                          std::is_same<Operator<T>, std::less_equal<T>>,
+                          std::is_same<Operator<T>, std::logical_and<T>>,
+                          std::is_same<Operator<T>, std::logical_or<T>>,
+                          std::is_same<Operator<T>, std::logical_not<T>>,
+                          std::is_same<Operator<T>, std::bit_and<T>>,
+                          std::is_same<Operator<T>, std::bit_or<T>>,
+                          std::is_same<Operator<T>, std::bit_xor<T>>,
+                          std::is_same<Operator<T>, std::bit_not<T>>>
+{ };
+
+/**
+ * @brief Alias for @c is_pure_operator::value.
+ * @tparam T The type to check.
+ */
+template<typename T>
+inline constexpr bool is_pure_operator_v = is_pure_operator<T>::value;
+
+/**
+ * @brief Function object that wraps @p F and declares it free of side effects.
+ * @tparam F Type of the callable.
+ */
+template<typename F>
+struct pure_function
+{
+  [[no_unique_address]] F m_f;
+
+  template<typename... T>
+    requires std::is_invocable_v<F const&, T...>
+  [[nodiscard]] constexpr decltype(auto) operator()(T&&... t) const
+    noexcept(std::is_nothrow_invocable_v<F const&, T...>)
+  {
+    return std::invoke(m_f, std::forward<T>(t)...);
+  }
+};
+
+/// @brief Specialization for @ref pure_function.
+template<typename F>
+struct is_pure_operator<pure_function<F>> : public std::true_type
+{ };
+
+/**
+ * @brief Declares @p f free of side effects.
+ *
+ * Example:
+ * @code
+ * auto ex = invoke(pure([](double x) { return std::exp(x); }), v);
+ * static_assert(is_pure_expression_v<decltype(ex)>);
+ * @endcode
+ *
+ * @tparam F Type of the callable.
+ * @param f Callable.
+ * @return A @ref pure_function that wraps @p f.
+ */
+template<typename F>
+[[nodiscard]] constexpr auto pure(F&& f)
+{
+  return pure_function<std::decay_t<F>>{std::forward<F>(f)};
+}
+
+/**
+ * @brief Checks if the expression @p T modifies state during evaluation (e.g., stores its result).
+ *
+ * Such expressions are not pure even if their subexpressions are.
+ *
+ * @tparam T The type to check.
+ */
+template<typename T>
+struct is_stateful_expression : public std::false_type
+{ };
+
+template<typename T>
+struct is_pure_expression;
+
+namespace detail {
+
+// Non-deferred types are operators.
+template<typename T, typename = std::void_t<>>
+struct is_pure_expression : public is_pure_operator<T>
+{ };
+
+// Reading a variable has no side effects.
+template<typename T>
+struct is_pure_expression<variable_<T>> : public std::true_type
+{ };
+
+// Matches the tuple of subexpressions for a deferred type.
+template<typename... T>
+struct is_pure_expression<std::tuple<T...>> :
+  public std::conjunction<deferred::is_pure_expression<T>...>
+{ };
+
+// If subexpression_types is defined, then it is a deferred data type.
+template<typename T>
+  requires(!std::is_void_v<typename T::subexpression_types>)
+struct is_pure_expression<T, std::void_t<typename T::subexpression_types>> :
+  public std::conjunction<std::negation<is_stateful_expression<T>>,
+                          is_pure_expression<typename T::subexpression_types>>
+{ };
+
+} // namespace detail
+
+/**
+ * @brief Checks if evaluating the expression @p T has no side effects.
+ *
+ * An expression is pure if all its operators are pure (see @ref is_pure_operator) and it does not
+ * contain stateful expressions (see @ref is_stateful_expression). Pure expressions can be
+ * evaluated concurrently with each other.
+ *
+ * @tparam T The type to check.
+ */
+template<typename T>
+struct is_pure_expression : public detail::is_pure_expression<std::decay_t<T>>
+{ };
+
+/**
+ * @brief Alias for @c is_pure_expression::value.
+ * @tparam T The type to check.
+ */
+template<typename T>
+inline constexpr bool is_pure_expression_v = is_pure_expression<T>::value;
+
+} // namespace deferred
+
+#endif
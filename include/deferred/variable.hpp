@@ -4,6 +4,7 @@
 #ifndef DEFERRED_VARIABLE_HPP
 #define DEFERRED_VARIABLE_HPP
 
+#include <cstdint>
 #include <type_traits>
 #include <utility>
 
@@ -13,6 +14,11 @@ namespace deferred {
 
 /**
  * @brief Stores a variable value.
+ *
+ * Each variable has a version that is incremented on every assignment, which allows expressions
+ * that depend on it (e.g., @ref cached_expression) to detect changes. If the value is modified
+ * in place through the non-const @c operator(), @ref touch() has to be called.
+ *
  * @tparam T Type of the variable to store.
  */
 template<typename T>
@@ -24,6 +30,7 @@ public:
 
 private:
   [[no_unique_address]] T m_t{};
+  std::uint64_t m_version{};
 
 public:
   variable_() = default;
@@ -52,6 +59,7 @@ public:
   constexpr variable_& operator=(T const& t)
   {
     m_t = t;
+    ++m_version;
     return *this;
   }
 
@@ -59,9 +67,27 @@ public:
   constexpr variable_& operator=(T&& t) noexcept
   {
     m_t = std::move(t);
+    ++m_version;
     return *this;
   }
 
+  /// @brief Marks the variable as modified.
+  constexpr void touch() noexcept
+  {
+    ++m_version;
+  }
+
+  /**
+   * @brief Returns the version of the variable.
+   *
+   * The reference remains valid for the lifetime of the variable and can be used to observe
+   * changes.
+   */
+  [[nodiscard]] constexpr std::uint64_t const& version() const noexcept
+  {
+    return m_version;
+  }
+
   /// @brief Returns the stored value.
   [[nodiscard]] constexpr T const& operator()() const& noexcept
   {
@@ -94,6 +120,18 @@ public:
   }
 };
 
+namespace detail {
+
+/// @brief Checks if @p T is a @ref variable_.
+template<typename T>
+inline constexpr bool is_variable_v = false;
+
+/// @brief Specialization for @ref variable_.
+template<typename T>
+inline constexpr bool is_variable_v<variable_<T>> = true;
+
+} // namespace detail
+
 /**
  * @brief Creates a new @ref variable_ that holds a default-initialized @p T.
  * @tparam T Type of the variable.
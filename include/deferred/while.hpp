@@ -44,6 +44,18 @@ public:
     m_condition(std::forward<Condition>(condition)), m_body(std::forward<Body>(body))
   { }
 
+  /// @brief Returns the condition expression.
+  [[nodiscard]] constexpr ConditionExpression const& condition() const noexcept
+  {
+    return m_condition;
+  }
+
+  /// @brief Returns the body expression.
+  [[nodiscard]] constexpr BodyExpression const& body() const noexcept
+  {
+    return m_body;
+  }
+
   /// @brief Evaluates the while loop.
   constexpr void operator()() const
   {
@@ -4,6 +4,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "deferred/constant.hpp"
+#include "deferred/invoke.hpp"
 #include "deferred/operators.hpp"
 #include "deferred/variable.hpp"
 
@@ -252,6 +253,37 @@ TEST_CASE("logical operators", "[logical-operators]")
   }
 }
 
+TEST_CASE("logical operators short-circuit", "[logical-operators-short-circuit]")
+{
+  auto lookups = 0;
+  auto key     = deferred::variable(-1);
+  auto lookup  = deferred::invoke(
+    [&](int k) {
+      ++lookups;
+      return k % 2 == 0;
+    },
+    key);
+
+  auto guarded  = key >= 0 && lookup;
+  auto fallback = key < 0 || lookup;
+  auto chained  = key >= 0 && key < 100 && lookup;
+
+  CHECK(!guarded());
+  CHECK(fallback());
+  CHECK(!chained());
+  CHECK(lookups == 0);
+
+  key = 42;
+  CHECK(guarded());
+  CHECK(fallback());
+  CHECK(chained());
+  CHECK(lookups == 3);
+
+  key = 1000;
+  CHECK(!chained());
+  CHECK(lookups == 3);
+}
+
 TEST_CASE("bitwise operators", "[bitwise-operators]")
 {
   auto i = 13;
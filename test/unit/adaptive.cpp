@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "deferred/adaptive.hpp"
+#include "deferred/conditional.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/switch.hpp"
+#include "deferred/type_traits/is_pure_expression.hpp"
+#include "deferred/variable.hpp"
+
+TEST_CASE("adaptive switch reorders cases", "[adaptive-switch]")
+{
+  int comparisons = 0;
+  auto label      = [&comparisons](int l) {
+    return [&comparisons, l] {
+      ++comparisons;
+      return l;
+    };
+  };
+  auto x  = deferred::variable(0);
+  auto ex = deferred::adaptive_(deferred::switch_(x,
+                                                  deferred::default_(std::string_view("none")),
+                                                  deferred::case_(label(1), std::string_view("a")),
+                                                  deferred::case_(label(2), std::string_view("b")),
+                                                  deferred::case_(label(3), std::string_view("c"))),
+                                4);
+  static_assert(!deferred::is_pure_expression_v<decltype(ex)>);
+  CHECK(ex.order() == std::array<std::size_t, 3>{0, 1, 2});
+
+  x = 3;
+  for (int i = 0; i < 3; ++i)
+  {
+    CHECK(ex() == "c");
+  }
+  x = 2;
+  CHECK(ex() == "b");
+  CHECK(ex.order() == std::array<std::size_t, 3>{2, 1, 0});
+
+  x           = 3;
+  comparisons = 0;
+  CHECK(ex() == "c");
+  CHECK(comparisons == 1);
+
+  x = 4;
+  CHECK(ex() == "none");
+  CHECK(ex.frequencies() == std::array<std::uint64_t, 4>{0, 1, 4, 1});
+}
+
+TEST_CASE("adaptive conditional reorders branches", "[adaptive-conditional]")
+{
+  auto x  = deferred::variable(0);
+  auto ex = deferred::adaptive_(
+    deferred::if_(x < 0, -1).else_if(x == 0, 0).else_if(x > 100, 2).else_(1), 2);
+
+  for (int v : {200, 300, 50, -5, 0, 400})
+  {
+    x = v;
+    CHECK(ex() == (v < 0 ? -1 : v == 0 ? 0 : v > 100 ? 2 : 1));
+  }
+  CHECK(ex.order() == std::array<std::size_t, 3>{2, 0, 1});
+  CHECK(ex.frequencies() == std::array<std::uint64_t, 4>{1, 1, 3, 1});
+}
+
+TEST_CASE("adaptive conditional without else", "[adaptive-no-else]")
+{
+  auto x  = deferred::variable(0);
+  auto ex = deferred::adaptive_(deferred::if_(x > 0, x + 1));
+  CHECK(ex() == std::nullopt);
+
+  x = 1;
+  CHECK(ex() == std::optional<int>(2));
+}
+
+TEST_CASE("adaptive with static order", "[adaptive-static]")
+{
+  auto x    = deferred::variable(1);
+  auto cond = deferred::if_(x == 1, 10).else_if(x == 2, 20).else_if(x == 3, 30).else_(0);
+  auto ex   = deferred::adaptive_(cond, {5, 0, 9, 0});
+  CHECK(ex.order() == std::array<std::size_t, 3>{2, 0, 1});
+
+  for (int i = 0; i < 10; ++i)
+  {
+    CHECK(ex() == 10);
+  }
+  // the order is fixed
+  CHECK(ex.order() == std::array<std::size_t, 3>{2, 0, 1});
+  CHECK(ex.frequencies()[0] == 15);
+}
@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "deferred/any_expression.hpp"
+#include "deferred/constant.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/type_traits/is_deferred.hpp"
+#include "deferred/type_traits/is_pure_expression.hpp"
+#include "deferred/variable.hpp"
+
+static_assert(deferred::is_deferred_v<deferred::any_expression<int>>);
+static_assert(!deferred::is_constant_expression_v<deferred::any_expression<int>>);
+static_assert(!deferred::is_pure_expression_v<deferred::any_expression<int>>);
+static_assert(std::is_copy_constructible_v<deferred::any_expression<int>>);
+static_assert(!std::is_copy_constructible_v<deferred::move_only_any_expression<int>>);
+static_assert(std::is_nothrow_move_constructible_v<deferred::move_only_any_expression<int>>);
+
+TEST_CASE("any_expression from expression", "[any_expression-expression]")
+{
+  auto x = deferred::variable(1);
+  auto y = deferred::variable(2);
+
+  deferred::any_expression<int> ex = x + y * 2;
+  CHECK(ex() == 5);
+
+  x = 10;
+  CHECK(ex() == 14);
+}
+
+TEST_CASE("any_expression references lvalue expressions", "[any_expression-reference]")
+{
+  auto x  = deferred::variable(1);
+  auto ex = x * 3;
+
+  deferred::any_expression<int> any = ex;
+  x                                 = 4;
+  CHECK(any() == 12);
+}
+
+TEST_CASE("any_expression from callable", "[any_expression-callable]")
+{
+  int calls = 0;
+  deferred::any_expression<int> ex([&calls] { return ++calls; });
+  CHECK(ex() == 1);
+  CHECK(ex() == 2);
+  CHECK(calls == 2);
+}
+
+TEST_CASE("any_expression converts result", "[any_expression-convert]")
+{
+  deferred::any_expression<double> ex = deferred::constant(2) * 3;
+  CHECK(ex() == 6.0);
+
+  int calls = 0;
+  deferred::any_expression<void> discarded([&calls] { return ++calls; });
+  discarded();
+  CHECK(calls == 1);
+}
+
+TEST_CASE("any_expression heap storage", "[any_expression-heap]")
+{
+  std::array<int, 64> values{};
+  values[63] = 42;
+  deferred::any_expression<int> ex([values] { return values[63]; });
+  CHECK(ex() == 42);
+
+  // copies own their expression
+  auto copy = ex;
+  CHECK(copy() == 42);
+  ex.reset();
+  CHECK(!static_cast<bool>(ex));
+  CHECK(copy() == 42);
+}
+
+TEST_CASE("any_expression copy and move", "[any_expression-copy-move]")
+{
+  auto counter = std::make_shared<int>(0);
+  deferred::any_expression<int> ex([counter] { return ++*counter; });
+  CHECK(counter.use_count() == 2);
+
+  auto copy = ex;
+  CHECK(counter.use_count() == 3);
+  CHECK(copy() == 1);
+  CHECK(ex() == 2);
+
+  auto moved = std::move(ex);
+  CHECK(!static_cast<bool>(ex)); // NOLINT(bugprone-use-after-move)
+  CHECK(counter.use_count() == 3);
+  CHECK(moved() == 3);
+
+  copy = moved;
+  CHECK(counter.use_count() == 3);
+  moved = deferred::any_expression<int>();
+  CHECK(counter.use_count() == 2);
+  copy.reset();
+  CHECK(counter.use_count() == 1);
+}
+
+TEST_CASE("move_only_any_expression", "[any_expression-move-only]")
+{
+  auto p = std::make_unique<int>(7);
+  deferred::move_only_any_expression<int> ex([p = std::move(p)] { return *p; });
+  CHECK(ex() == 7);
+
+  auto moved = std::move(ex);
+  CHECK(!static_cast<bool>(ex)); // NOLINT(bugprone-use-after-move)
+  CHECK(moved() == 7);
+
+  std::vector<deferred::move_only_any_expression<int>> expressions;
+  for (int i = 0; i < 16; ++i)
+  {
+    expressions.emplace_back([i] { return i; });
+  }
+  int sum = 0;
+  for (auto const& e : expressions)
+  {
+    sum += e();
+  }
+  CHECK(sum == 120);
+}
+
+TEST_CASE("any_expression empty", "[any_expression-empty]")
+{
+  deferred::any_expression<int> ex;
+  CHECK(!static_cast<bool>(ex));
+  CHECK_THROWS_AS(ex(), std::bad_function_call);
+}
+
+TEST_CASE("any_expression visit", "[any_expression-visit]")
+{
+  auto x = deferred::variable(1);
+  deferred::any_expression<int> ex = x + 1;
+
+  std::size_t nodes         = 0;
+  std::size_t max_nesting   = 0;
+  bool found_variable       = false;
+  bool found_any_expression = false;
+  ex.visit([&](auto const& node, std::size_t nesting) {
+    ++nodes;
+    max_nesting = std::max(max_nesting, nesting);
+    if constexpr (std::is_same_v<std::remove_cvref_t<decltype(node)>, deferred::any_node>)
+    {
+      found_variable |= (*node.type == typeid(deferred::variable_<int>));
+      CHECK(node.address != nullptr);
+    }
+    else
+    {
+      found_any_expression = true;
+    }
+  });
+  // any_expression, expression_, variable_, its value, constant_
+  CHECK(nodes == 5);
+  CHECK(max_nesting == 3);
+  CHECK(found_variable);
+  CHECK(found_any_expression);
+}
+
+TEST_CASE("any_expression as subexpression", "[any_expression-subexpression]")
+{
+  auto x = deferred::variable(2);
+  std::vector<deferred::any_expression<int>> terms;
+  terms.emplace_back(x * x);
+  terms.emplace_back(x + 1);
+  terms.emplace_back(deferred::constant(5));
+
+  auto ex = terms[0] + terms[1] * terms[2];
+  CHECK(ex() == 19);
+
+  x = 3;
+  CHECK(ex() == 29);
+}
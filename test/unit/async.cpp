@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <latch>
+#include <stdexcept>
+
+#include "deferred/async.hpp"
+#include "deferred/constant.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/task.hpp"
+#include "deferred/thread_pool.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+
+namespace {
+
+deferred::task<int> load(int i)
+{
+  co_return i * 10;
+}
+
+} // namespace
+
+TEST_CASE("async synchronous evaluation", "[async]")
+{
+  auto a = deferred::async_([] { return 2; });
+  auto b = deferred::async_([] { return load(3); });
+  static_assert(!deferred::is_constant_expression_v<decltype(a)>);
+  CHECK(a() == 2);
+  CHECK(b() == 30);
+  CHECK((a + b)() == 32);
+}
+
+TEST_CASE("co_evaluate awaits siblings concurrently", "[co-evaluate]")
+{
+  deferred::thread_pool pool(2);
+  std::latch all(2);
+  // each leaf waits for the other, so this only finishes if they run concurrently
+  auto leaf = [&](int i) {
+    return deferred::async_(pool, [&all, i] {
+      all.arrive_and_wait();
+      return i;
+    });
+  };
+
+  auto x  = deferred::variable(100);
+  auto ex = leaf(1) + leaf(2) * x;
+  CHECK(deferred::sync_wait(deferred::co_evaluate(ex)) == 201);
+}
+
+TEST_CASE("co_evaluate with task leaves", "[co-evaluate-task]")
+{
+  auto v  = deferred::variable(1);
+  auto ex = deferred::async_([] { return load(4); }) - v;
+  CHECK(deferred::sync_wait(deferred::co_evaluate(ex)) == 39);
+
+  // temporaries are owned by the task
+  auto t = deferred::co_evaluate(deferred::async_([] { return load(1); }) + 1);
+  CHECK(deferred::sync_wait(t) == 11);
+}
+
+TEST_CASE("co_evaluate synchronous expressions", "[co-evaluate-sync]")
+{
+  auto v = deferred::variable(2);
+  CHECK(deferred::sync_wait(deferred::co_evaluate(v * 3)) == 6);
+  CHECK(&deferred::sync_wait(deferred::co_evaluate(v)) == &v());
+}
+
+TEST_CASE("co_evaluate exception", "[co-evaluate-exception]")
+{
+  auto ex = deferred::async_([]() -> int { throw std::runtime_error("error"); })
+            + deferred::constant(1);
+  CHECK_THROWS_AS(deferred::sync_wait(deferred::co_evaluate(ex)), std::runtime_error);
+}
+
+TEST_CASE("async visit", "[async-visit]")
+{
+  auto ex = deferred::async_([] { return 1; }) + 1;
+
+  std::size_t nodes = 0;
+  ex.visit([&](auto const&, std::size_t) { ++nodes; });
+  CHECK(nodes == 3);
+}
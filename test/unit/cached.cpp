@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+
+#include "deferred/any_expression.hpp"
+#include "deferred/cached.hpp"
+#include "deferred/constant.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+
+TEST_CASE("variable version", "[variable-version]")
+{
+  auto v = deferred::variable(0);
+  CHECK(v.version() == 0);
+
+  v = 1;
+  CHECK(v.version() == 1);
+
+  int const i = 2;
+  v           = i;
+  CHECK(v.version() == 2);
+
+  v() = 3;
+  CHECK(v.version() == 2);
+  v.touch();
+  CHECK(v.version() == 3);
+}
+
+TEST_CASE("variable version with modifying operators", "[variable-version-operators]")
+{
+  auto v  = deferred::variable(0);
+  auto ex = ++v;
+  auto ey = v--;
+
+  CHECK(ex() == 1);
+  CHECK(v.version() == 1);
+  CHECK(ey() == 1);
+  CHECK(v() == 0);
+  CHECK(v.version() == 2);
+}
+
+TEST_CASE("cached recomputes on assignment", "[cached]")
+{
+  int count = 0;
+  auto x    = deferred::variable(1);
+  auto y    = deferred::variable(2);
+  auto ex   = deferred::cached_(deferred::invoke(
+    [&count](int a, int b) {
+      ++count;
+      return a + b;
+    },
+    x,
+    y));
+  static_assert(!deferred::is_constant_expression_v<decltype(ex)>);
+  CHECK(!ex.is_cached());
+
+  CHECK(ex() == 3);
+  CHECK(ex() == 3);
+  CHECK(count == 1);
+  CHECK(ex.is_cached());
+
+  x = 10;
+  CHECK(!ex.is_cached());
+  CHECK(ex() == 12);
+  CHECK(ex() == 12);
+  CHECK(count == 2);
+
+  y = 20;
+  CHECK(ex() == 30);
+  CHECK(count == 3);
+
+  ex.invalidate();
+  CHECK(ex() == 30);
+  CHECK(count == 4);
+}
+
+TEST_CASE("cached copy", "[cached-copy]")
+{
+  int count = 0;
+  auto x    = deferred::variable(2);
+  auto ex   = deferred::cached_(deferred::invoke(
+    [&count](int a) {
+      ++count;
+      return a * 2;
+    },
+    x));
+  CHECK(ex() == 4);
+
+  auto ey = ex;
+  CHECK(ey.is_cached());
+  CHECK(ey() == 4);
+  CHECK(count == 1);
+
+  x = 3;
+  CHECK(ey() == 6);
+  CHECK(count == 2);
+  CHECK(ex() == 6);
+  CHECK(count == 3);
+}
+
+TEST_CASE("cached constant expression", "[cached-constant]")
+{
+  auto ex = deferred::cached_(deferred::constant(1) + deferred::constant(2));
+  static_assert(deferred::is_constant_expression_v<decltype(ex)>);
+  CHECK(ex() == 3);
+  CHECK(ex.is_cached());
+}
+
+TEST_CASE("cached opaque expression", "[cached-opaque]")
+{
+  auto x  = deferred::variable(1);
+  auto ex = deferred::cached_(deferred::any_expression<int>(x + 1));
+  CHECK(ex() == 2);
+  CHECK(!ex.is_cached());
+
+  x = 10;
+  CHECK(ex() == 11);
+
+  auto ey = deferred::cached_(deferred::any_expression<int>(x + 1) * 2);
+  CHECK(ey() == 22);
+  x = 1;
+  CHECK(ey() == 4);
+}
+
+TEST_CASE("cached visit", "[cached-visit]")
+{
+  auto x  = deferred::variable(1);
+  auto ex = deferred::cached_(x + 1);
+
+  std::size_t nodes = 0;
+  ex.visit([&](auto const&, std::size_t) { ++nodes; });
+  CHECK(nodes == 5);
+}
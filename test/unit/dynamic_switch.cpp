@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "deferred/dynamic_switch.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+
+TEST_CASE("flat case map", "[flat-case-map]")
+{
+  deferred::detail::flat_case_map<int, int> map;
+  CHECK(map.empty());
+  CHECK(map.find(1) == nullptr);
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    CHECK(map.insert(i * 16, i));
+  }
+  CHECK(!map.insert(16, -1));
+  CHECK(map.size() == 1000);
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    REQUIRE(map.find(i * 16) != nullptr);
+    CHECK(*map.find(i * 16) == i);
+    CHECK(map.find(i * 16 + 1) == nullptr);
+  }
+  CHECK(map.labels()[1] == 16);
+  CHECK(map.bodies()[1] == 1);
+}
+
+TEST_CASE("dynamic switch with integer labels", "[dynamic-switch-int]")
+{
+  auto var = deferred::variable<int>();
+  auto ex  = deferred::dynamic_switch_<int, std::function<int()>>(var, deferred::default_(-1));
+  static_assert(!deferred::is_constant_expression_v<decltype(ex)>);
+
+  var = 1;
+  CHECK(ex() == -1);
+
+  ex.reserve(100);
+  for (int i = 0; i < 100; ++i)
+  {
+    CHECK(ex.insert(i, [i] { return i * i; }));
+  }
+  CHECK(!ex.insert(1, [] { return 0; }));
+  CHECK(ex.size() == 100);
+
+  CHECK(ex() == 1);
+  var = 9;
+  CHECK(ex() == 81);
+  var = 100;
+  CHECK(ex() == -1);
+}
+
+TEST_CASE("dynamic switch with string labels", "[dynamic-switch-string]")
+{
+  std::vector<std::pair<std::string, int>> config{{"login", 1}, {"logout", 2}, {"login", 3}};
+
+  auto var = deferred::variable<std::string_view>();
+  auto ex  = deferred::dynamic_switch_<std::string, int>(var, deferred::default_(0), config);
+  CHECK(ex.size() == 2);
+
+  var = "login";
+  CHECK(ex() == 1);
+  var = "logout";
+  CHECK(ex() == 2);
+  var = "ping";
+  CHECK(ex() == 0);
+}
+
+TEST_CASE("dynamic switch with heterogeneous types", "[dynamic-switch-variant]")
+{
+  auto var = deferred::variable<int>();
+  auto ex =
+    deferred::dynamic_switch_<int, std::function<double()>>(var, deferred::default_("unknown"));
+  ex.insert(1, [] { return 1.5; });
+
+  using result_type = decltype(ex());
+  static_assert(std::is_same_v<result_type, std::variant<char const*, double>>);
+
+  var = 1;
+  CHECK(std::get<double>(ex()) == 1.5);
+  var = 2;
+  CHECK(std::holds_alternative<char const*>(ex()));
+}
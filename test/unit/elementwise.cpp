@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <span>
+#include <stdexcept>
+#include <valarray>
+#include <vector>
+
+#include "deferred/constant.hpp"
+#include "deferred/elementwise.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/variable.hpp"
+
+namespace {
+
+std::vector<int> reversed(std::vector<int> v)
+{
+  return {v.rbegin(), v.rend()};
+}
+
+} // namespace
+
+TEST_CASE("elementwise with vectors", "[elementwise-vector]")
+{
+  auto x  = deferred::constant(std::vector<int>{1, 2, 3});
+  auto y  = deferred::constant(std::vector<int>{10, 20, 30});
+  auto ex = deferred::constant(2) * x + y;
+
+  static_assert(std::is_same_v<deferred::elementwise_result_t<decltype(ex)>, int>);
+  CHECK(deferred::elementwise_evaluate(ex) == std::vector<int>{12, 24, 36});
+}
+
+TEST_CASE("elementwise with valarrays", "[elementwise-valarray]")
+{
+  auto a  = deferred::constant(2.0f);
+  auto x  = deferred::constant(std::valarray<float>(1.0f, 4));
+  auto y  = deferred::constant(std::valarray<float>(0.5f, 4));
+  auto ex = a * x + y - x;
+
+  std::valarray<float> out(4);
+  deferred::elementwise_evaluate(ex, out);
+  for (auto v : out)
+  {
+    CHECK(v == 1.5f);
+  }
+}
+
+TEST_CASE("elementwise with spans and variables", "[elementwise-span]")
+{
+  std::vector<int> data{1, 2, 3, 4};
+  auto v  = deferred::variable<std::span<int const>>();
+  auto k  = deferred::variable<int>();
+  auto ex = -(v * k);
+
+  v = std::span<int const>(data);
+  k = 3;
+  CHECK(deferred::elementwise_evaluate(ex) == std::vector<int>{-3, -6, -9, -12});
+
+  k = -1;
+  CHECK(deferred::elementwise_evaluate(ex) == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("elementwise with scalar subexpression", "[elementwise-scalar-subexpression]")
+{
+  auto count = deferred::variable(0);
+  auto x     = deferred::constant(std::vector<int>{1, 2, 3});
+  auto ex    = x + ++count;
+
+  CHECK(deferred::elementwise_evaluate(ex) == std::vector<int>{2, 3, 4});
+  CHECK(count() == 1);
+}
+
+TEST_CASE("elementwise with non-elementwise operator", "[elementwise-leaf]")
+{
+  auto x  = deferred::constant(std::vector<int>{1, 2, 3});
+  auto ex = deferred::invoke(reversed, x) * x;
+
+  CHECK(deferred::elementwise_evaluate(ex) == std::vector<int>{3, 4, 3});
+}
+
+TEST_CASE("elementwise in place", "[elementwise-in-place]")
+{
+  auto v  = deferred::variable(std::vector<int>{1, 2, 3});
+  auto ex = v * v + 1;
+
+  deferred::elementwise_evaluate(ex, v());
+  CHECK(v() == std::vector<int>{2, 5, 10});
+}
+
+TEST_CASE("elementwise with different sizes", "[elementwise-size-mismatch]")
+{
+  auto x  = deferred::constant(std::vector<int>{1, 2, 3});
+  auto y  = deferred::constant(std::vector<int>{1, 2});
+  auto ex = x + y;
+
+  CHECK_THROWS_AS(deferred::elementwise_evaluate(ex), std::length_error);
+
+  std::vector<int> out(2);
+  CHECK_THROWS_AS(deferred::elementwise_evaluate(x + 1, out), std::length_error);
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <type_traits>
+
+#include "deferred/conditional.hpp"
+#include "deferred/constant.hpp"
+#include "deferred/fold.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+
+namespace {
+
+// Counts the nodes of an expression.
+template<typename Expression>
+constexpr std::size_t count_nodes(Expression const& expr)
+{
+  std::size_t n = 0;
+  expr.visit([&n](auto const&, std::size_t) { ++n; });
+  return n;
+}
+
+} // namespace
+
+TEST_CASE("fold constant expression", "[fold-constant]")
+{
+  constexpr auto ex = deferred::fold(deferred::constant(2) * deferred::constant(3) + 1);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(ex)>, deferred::constant_<int>>);
+  static_assert(ex() == 7);
+}
+
+TEST_CASE("fold constant subtrees", "[fold-subtrees]")
+{
+  auto x       = deferred::variable(1);
+  int calls    = 0;
+  auto counted = [&calls](int v) {
+    ++calls;
+    return v;
+  };
+  auto ex = x * (deferred::constant(2) * deferred::constant(3))
+            + deferred::invoke(counted, x) + deferred::invoke([] { return 10; });
+  auto folded = deferred::fold(ex);
+  static_assert(!deferred::is_constant_expression_v<decltype(folded)>);
+  CHECK(count_nodes(folded) < count_nodes(ex));
+  CHECK(folded() == ex());
+
+  x = 5;
+  CHECK(folded() == 5 * 6 + 5 + 10);
+  CHECK(calls == 3);
+}
+
+TEST_CASE("fold keeps referenced nodes", "[fold-references]")
+{
+  auto x      = deferred::variable(std::string("a"));
+  auto c      = deferred::constant(std::string("b"));
+  auto folded = deferred::fold(x + c + (deferred::constant(std::string("c")) + "d"));
+  CHECK(folded() == "abcd");
+
+  x = "e";
+  CHECK(folded() == "ebcd");
+}
+
+TEST_CASE("fold without constant subtrees", "[fold-unchanged]")
+{
+  auto x = deferred::variable(1);
+  auto y = deferred::variable(2);
+
+  auto ex = x + y;
+  static_assert(std::is_same_v<decltype(deferred::fold(x + y)), decltype(ex)>);
+  static_assert(std::is_same_v<decltype(deferred::fold(x)), deferred::variable_<int>&>);
+  CHECK(deferred::fold(x + y)() == 3);
+}
+
+TEST_CASE("fold conditional", "[fold-conditional]")
+{
+  auto x  = deferred::variable(1);
+  auto ex = deferred::fold(
+    deferred::if_(x > 0, deferred::if_(deferred::constant(true), 1).else_(2)()).else_(3));
+  CHECK(ex() == 1);
+}
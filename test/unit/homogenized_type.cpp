@@ -3,12 +3,25 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <cstddef>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <variant>
 
 #include "deferred/type_traits/homogenized_type.hpp"
 
+namespace {
+
+template<std::size_t I>
+struct tag
+{ };
+
+template<std::size_t M, std::size_t... I>
+auto homogenize(std::index_sequence<I...>) -> deferred::homogenized_type_t<tag<I % M>...>;
+
+} // namespace
+
 TEST_CASE("homogenized_type with same types", "[homogenized_type]")
 {
   using type = deferred::homogenized_type_t<int, int, int>;
@@ -58,3 +71,18 @@ TEST_CASE("homogenized_type complex mix", "[homogenized_type]")
   using type = deferred::homogenized_type_t<int, double, std::string, void>;
   STATIC_CHECK(std::is_same_v<type, std::variant<int, double, std::string, std::monostate>>);
 }
+
+TEST_CASE("homogenized_type keeps the last occurrence", "[homogenized_type]")
+{
+  using type = deferred::homogenized_type_t<int, double, int>;
+  STATIC_CHECK(std::is_same_v<type, std::variant<double, int>>);
+}
+
+TEST_CASE("homogenized_type with many types", "[homogenized_type]")
+{
+  using same_type = decltype(homogenize<1>(std::make_index_sequence<1000>{}));
+  STATIC_CHECK(std::is_same_v<same_type, tag<0>>);
+
+  using variant_type = decltype(homogenize<3>(std::make_index_sequence<1000>{}));
+  STATIC_CHECK(std::is_same_v<variant_type, std::variant<tag<1>, tag<2>, tag<0>>>);
+}
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <functional>
+
+#include "deferred/cached.hpp"
+#include "deferred/conditional.hpp"
+#include "deferred/constant.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/shared.hpp"
+#include "deferred/type_traits/is_pure_expression.hpp"
+#include "deferred/variable.hpp"
+
+TEST_CASE("is_pure_operator", "[is_pure_operator]")
+{
+  using deferred::is_pure_operator_v;
+
+  static_assert(is_pure_operator_v<std::plus<>>);
+  static_assert(is_pure_operator_v<std::logical_not<int>>);
+  static_assert(!is_pure_operator_v<int>);
+
+  auto f = [](int x) { return x; };
+  static_assert(!is_pure_operator_v<decltype(f)>);
+  static_assert(is_pure_operator_v<decltype(deferred::pure(f))>);
+  CHECK(deferred::pure(f)(42) == 42);
+}
+
+TEST_CASE("is_pure_expression", "[is_pure_expression]")
+{
+  using deferred::is_pure_expression_v;
+
+  auto x = deferred::variable(1);
+  auto y = deferred::variable(2);
+
+  SECTION("constants and variables")
+  {
+    static_assert(is_pure_expression_v<decltype(deferred::constant(42))>);
+    static_assert(is_pure_expression_v<decltype(x)>);
+  }
+
+  SECTION("operators")
+  {
+    static_assert(is_pure_expression_v<decltype(x + y * 2)>);
+    static_assert(is_pure_expression_v<decltype(!(x < y) || x == y)>);
+    static_assert(!is_pure_expression_v<decltype(++x)>);
+    static_assert(!is_pure_expression_v<decltype(x-- + y)>);
+  }
+
+  SECTION("callables")
+  {
+    auto f = [](int a) { return a + 1; };
+    static_assert(!is_pure_expression_v<decltype(deferred::invoke(f, x))>);
+    static_assert(is_pure_expression_v<decltype(deferred::invoke(deferred::pure(f), x))>);
+  }
+
+  SECTION("conditionals")
+  {
+    static_assert(is_pure_expression_v<decltype(deferred::if_(x > 0, x).else_(y))>);
+    static_assert(!is_pure_expression_v<decltype(deferred::if_(x > 0, ++x).else_(y))>);
+  }
+
+  SECTION("stateful expressions")
+  {
+    static_assert(!is_pure_expression_v<decltype(deferred::cached_(x + y))>);
+    static_assert(!is_pure_expression_v<decltype(deferred::shared_(x + y))>);
+  }
+}
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "deferred/constant.hpp"
+#include "deferred/elementwise.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/logical.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+
+namespace {
+
+// overloads logical operators, which do not short-circuit
+struct tristate
+{
+  int value;
+
+  friend constexpr tristate operator&&(tristate x, tristate y) noexcept
+  {
+    return {x.value < y.value ? x.value : y.value};
+  }
+
+  friend constexpr tristate operator||(tristate x, tristate y) noexcept
+  {
+    return {x.value < y.value ? y.value : x.value};
+  }
+};
+
+} // namespace
+
+TEST_CASE("logical and short-circuits", "[logical-and]")
+{
+  auto count = deferred::variable(0);
+  auto lhs   = deferred::variable(false);
+  auto ex    = lhs && [&] { return ++count() > 0; };
+
+  CHECK(!ex());
+  CHECK(count() == 0);
+
+  lhs = true;
+  CHECK(ex());
+  CHECK(count() == 1);
+}
+
+TEST_CASE("logical or short-circuits", "[logical-or]")
+{
+  auto count = deferred::variable(0);
+  auto lhs   = deferred::variable(true);
+  auto ex    = lhs || [&] { return ++count() > 0; };
+
+  CHECK(ex());
+  CHECK(count() == 0);
+
+  lhs = false;
+  CHECK(ex());
+  CHECK(count() == 1);
+}
+
+TEST_CASE("logical n-ary", "[logical-n-ary]")
+{
+  std::vector<int> order;
+  auto operand = [&](int id, bool value) {
+    return [&order, id, value] {
+      order.push_back(id);
+      return value;
+    };
+  };
+
+  auto ex = deferred::make_logical_expression(
+    std::logical_and<>{}, operand(0, true), operand(1, false), operand(2, true));
+  CHECK(!ex());
+  CHECK(order == std::vector<int>{0, 1});
+
+  order.clear();
+  auto ey = deferred::make_logical_expression(
+    std::logical_or<>{}, operand(0, false), operand(1, false), operand(2, true));
+  CHECK(ey());
+  CHECK(order == std::vector<int>{0, 1, 2});
+}
+
+TEST_CASE("logical with overloaded operators", "[logical-overloaded]")
+{
+  auto count = deferred::variable(0);
+  auto x     = deferred::constant(tristate{0});
+  auto y     = deferred::invoke([&] {
+    ++count();
+    return tristate{2};
+  });
+
+  CHECK((x && y)().value == 0);
+  CHECK(count() == 1);
+  CHECK((x || y)().value == 2);
+  CHECK(count() == 2);
+}
+
+TEST_CASE("logical constant expression", "[logical-constant-expression]")
+{
+  constexpr auto ex = deferred::constant(true) && deferred::constant(false);
+  static_assert(deferred::is_constant_expression_v<decltype(ex)>);
+  STATIC_CHECK(!ex());
+
+  auto v  = deferred::variable(true);
+  auto ey = deferred::constant(true) || v;
+  static_assert(!deferred::is_constant_expression_v<decltype(ey)>);
+}
+
+TEST_CASE("logical visit", "[logical-visit]")
+{
+  auto ex = deferred::constant(true) && deferred::constant(false) && deferred::constant(true);
+
+  std::size_t nodes = 0;
+  ex.visit([&](auto const&, std::size_t) { ++nodes; });
+  // the chain is flattened into a single node
+  CHECK(nodes == 4);
+}
+
+TEST_CASE("logical elementwise", "[logical-elementwise]")
+{
+  auto x  = deferred::constant(std::vector<int>{1, 2, 3, 4});
+  auto ex = x > 1 && x < 4;
+
+  CHECK(deferred::elementwise_evaluate(ex) == std::vector<bool>{false, true, true, false});
+}
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "deferred/constant.hpp"
+#include "deferred/elementwise.hpp"
+#include "deferred/nary.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/type_traits/is_pure_expression.hpp"
+#include "deferred/variable.hpp"
+
+namespace {
+
+// Number of operands of the expression E.
+template<typename E>
+inline constexpr std::size_t operand_count_v =
+  std::tuple_size_v<typename std::remove_cvref_t<E>::expression_types>;
+
+// Creates a sum of x and sizeof...(I) constants.
+template<typename T, std::size_t... I>
+auto make_sum(T& x, std::index_sequence<I...>)
+{
+  return (x + ... + static_cast<int>(I));
+}
+
+} // namespace
+
+TEST_CASE("nary chain of additions", "[nary-plus]")
+{
+  auto x  = deferred::variable(1);
+  auto y  = deferred::variable(2);
+  auto ex = x + y + 3 + x;
+  using operator_type = typename decltype(ex)::operator_type;
+  static_assert(std::is_same_v<operator_type, deferred::nary_operator<std::plus<>>>);
+  static_assert(operand_count_v<decltype(ex)> == 4);
+  static_assert(deferred::is_pure_expression_v<decltype(ex)>);
+  CHECK(ex() == 1 + 2 + 3 + 1);
+
+  x = 10;
+  CHECK(ex() == 10 + 2 + 3 + 10);
+}
+
+TEST_CASE("nary binary node", "[nary-binary]")
+{
+  auto x  = deferred::variable(1);
+  auto ex = x + 2;
+  static_assert(std::is_same_v<typename decltype(ex)::operator_type, std::plus<>>);
+  CHECK(ex() == 3);
+}
+
+TEST_CASE("nary long chain", "[nary-long]")
+{
+  constexpr auto max_operands = deferred::max_nary_operands;
+
+  auto x          = deferred::variable(1);
+  auto full       = make_sum(x, std::make_index_sequence<max_operands - 1>{});
+  using full_type = decltype(full);
+  static_assert(operand_count_v<full_type> == max_operands);
+
+  // the full chain becomes the first operand of the next node
+  auto ex = make_sum(x, std::make_index_sequence<max_operands>{});
+  static_assert(operand_count_v<decltype(ex)> == 2);
+  static_assert(std::is_same_v<std::tuple_element_t<0, typename decltype(ex)::expression_types>,
+                               full_type>);
+  CHECK(ex() == 1 + (max_operands - 1) * max_operands / 2);
+
+  auto longer = make_sum(x, std::make_index_sequence<50>{});
+  static_assert(operand_count_v<decltype(longer)> <= max_operands);
+  CHECK(longer() == 1 + 49 * 50 / 2);
+}
+
+TEST_CASE("nary other operators", "[nary-operators]")
+{
+  auto x = deferred::variable(6);
+
+  auto product = x * 2 * 3;
+  static_assert(operand_count_v<decltype(product)> == 3);
+  CHECK(product() == 36);
+
+  auto bits = (x | 1) | 8 | 16;
+  static_assert(operand_count_v<decltype(bits)> == 4);
+  CHECK(bits() == (6 | 1 | 8 | 16));
+
+  auto masked = x & 7 & 2;
+  static_assert(operand_count_v<decltype(masked)> == 3);
+  CHECK(masked() == (6 & 7 & 2));
+
+  auto flipped = x ^ 1 ^ 2;
+  static_assert(operand_count_v<decltype(flipped)> == 3);
+  CHECK(flipped() == (6 ^ 1 ^ 2));
+}
+
+TEST_CASE("nary other operators are not flattened", "[nary-non-associative]")
+{
+  auto x  = deferred::variable(10);
+  auto ex = x - 1 - 2 + 3;
+  static_assert(operand_count_v<decltype(ex)> == 2);
+  CHECK(ex() == 10);
+
+  auto mixed = x + 1 + x * 2 * 3;
+  static_assert(operand_count_v<decltype(mixed)> == 3);
+  CHECK(mixed() == 10 + 1 + 60);
+}
+
+TEST_CASE("nary lvalue chains are not flattened", "[nary-lvalue]")
+{
+  auto x   = deferred::variable(1);
+  auto sum = x + 2 + 3;
+  auto ex  = sum + 4;
+  static_assert(operand_count_v<decltype(ex)> == 2);
+  CHECK(ex() == 10);
+
+  x = 2;
+  CHECK(ex() == 11);
+}
+
+TEST_CASE("nary logical chains", "[nary-logical]")
+{
+  auto count = deferred::variable(0);
+  auto a     = deferred::variable(true);
+  auto b     = deferred::variable(false);
+  auto ex    = a && b && [&] { return ++count() > 0; };
+  static_assert(operand_count_v<decltype(ex)> == 3);
+  CHECK(!ex());
+  CHECK(count() == 0);
+
+  b = true;
+  CHECK(ex());
+  CHECK(count() == 1);
+
+  auto any = b || a || [&] { return ++count() > 0; };
+  static_assert(operand_count_v<decltype(any)> == 3);
+  CHECK(any());
+  CHECK(count() == 1);
+
+  auto all = a && a && a && a && a && a && a && a && a && b;
+  static_assert(operand_count_v<decltype(all)> <= deferred::max_nary_operands);
+  CHECK(all());
+}
+
+TEST_CASE("nary constant chain", "[nary-constant]")
+{
+  constexpr auto ex = deferred::constant(1) + 2 + 3;
+  static_assert(deferred::is_constant_expression_v<decltype(ex)>);
+  static_assert(ex() == 6);
+}
+
+TEST_CASE("nary non-copyable values", "[nary-move]")
+{
+  auto x  = deferred::variable(std::string("a"));
+  auto ex = x + std::string("b") + std::string("c") + std::string("d");
+  static_assert(operand_count_v<decltype(ex)> == 4);
+  CHECK(ex() == "abcd");
+}
+
+TEST_CASE("nary pairwise", "[nary-pairwise]")
+{
+  auto x  = deferred::variable(1.0);
+  auto ex = deferred::pairwise(x + 1e100 + 1.0 + -1e100);
+  using operator_type = typename decltype(ex)::operator_type;
+  static_assert(std::is_same_v<operator_type, deferred::pairwise_operator<std::plus<>>>);
+  static_assert(deferred::is_pure_expression_v<decltype(ex)>);
+  // (x + 1e100) + (1.0 + -1e100)
+  CHECK(ex() == (1.0 + 1e100) + (1.0 + -1e100));
+
+  auto s = deferred::variable(std::string("a"));
+  auto c = deferred::pairwise(s + std::string("b") + std::string("c"));
+  CHECK(c() == "abc");
+
+  // nested chains are reduced as a single chain
+  auto y        = deferred::variable(1);
+  auto long_sum = deferred::pairwise(make_sum(y, std::make_index_sequence<50>{}));
+  static_assert(operand_count_v<decltype(long_sum)> == 51);
+  CHECK(long_sum() == 1 + 49 * 50 / 2);
+}
+
+TEST_CASE("nary elementwise", "[nary-elementwise]")
+{
+  std::vector<int> a{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
+  auto x  = deferred::constant(a);
+  auto ex = x + x + deferred::constant(2) + x;
+
+  auto const result = deferred::elementwise_evaluate(ex);
+  REQUIRE(result.size() == a.size());
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    CHECK(result[i] == 3 * a[i] + 2);
+  }
+}
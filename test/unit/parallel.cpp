@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <latch>
+#include <stdexcept>
+#include <string>
+
+#include "deferred/constant.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/parallel.hpp"
+#include "deferred/thread_pool.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+
+TEST_CASE("par evaluates subexpressions concurrently", "[par]")
+{
+  deferred::thread_pool pool(2);
+  std::latch all(3);
+  auto x    = deferred::variable(1);
+  auto term = [&](int k) {
+    return deferred::invoke(
+      [&all, k](int v) {
+        all.arrive_and_wait();
+        return v * k;
+      },
+      x);
+  };
+
+  auto sum = [](int a, int b, int c) { return a + b + c; };
+  auto ex  = deferred::par_(pool, deferred::invoke(sum, term(1), term(2), term(3)));
+  static_assert(!deferred::is_constant_expression_v<decltype(ex)>);
+  CHECK(ex() == 6);
+}
+
+TEST_CASE("par with references", "[par-references]")
+{
+  auto x  = deferred::variable(std::string("deferred"));
+  auto y  = deferred::variable(std::string("evaluation"));
+  auto ex = deferred::par_(deferred::invoke(
+    [](std::string const& a, std::string const& b) { return a + " " + b; }, x, y));
+  CHECK(ex() == "deferred evaluation");
+
+  x = "lazy";
+  CHECK(ex() == "lazy evaluation");
+}
+
+TEST_CASE("par nested", "[par-nested]")
+{
+  deferred::thread_pool pool(1);
+  auto x     = deferred::variable(2);
+  auto inner = deferred::par_(pool, x * x);
+  auto ex    = deferred::par_(pool, inner + inner);
+  CHECK(ex() == 8);
+}
+
+TEST_CASE("par exception", "[par-exception]")
+{
+  auto ex = deferred::par_(
+    deferred::invoke([](int a, int b) { return a + b; },
+                     deferred::constant(1),
+                     deferred::invoke([]() -> int { throw std::runtime_error("error"); })));
+  CHECK_THROWS_AS(ex(), std::runtime_error);
+}
+
+TEST_CASE("par visit", "[par-visit]")
+{
+  auto ex = deferred::par_(deferred::constant(1) + deferred::constant(2));
+
+  std::size_t nodes = 0;
+  ex.visit([&](auto const&, std::size_t) { ++nodes; });
+  CHECK(nodes == 4);
+}
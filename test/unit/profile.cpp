@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "deferred/conditional.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/profile.hpp"
+#include "deferred/switch.hpp"
+#include "deferred/type_name.hpp"
+#include "deferred/type_traits/is_pure_expression.hpp"
+#include "deferred/variable.hpp"
+#include "deferred/while.hpp"
+
+TEST_CASE("profile operators", "[profile-operators]")
+{
+  auto x  = deferred::variable(2);
+  auto ex = deferred::profiled_((x + 1) * (x - 1));
+  static_assert(!deferred::is_pure_expression_v<decltype(ex)>);
+  CHECK(ex() == 3);
+
+  x = 4;
+  CHECK(ex() == 15);
+
+  auto const report = deferred::profile_report(ex);
+  REQUIRE(report.size() == 3);
+  CHECK(report[0].name == deferred::type_name<std::multiplies<>>());
+  CHECK(report[0].nesting == 0);
+  CHECK(report[1].nesting == 1);
+  CHECK(report[2].nesting == 1);
+  for (auto const& node : report)
+  {
+    CHECK(node.statistics.calls == 2);
+    CHECK(node.statistics.max <= node.statistics.total);
+    CHECK(node.hits.empty());
+  }
+  CHECK(report[0].statistics.total >= report[1].statistics.total);
+
+  deferred::profile_reset(ex);
+  CHECK(deferred::profile_report(ex)[0].statistics.calls == 0);
+}
+
+TEST_CASE("profile conditional", "[profile-conditional]")
+{
+  auto x  = deferred::variable(0);
+  auto ex = deferred::profiled_(deferred::if_(x < 0, x * -1).else_if(x == 0, 100).else_(x + 1));
+
+  std::vector<int> results;
+  for (int i : {-2, 0, 0, 3, 5})
+  {
+    x = i;
+    results.push_back(ex());
+  }
+  CHECK(results == std::vector<int>{2, 100, 100, 4, 6});
+
+  auto const report = deferred::profile_report(ex);
+  REQUIRE(!report.empty());
+  CHECK(report[0].name == "if_");
+  CHECK(report[0].statistics.calls == 5);
+  CHECK(report[0].hits == std::vector<std::uint64_t>{1, 2, 2});
+}
+
+TEST_CASE("profile non-finalized conditional", "[profile-conditional-no-else]")
+{
+  auto x  = deferred::variable(0);
+  auto ex = deferred::profiled_(deferred::if_(x > 0, 1));
+  CHECK(ex() == std::nullopt);
+  x = 1;
+  CHECK(ex() == 1);
+  CHECK(ex() == 1);
+  CHECK(ex.hits() == std::vector<std::uint64_t>{2, 1});
+}
+
+TEST_CASE("profile switch", "[profile-switch]")
+{
+  auto x  = deferred::variable(0);
+  auto ex = deferred::profiled_(deferred::switch_(x,
+                                                  deferred::default_(std::string("none")),
+                                                  deferred::case_(1, std::string("a")),
+                                                  deferred::case_(2, std::string("b"))));
+  for (int i : {1, 2, 2, 3})
+  {
+    x = i;
+    static_cast<void>(ex());
+  }
+  CHECK(ex.statistics().calls == 4);
+  CHECK(ex.hits() == std::vector<std::uint64_t>{1, 2, 1});
+
+  x = 2;
+  CHECK(ex() == "b");
+}
+
+TEST_CASE("profile while", "[profile-while]")
+{
+  auto i   = deferred::variable(0);
+  auto sum = deferred::variable(0);
+  auto ex  = deferred::profiled_(
+    deferred::while_(i < 10, deferred::invoke([](int& s, int v) { s += v; }, sum, i++)));
+  ex();
+  CHECK(sum() == 45);
+
+  auto const report = deferred::profile_report(ex);
+  // while_, condition, body, and i++
+  REQUIRE(report.size() == 4);
+  CHECK(report[0].name == "while_");
+  CHECK(report[0].statistics.calls == 1);
+  CHECK(report[1].statistics.calls == 11);
+  CHECK(report[2].statistics.calls == 10);
+  CHECK(report[3].nesting == 2);
+  CHECK(report[3].statistics.calls == 10);
+}
+
+TEST_CASE("profile references variables", "[profile-variable]")
+{
+  auto x   = deferred::variable(1);
+  auto sum = x + 1;
+  auto ex  = deferred::profiled_(sum * 2);
+  CHECK(ex() == 4);
+
+  x = 2;
+  CHECK(ex() == 6);
+}
+
+TEST_CASE("evaluate profiled", "[profile-evaluate]")
+{
+  auto x = deferred::variable(3);
+  std::vector<deferred::node_profile> report;
+  CHECK(deferred::evaluate_profiled(x * x + 1, report) == 10);
+  REQUIRE(report.size() == 2);
+  CHECK(report[0].statistics.calls == 1);
+  CHECK(report[1].statistics.calls == 1);
+  CHECK(!report[0].name.empty());
+}
@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "deferred/cached.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/runtime_graph.hpp"
+#include "deferred/type_traits/is_deferred.hpp"
+#include "deferred/variable.hpp"
+
+using deferred::runtime_operator;
+
+static_assert(deferred::is_deferred_v<deferred::runtime_program<int>>);
+
+TEST_CASE("runtime_graph arithmetic", "[runtime_graph-arithmetic]")
+{
+  deferred::runtime_graph<int> g;
+  auto const x  = g.variable("x");
+  auto const y  = g.variable("y");
+  auto const ex = g.operation(
+    runtime_operator::modulus,
+    g.operation(runtime_operator::plus,
+                g.operation(runtime_operator::multiplies, x, g.constant(3)),
+                g.operation(runtime_operator::negate, y)),
+    g.constant(7));
+
+  auto xv      = deferred::variable(5);
+  auto yv      = deferred::variable(2);
+  auto program = g.compile(ex, {{"x", &xv}, {"y", &yv}});
+  CHECK(program() == (5 * 3 - 2) % 7);
+
+  xv = 10;
+  yv = 1;
+  CHECK(program() == (10 * 3 - 1) % 7);
+}
+
+TEST_CASE("runtime_graph operators", "[runtime_graph-operators]")
+{
+  auto const check = [](runtime_operator op, int a, int b, int expected) {
+    deferred::runtime_graph<int> g;
+    auto xv = deferred::variable(a);
+    auto yv = deferred::variable(b);
+    auto ex = g.operation(op, g.variable("x"), g.variable("y"));
+    auto p  = g.compile(ex, {{"x", &xv}, {"y", &yv}});
+    CHECK(p() == expected);
+  };
+  check(runtime_operator::minus, 7, 3, 4);
+  check(runtime_operator::divides, 7, 3, 2);
+  check(runtime_operator::equal_to, 7, 7, 1);
+  check(runtime_operator::not_equal_to, 7, 7, 0);
+  check(runtime_operator::greater, 7, 3, 1);
+  check(runtime_operator::less, 7, 3, 0);
+  check(runtime_operator::greater_equal, 3, 3, 1);
+  check(runtime_operator::less_equal, 4, 3, 0);
+  check(runtime_operator::bit_and, 6, 3, 2);
+  check(runtime_operator::bit_or, 6, 3, 7);
+  check(runtime_operator::bit_xor, 6, 3, 5);
+  check(runtime_operator::shift_left, 1, 4, 16);
+  check(runtime_operator::shift_right, 16, 2, 4);
+  check(runtime_operator::logical_and, 2, 0, 0);
+  check(runtime_operator::logical_and, 2, 3, 1);
+  check(runtime_operator::logical_or, 0, 0, 0);
+  check(runtime_operator::logical_or, 0, 5, 1);
+
+  deferred::runtime_graph<int> g;
+  auto const c = g.constant(6);
+  CHECK(g.compile(g.operation(runtime_operator::bit_not, c), {})() == ~6);
+  CHECK(g.compile(g.operation(runtime_operator::logical_not, c), {})() == 0);
+  CHECK(g.compile(g.operation(runtime_operator::unary_plus, c), {})() == 6);
+}
+
+TEST_CASE("runtime_graph short-circuit", "[runtime_graph-short-circuit]")
+{
+  deferred::runtime_graph<int> g;
+  auto const x   = g.variable("x");
+  auto const inc = g.operation(runtime_operator::pre_increment, x);
+  auto const ex  = g.operation(runtime_operator::logical_or,
+                              g.operation(runtime_operator::logical_and, g.variable("c"), inc),
+                              inc);
+
+  auto xv = deferred::variable(0);
+  auto cv = deferred::variable(0);
+  auto p  = g.compile(ex, {{"x", &xv}, {"c", &cv}});
+
+  // c && ++x is false without evaluating ++x, so ++x is evaluated once
+  CHECK(p() == 1);
+  CHECK(xv() == 1);
+
+  // c && ++x is true, so the right operand of || is not evaluated
+  cv = 1;
+  CHECK(p() == 1);
+  CHECK(xv() == 2);
+}
+
+TEST_CASE("runtime_graph if_", "[runtime_graph-if]")
+{
+  deferred::runtime_graph<double> g;
+  auto const x  = g.variable("x");
+  auto const ex = g.if_(g.operation(runtime_operator::less, x, g.constant(0.0)),
+                        g.operation(runtime_operator::negate, x),
+                        g.operation(runtime_operator::multiplies, x, g.constant(2.0)));
+
+  auto xv = deferred::variable(-1.5);
+  auto p  = g.compile(ex, {{"x", &xv}});
+  CHECK(p() == 1.5);
+  xv = 2.0;
+  CHECK(p() == 4.0);
+}
+
+TEST_CASE("runtime_graph switch_", "[runtime_graph-switch]")
+{
+  deferred::runtime_graph<int> g;
+  auto const x  = g.variable("x");
+  auto const ex = g.switch_(x,
+                            {{1, g.constant(10)},
+                             {2, g.operation(runtime_operator::multiplies, x, g.constant(20))},
+                             {2, g.constant(-1)},
+                             {3, g.constant(30)}},
+                            g.constant(0));
+
+  auto xv = deferred::variable(0);
+  auto p  = g.compile(ex, {{"x", &xv}});
+  std::vector<std::pair<int, int>> const expected{{1, 10}, {2, 40}, {3, 30}, {4, 0}};
+  for (auto const& [value, result] : expected)
+  {
+    xv = value;
+    CHECK(p() == result);
+  }
+}
+
+TEST_CASE("runtime_graph while_", "[runtime_graph-while]")
+{
+  deferred::runtime_graph<std::int64_t> g;
+  auto const i    = g.variable("i");
+  auto const n    = g.variable("n");
+  auto const loop = g.while_(g.operation(runtime_operator::less, i, n),
+                             g.operation(runtime_operator::pre_increment, i));
+  auto const ex   = g.operation(runtime_operator::plus, loop, i);
+
+  auto iv = deferred::variable<std::int64_t>();
+  auto nv = deferred::variable<std::int64_t>(100);
+  auto p  = g.compile(ex, {{"i", &iv}, {"n", &nv}});
+
+  auto const version = iv.version();
+  CHECK(p() == 100);
+  CHECK(iv() == 100);
+  CHECK(iv.version() == version + 100);
+  CHECK(p() == 100);
+}
+
+TEST_CASE("runtime_graph shared nodes", "[runtime_graph-shared]")
+{
+  deferred::runtime_graph<int> g;
+  auto const x   = g.variable("x");
+  auto const sq  = g.operation(runtime_operator::multiplies, x, x);
+  auto const ex  = g.operation(runtime_operator::plus, sq, sq);
+  auto const inc = g.operation(runtime_operator::post_increment, x);
+  auto const ex2 = g.operation(runtime_operator::plus, inc, inc);
+
+  auto xv = deferred::variable(3);
+  auto p  = g.compile(ex, {{"x", &xv}});
+  // x is loaded once and x * x is computed once
+  CHECK(p.instruction_count() == 4);
+  CHECK(p() == 18);
+
+  // nodes with side effects are evaluated for each use
+  auto p2 = g.compile(ex2, {{"x", &xv}});
+  CHECK(p2() == 7);
+  CHECK(xv() == 5);
+}
+
+TEST_CASE("runtime_program as subexpression", "[runtime_graph-subexpression]")
+{
+  deferred::runtime_graph<int> g;
+  auto xv = deferred::variable(4);
+  auto p  = g.compile(g.operation(runtime_operator::multiplies, g.variable("x"), g.constant(2)),
+                     {{"x", &xv}});
+
+  auto ex = p + xv;
+  CHECK(ex() == 12);
+
+  // the variables of the program are not visible, so the cached expression always re-evaluates
+  auto c = deferred::cached_(p);
+  CHECK(c() == 8);
+  xv = 10;
+  CHECK(c() == 20);
+}
+
+TEST_CASE("runtime_graph errors", "[runtime_graph-errors]")
+{
+  deferred::runtime_graph<double> g;
+  auto const x = g.variable("x");
+  auto const c = g.constant(1.0);
+  CHECK_THROWS_AS(g.operation(runtime_operator::plus, x), std::invalid_argument);
+  CHECK_THROWS_AS(g.operation(runtime_operator::negate, x, c), std::invalid_argument);
+  CHECK_THROWS_AS(g.operation(runtime_operator::modulus, x, c), std::invalid_argument);
+  CHECK_THROWS_AS(g.operation(runtime_operator::pre_increment, c), std::invalid_argument);
+  CHECK_THROWS_AS(g.operation(runtime_operator::plus, x, deferred::runtime_node{100}),
+                  std::invalid_argument);
+  CHECK_THROWS_AS(g.compile(x, {}), std::invalid_argument);
+}
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+
+#include "deferred/constant.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/shared.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+
+TEST_CASE("shared evaluated once per evaluate_cse", "[shared]")
+{
+  int count = 0;
+  auto v    = deferred::variable(2);
+  auto s    = deferred::shared_(deferred::invoke(
+    [&count](int x) {
+      ++count;
+      return x * 3;
+    },
+    v));
+  auto ex   = s + s * s;
+
+  CHECK(deferred::evaluate_cse(ex) == 42);
+  CHECK(count == 1);
+
+  v = 1;
+  CHECK(deferred::evaluate_cse(ex) == 12);
+  CHECK(count == 2);
+
+  // without evaluate_cse each reference is evaluated
+  CHECK(ex() == 12);
+  CHECK(count == 5);
+}
+
+TEST_CASE("shared nested evaluate_cse", "[shared-nested]")
+{
+  int count = 0;
+  auto s    = deferred::shared_(deferred::invoke([&count] { return ++count; }));
+  auto ex   = deferred::invoke([&](int x) { return x + deferred::evaluate_cse(s + s); }, s);
+
+  // the nested evaluation is a separate one
+  CHECK(deferred::evaluate_cse(ex) == 5);
+  CHECK(count == 2);
+}
+
+TEST_CASE("shared constant expression", "[shared-constant]")
+{
+  constexpr auto c = deferred::constant(2);
+  auto s           = deferred::shared_(c * c);
+  static_assert(deferred::is_constant_expression_v<decltype(s)>);
+  CHECK(deferred::evaluate_cse(s + s) == 8);
+}
+
+TEST_CASE("shared visit", "[shared-visit]")
+{
+  auto s = deferred::shared_(deferred::constant(1));
+
+  std::size_t nodes = 0;
+  s.visit([&](auto const&, std::size_t) { ++nodes; });
+  CHECK(nodes == 2);
+}
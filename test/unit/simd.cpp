@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "deferred/constant.hpp"
+#include "deferred/elementwise.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/simd.hpp"
+#include "deferred/variable.hpp"
+
+namespace {
+
+constexpr deferred::simd_isa all_isas[] = {deferred::simd_isa::scalar,
+                                           deferred::simd_isa::sse2,
+                                           deferred::simd_isa::avx2,
+                                           deferred::simd_isa::avx512};
+
+} // namespace
+
+TEST_CASE("simd lanes", "[simd-lanes]")
+{
+  STATIC_CHECK(deferred::simd_lanes<float>(deferred::simd_isa::scalar) == 1);
+  STATIC_CHECK(deferred::simd_lanes<float>(deferred::simd_isa::sse2) == 4);
+  STATIC_CHECK(deferred::simd_lanes<double>(deferred::simd_isa::avx2) == 4);
+  STATIC_CHECK(deferred::simd_lanes<std::int8_t>(deferred::simd_isa::avx512) == 64);
+}
+
+TEST_CASE("simd arithmetic", "[simd-arithmetic]")
+{
+  // offsets and sizes exercise the unaligned head, the aligned blocks and the tail
+  for (auto isa : all_isas)
+  {
+    for (std::size_t offset : {0, 1, 3})
+    {
+      for (std::size_t n : {0, 1, 7, 16, 67})
+      {
+        std::vector<float> x_data(n + offset), y_data(n + offset), out_data(n + offset);
+        for (std::size_t i = 0; i < x_data.size(); ++i)
+        {
+          x_data[i] = static_cast<float>(i);
+          y_data[i] = static_cast<float>(2 * i + 1);
+        }
+        auto x   = deferred::variable(std::span<float const>(x_data).subspan(offset));
+        auto y   = deferred::variable(std::span<float const>(y_data).subspan(offset));
+        auto out = std::span<float>(out_data).subspan(offset);
+
+        deferred::elementwise_evaluate(-(deferred::constant(2.0f) * x + y) / 2.0f, out, isa);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          CHECK(out[i] == -(2.0f * x()[i] + y()[i]) / 2.0f);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("simd bitwise", "[simd-bitwise]")
+{
+  std::vector<std::uint32_t> x(37), y(37);
+  for (std::uint32_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = i * 0x01010101u;
+    y[i] = ~i;
+  }
+  auto cx = deferred::constant(std::span(std::as_const(x)));
+  auto cy = deferred::constant(std::span(std::as_const(y)));
+  auto ex = (~cx & cy) ^ (cy | 0xF0u);
+
+  for (auto isa : all_isas)
+  {
+    std::vector<std::uint32_t> out(x.size());
+    deferred::elementwise_evaluate(ex, out, isa);
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+      CHECK(out[i] == ((~x[i] & y[i]) ^ (y[i] | 0xF0u)));
+    }
+  }
+}
+
+TEST_CASE("simd comparison", "[simd-comparison]")
+{
+  std::vector<double> x(29), y(29);
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = static_cast<double>(i);
+    y[i] = static_cast<double>(x.size() - i);
+  }
+  auto cx = deferred::constant(std::span(std::as_const(x)));
+  auto cy = deferred::constant(std::span(std::as_const(y)));
+  auto ex = cx * 2.0 < cy;
+
+  for (auto isa : all_isas)
+  {
+    bool out[29] = {};
+    deferred::elementwise_evaluate(ex, out, isa);
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+      CHECK(out[i] == (x[i] * 2.0 < y[i]));
+    }
+  }
+  CHECK(deferred::elementwise_evaluate(ex).size() == x.size());
+}
+
+TEST_CASE("simd with mixed types", "[simd-mixed-types]")
+{
+  // int * double promotes the elements, therefore the scalar path is used
+  std::vector<int> x{1, 2, 3, 4, 5};
+  auto ex = deferred::constant(std::span(std::as_const(x))) * 0.5;
+
+  std::vector<double> out(x.size());
+  deferred::elementwise_evaluate(ex, out, deferred::simd_isa::avx2);
+  CHECK(out == std::vector<double>{0.5, 1.0, 1.5, 2.0, 2.5});
+}
@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <string>
+#include <type_traits>
+
+#include "deferred/constant.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/simplify.hpp"
+#include "deferred/variable.hpp"
+
+namespace {
+
+struct meters
+{
+  double value;
+
+  friend meters operator*(meters m, int k)
+  {
+    return {m.value * k};
+  }
+};
+
+} // namespace
+
+TEST_CASE("simplify identities", "[simplify]")
+{
+  auto x = deferred::variable(3);
+
+  SECTION("multiplication")
+  {
+    static_assert(std::is_same_v<decltype(deferred::simplify(x * deferred::constant_c<1>)),
+                                 deferred::variable_<int>&>);
+    static_assert(std::is_same_v<decltype(deferred::simplify(deferred::constant_c<1> * x)),
+                                 deferred::variable_<int>&>);
+    CHECK(&deferred::simplify(x * deferred::constant_c<1>) == &x);
+  }
+
+  SECTION("addition and subtraction")
+  {
+    static_assert(std::is_same_v<decltype(deferred::simplify(x + deferred::constant_c<0>)),
+                                 deferred::variable_<int>&>);
+    static_assert(std::is_same_v<decltype(deferred::simplify(deferred::constant_c<0> + x)),
+                                 deferred::variable_<int>&>);
+    static_assert(std::is_same_v<decltype(deferred::simplify(x - deferred::constant_c<0>)),
+                                 deferred::variable_<int>&>);
+    static_assert(!std::is_same_v<decltype(deferred::simplify(deferred::constant_c<0> - x)),
+                                  deferred::variable_<int>&>);
+  }
+
+  SECTION("negation")
+  {
+    static_assert(std::is_same_v<decltype(deferred::simplify(-(-x))), deferred::variable_<int>&>);
+
+    auto b = deferred::variable(true);
+    static_assert(std::is_same_v<decltype(deferred::simplify(!(!b))), deferred::variable_<bool>&>);
+    // !!x is a bool, not x
+    CHECK(deferred::simplify(!(!x))() == true);
+  }
+
+  SECTION("nested")
+  {
+    auto ex = (x + deferred::constant_c<0>) * deferred::constant_c<1> - -(-(x * 2));
+    auto s  = deferred::simplify(ex);
+    CHECK(deferred::node_count(s) < deferred::node_count(ex));
+    CHECK(deferred::node_count(ex) - deferred::node_count(s) == 6);
+    CHECK(s() == ex());
+
+    x = 5;
+    CHECK(s() == -5);
+  }
+}
+
+TEST_CASE("simplify chains", "[simplify-chains]")
+{
+  auto x = deferred::variable(3);
+  auto y = deferred::variable(4);
+
+  SECTION("identities")
+  {
+    auto sum = x + deferred::constant_c<0> + y;
+    auto s   = deferred::simplify(sum);
+    CHECK(deferred::node_count(sum) - deferred::node_count(s) == 1);
+    CHECK(s() == 7);
+
+    auto product = x * deferred::constant_c<1> * y * deferred::constant_c<1>;
+    auto p       = deferred::simplify(product);
+    CHECK(deferred::node_count(product) - deferred::node_count(p) == 2);
+    CHECK(p() == 12);
+
+    static_assert(std::is_same_v<decltype(deferred::simplify(deferred::constant_c<0> + x
+                                                             + deferred::constant_c<0>)),
+                                 deferred::variable_<int>&>);
+  }
+
+  SECTION("absorbing element")
+  {
+    auto product = x * y * deferred::constant_c<0> * x;
+    auto s       = deferred::simplify(product);
+    static_assert(std::is_same_v<decltype(s), deferred::constant_<int>>);
+    CHECK(s() == 0);
+
+    // x * 0 is NaN for infinite x
+    auto d = deferred::variable(1.0);
+    static_assert(!std::is_same_v<decltype(deferred::simplify(d * d * deferred::constant_c<0>)),
+                                  deferred::constant_<double>>);
+  }
+
+  SECTION("side effects")
+  {
+    int calls    = 0;
+    auto product = x * [&] { return ++calls; } * deferred::constant_c<0>;
+    auto s       = deferred::simplify(product);
+    CHECK(s() == 0);
+    CHECK(calls == 1);
+  }
+
+  SECTION("types change")
+  {
+    // x + 0 + y is a long
+    auto z = deferred::variable(2L);
+    auto s = deferred::simplify(x + deferred::constant_c<0> + z);
+    static_assert(std::is_same_v<decltype(s()), long>);
+    CHECK(s() == 5);
+  }
+
+  SECTION("nested chains")
+  {
+    auto sum = x + deferred::constant_c<0> + x + x + x + x + x + x + x + deferred::constant_c<0> + y;
+    auto s   = deferred::simplify(sum);
+    CHECK(deferred::node_count(sum) - deferred::node_count(s) == 2);
+    CHECK(s() == sum());
+  }
+}
+
+TEST_CASE("simplify preserves semantics", "[simplify-semantics]")
+{
+  SECTION("types change")
+  {
+    // x * 1 is an int
+    auto x = deferred::variable<short>(2);
+    auto s = deferred::simplify(x * deferred::constant_c<1>);
+    static_assert(std::is_same_v<decltype(s()), int>);
+    CHECK(s() == 2);
+  }
+
+  SECTION("floating-point")
+  {
+    auto x = deferred::variable(-0.0);
+    auto s = deferred::simplify(x + deferred::constant_c<0>);
+    CHECK(!std::signbit(s()));
+    static_assert(std::is_same_v<decltype(deferred::simplify(x * deferred::constant_c<1>)),
+                                 deferred::variable_<double>&>);
+  }
+
+  SECTION("user-defined types")
+  {
+    auto m = deferred::variable(meters{2.0});
+    auto s = deferred::simplify(m * deferred::constant_c<1>);
+    static_assert(!std::is_same_v<decltype(s), deferred::variable_<meters>&>);
+    CHECK(s().value == 2.0);
+  }
+
+  SECTION("strings")
+  {
+    auto x = deferred::variable(std::string("a"));
+    auto s = deferred::simplify(x + std::string("b"));
+    CHECK(s() == "ab");
+  }
+}
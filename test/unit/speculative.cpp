@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <latch>
+#include <optional>
+#include <stdexcept>
+
+#include "deferred/conditional.hpp"
+#include "deferred/constant.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/speculative.hpp"
+#include "deferred/thread_pool.hpp"
+#include "deferred/type_traits/is_pure_expression.hpp"
+#include "deferred/variable.hpp"
+
+TEST_CASE("speculative evaluates the then branch concurrently", "[speculative]")
+{
+  deferred::thread_pool pool(1);
+  std::latch started(1);
+  auto x = deferred::variable(3);
+  auto condition =
+    deferred::invoke(deferred::pure([&started](int v) {
+                       // only returns if the then branch is evaluated concurrently
+                       started.wait();
+                       return v > 0;
+                     }),
+                     x);
+  auto then = deferred::invoke(deferred::pure([&started](int v) {
+                                 started.count_down();
+                                 return v * 2;
+                               }),
+                               x);
+  auto ex = deferred::speculative_(pool, deferred::if_(condition, then).else_(0));
+  CHECK(ex() == 6);
+}
+
+TEST_CASE("speculative branches", "[speculative-branches]")
+{
+  deferred::thread_pool pool(2);
+  auto x    = deferred::variable(0);
+  auto cond = deferred::if_(x > 0, x * 10).else_if(x < 0, -x).else_(x + 100);
+
+  auto ex      = deferred::speculative_(pool, cond);
+  auto ex_else = deferred::speculative_<deferred::speculation::then_and_else>(pool, cond);
+  for (int v : {5, -3, 0, 7, -1})
+  {
+    x = v;
+    CHECK(ex() == cond());
+    CHECK(ex_else() == cond());
+  }
+}
+
+TEST_CASE("speculative without else", "[speculative-no-else]")
+{
+  auto x  = deferred::variable(1);
+  auto ex = deferred::speculative_(deferred::if_(x > 0, x + 1));
+  CHECK(ex() == std::optional<int>(2));
+
+  x = -1;
+  CHECK(ex() == std::nullopt);
+}
+
+TEST_CASE("speculative with impure unspeculated branch", "[speculative-impure]")
+{
+  deferred::thread_pool pool(2);
+  auto x  = deferred::variable(0);
+  auto y  = deferred::variable(0);
+  auto ex = deferred::speculative_(pool, deferred::if_(x > 0, y + 1).else_(++y));
+  CHECK(ex() == 1);
+  CHECK(ex() == 2);
+
+  x = 1;
+  CHECK(ex() == 3);
+  CHECK(y() == 2);
+}
+
+TEST_CASE("speculative exception", "[speculative-exception]")
+{
+  deferred::thread_pool pool(2);
+  std::atomic<int> evaluations{0};
+  auto x      = deferred::variable(1);
+  auto throws = deferred::invoke(deferred::pure([&evaluations](int v) -> int {
+                                   ++evaluations;
+                                   throw std::runtime_error("then");
+                                   return v;
+                                 }),
+                                 x);
+  auto ex = deferred::speculative_<deferred::speculation::then_and_else>(
+    pool, deferred::if_(x > 0, throws).else_(x * 1));
+
+  // the exception of the chosen branch is rethrown
+  CHECK_THROWS_AS(ex(), std::runtime_error);
+  CHECK(evaluations == 1);
+
+  // the exception of a losing branch is discarded
+  x = 0;
+  CHECK(ex() == 0);
+  CHECK(evaluations <= 2);
+}
@@ -3,10 +3,27 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 
+#include "deferred/detail/switch_table.hpp"
 #include "deferred/switch.hpp"
 #include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+
+namespace {
+
+enum class color
+{
+  red,
+  green,
+  blue = 100
+};
+
+} // namespace
 
 TEST_CASE("default with literal", "[default-literal]")
 {
@@ -129,3 +146,220 @@ TEST_CASE("append case with void result", "[switch-append-void]")
 
   CHECK(std::holds_alternative<std::monostate>(expanded()));
 }
+
+TEST_CASE("switch table", "[switch-table]")
+{
+  SECTION("dense")
+  {
+    constexpr deferred::detail::switch_table<int, 4> table(std::array{3, 1, 2, 1});
+    STATIC_CHECK(table.find(1) == 2);
+    STATIC_CHECK(table.find(2) == 3);
+    STATIC_CHECK(table.find(3) == 1);
+    STATIC_CHECK(table.find(0) == 0);
+    STATIC_CHECK(table.find(4) == 0);
+    STATIC_CHECK(table.find(-1) == 0);
+  }
+
+  SECTION("sparse")
+  {
+    constexpr deferred::detail::switch_table<long, 3> table(std::array{1000L, -5L, 1000L});
+    STATIC_CHECK(table.find(1000) == 1);
+    STATIC_CHECK(table.find(-5) == 2);
+    STATIC_CHECK(table.find(0) == 0);
+    STATIC_CHECK(table.find(1001) == 0);
+  }
+
+  SECTION("key types")
+  {
+    using namespace deferred;
+    using detail::switch_hash_key_t;
+    using detail::switch_table_key_t;
+    static_assert(std::is_same_v<switch_table_key_t<char, constant_<int>>, int>);
+    static_assert(std::is_same_v<switch_table_key_t<int, constant_<unsigned>>, unsigned>);
+    static_assert(std::is_same_v<switch_table_key_t<color, constant_<color>>, int>);
+    static_assert(std::is_void_v<switch_table_key_t<color, constant_<int>>>);
+    static_assert(std::is_void_v<switch_table_key_t<int, constant_<double>>>);
+    static_assert(std::is_void_v<switch_table_key_t<int, expression_<int (*)()>>>);
+
+    static_assert(
+      std::is_same_v<switch_hash_key_t<std::string, constant_<char const*>>, std::string_view>);
+    static_assert(std::is_same_v<switch_hash_key_t<std::string_view, constant_<std::string>>,
+                                 std::string_view>);
+    static_assert(std::is_same_v<switch_hash_key_t<double, constant_<double>>, double>);
+    static_assert(
+      std::is_same_v<switch_hash_key_t<char const*, constant_<char const*>>, char const*>);
+    static_assert(std::is_void_v<switch_hash_key_t<double, constant_<float>>>);
+  }
+}
+
+TEST_CASE("switch with constant labels", "[switch-constant-labels]")
+{
+  auto var = deferred::variable<int>();
+  auto ex  = deferred::switch_(var,
+                               deferred::default_(-1),
+                               deferred::case_(30, 3),
+                               deferred::case_(10, 1),
+                               deferred::case_(20, 2),
+                               deferred::case_(10, 4));
+
+  var = 10;
+  CHECK(ex() == 1);
+  var = 20;
+  CHECK(ex() == 2);
+  var = 30;
+  CHECK(ex() == 3);
+  var = 15;
+  CHECK(ex() == -1);
+  var = -10;
+  CHECK(ex() == -1);
+
+  auto expanded = ex.append(deferred::case_(15, 5), deferred::case_(20, 6));
+  var           = 15;
+  CHECK(expanded() == 5);
+  var = 20;
+  CHECK(expanded() == 2);
+}
+
+TEST_CASE("switch with sparse labels", "[switch-sparse-labels]")
+{
+  auto var = deferred::variable<std::int64_t>();
+  auto ex  = deferred::switch_(var,
+                               deferred::default_(0),
+                               deferred::case_(std::int64_t{1} << 40, 1),
+                               deferred::case_(-7, 2),
+                               deferred::case_(123456, 3));
+
+  var = std::int64_t{1} << 40;
+  CHECK(ex() == 1);
+  var = -7;
+  CHECK(ex() == 2);
+  var = 123456;
+  CHECK(ex() == 3);
+  var = 0;
+  CHECK(ex() == 0);
+}
+
+TEST_CASE("switch with enum labels", "[switch-enum-labels]")
+{
+  auto var = deferred::variable<color>();
+  auto ex  = deferred::switch_(var,
+                               deferred::default_(0),
+                               deferred::case_(color::blue, 3),
+                               deferred::case_(color::red, 1));
+
+  var = color::red;
+  CHECK(ex() == 1);
+  var = color::green;
+  CHECK(ex() == 0);
+  var = color::blue;
+  CHECK(ex() == 3);
+}
+
+TEST_CASE("switch with constant labels at compile time", "[switch-constant-labels-constexpr]")
+{
+  constexpr auto ex = deferred::switch_(7u,
+                                        deferred::default_(0),
+                                        deferred::case_(5, 1),
+                                        deferred::case_(7, 2),
+                                        deferred::case_(900, 3));
+  STATIC_CHECK(ex() == 2);
+}
+
+TEST_CASE("switch hash table", "[switch-hash-table]")
+{
+  using namespace std::string_view_literals;
+
+  SECTION("few labels")
+  {
+    constexpr deferred::detail::switch_hash_table<std::string_view, 3> table(
+      std::array{"add"sv, "sub"sv, "add"sv});
+    auto const is_label = [](std::string_view key) {
+      return [key](std::size_t i) { return std::array{"add"sv, "sub"sv, "add"sv}[i - 1] == key; };
+    };
+    CHECK(table.find("add", is_label("add")) == 1);
+    CHECK(table.find("sub", is_label("sub")) == 2);
+    CHECK(table.find("mul", is_label("mul")) == 0);
+  }
+
+  SECTION("many labels")
+  {
+    std::array<std::string, 100> labels;
+    std::array<std::string_view, 100> views;
+    for (std::size_t i = 0; i < labels.size(); ++i)
+    {
+      labels[i] = "message-" + std::to_string(i);
+      views[i]  = labels[i];
+    }
+    deferred::detail::switch_hash_table<std::string_view, 100> table(views);
+    for (std::size_t i = 0; i < labels.size(); ++i)
+    {
+      auto comparisons = 0;
+      CHECK(table.find(labels[i], [&](std::size_t j) {
+        ++comparisons;
+        return views[j - 1] == labels[i];
+      }) == i + 1);
+      CHECK(comparisons == 1);
+    }
+    CHECK(table.find("message-100", [&](std::size_t j) { return views[j - 1] == "message-100"; })
+          == 0);
+  }
+}
+
+TEST_CASE("switch with string labels", "[switch-string-labels]")
+{
+  auto var = deferred::variable<std::string>();
+  auto ex  = deferred::switch_(var,
+                               deferred::default_(0),
+                               deferred::case_("login", 1),
+                              deferred::case_(std::string("logout"), 2),
+                              deferred::case_(std::string_view("ping"), 3),
+                              deferred::case_("login", 4));
+
+  var = "login";
+  CHECK(ex() == 1);
+  var = "logout";
+  CHECK(ex() == 2);
+  var = "ping";
+  CHECK(ex() == 3);
+  var = "pong";
+  CHECK(ex() == 0);
+  var = "";
+  CHECK(ex() == 0);
+
+  // the table must not refer to the labels of the original expression
+  auto copy     = std::make_unique<decltype(ex)>(ex);
+  auto expanded = copy->append(deferred::case_(std::string("pong"), 5));
+  copy.reset();
+  var = "logout";
+  CHECK(expanded() == 2);
+  var = "pong";
+  CHECK(expanded() == 5);
+}
+
+TEST_CASE("switch with string_view condition", "[switch-string-view-condition]")
+{
+  constexpr auto ex = deferred::switch_(std::string_view("sub"),
+                                        deferred::default_(0),
+                                        deferred::case_("add", 1),
+                                        deferred::case_("sub", 2));
+  STATIC_CHECK(ex() == 2);
+}
+
+TEST_CASE("switch with hashable labels", "[switch-hashable-labels]")
+{
+  auto var = deferred::variable<double>();
+  auto ex  = deferred::switch_(var,
+                               deferred::default_(0),
+                               deferred::case_(0.5, 1),
+                               deferred::case_(-2.0, 2),
+                               deferred::case_(0.0, 3));
+
+  var = 0.5;
+  CHECK(ex() == 1);
+  var = -2.0;
+  CHECK(ex() == 2);
+  var = -0.0;
+  CHECK(ex() == 3);
+  var = 1.0;
+  CHECK(ex() == 0);
+}
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "deferred/conditional.hpp"
+#include "deferred/constant.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/tape.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+
+namespace {
+
+// Creates an expression with sizeof...(I) nested subtractions, which are not flattened.
+template<typename Expression, std::size_t... I>
+auto make_chain(Expression&& ex, std::index_sequence<I...>)
+{
+  return (std::forward<Expression>(ex) - ... - static_cast<int>(I % 3));
+}
+
+} // namespace
+
+TEST_CASE("tape with expression", "[tape-expression]")
+{
+  auto x  = deferred::variable(2);
+  auto y  = deferred::variable(3);
+  auto ex = deferred::compile((x + y) * (x - y) + deferred::invoke([](int v) { return v * 10; }, y));
+  static_assert(decltype(ex)::size == 5);
+  static_assert(!deferred::is_constant_expression_v<decltype(ex)>);
+  CHECK(ex() == (2 + 3) * (2 - 3) + 30);
+
+  x = 5;
+  CHECK(ex() == (5 + 3) * (5 - 3) + 30);
+}
+
+TEST_CASE("tape with constant expression", "[tape-constant]")
+{
+  auto const ex = deferred::compile(deferred::constant(2) * deferred::constant(3) + 1);
+  static_assert(deferred::is_constant_expression_v<decltype(ex)>);
+  CHECK(ex() == 7);
+}
+
+TEST_CASE("tape without expression_ nodes", "[tape-leaf]")
+{
+  auto x  = deferred::variable(std::string("x"));
+  auto ex = deferred::compile(x);
+  static_assert(decltype(ex)::size == 0);
+  CHECK(ex() == "x");
+
+  auto c = deferred::compile(deferred::if_(x, 1).else_(2));
+  static_assert(decltype(c)::size == 0);
+}
+
+TEST_CASE("tape with non-copyable values", "[tape-move]")
+{
+  auto x  = deferred::variable(std::string("a"));
+  auto ex = deferred::compile(x + std::string("b") + std::string("c"));
+  CHECK(ex() == "abc");
+}
+
+TEST_CASE("tape with reference results", "[tape-reference]")
+{
+  auto x  = deferred::variable(1);
+  auto ex = deferred::compile(++x + 0);
+  CHECK(ex() == 2);
+  CHECK(x() == 2);
+  auto const version = x.version();
+  CHECK(ex() == 3);
+  CHECK(x.version() == version + 1);
+}
+
+TEST_CASE("tape copy", "[tape-copy]")
+{
+  auto x    = deferred::variable(4);
+  auto ex   = deferred::compile(x * 2 + 1);
+  auto copy = ex;
+  auto move = std::move(ex);
+  x         = 5;
+  CHECK(copy() == 11);
+  CHECK(move() == 11);
+}
+
+TEST_CASE("tape with deep expression", "[tape-deep]")
+{
+  auto x    = deferred::variable(1);
+  auto ex   = make_chain(x * 2, std::make_index_sequence<150>{});
+  auto tape = deferred::compile(ex);
+  static_assert(decltype(tape)::size == 151);
+  CHECK(tape() == ex());
+
+  x = 7;
+  CHECK(tape() == ex());
+}
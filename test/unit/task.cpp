@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include "deferred/async.hpp"
+#include "deferred/task.hpp"
+#include "deferred/thread_pool.hpp"
+
+namespace {
+
+deferred::task<int> value(int i)
+{
+  co_return i;
+}
+
+deferred::task<int> sum(int i, int j)
+{
+  co_return co_await value(i) + co_await value(j);
+}
+
+deferred::task<int&> reference(int& i)
+{
+  co_return i;
+}
+
+deferred::task<> fail()
+{
+  throw std::runtime_error("error");
+  co_return;
+}
+
+deferred::task<std::thread::id> resume_on(deferred::thread_pool& pool)
+{
+  co_await deferred::detail::schedule_awaiter(pool);
+  co_return std::this_thread::get_id();
+}
+
+template<typename T>
+deferred::task<T> value_on(deferred::thread_pool& pool, T t)
+{
+  co_await deferred::detail::schedule_awaiter(pool);
+  co_return t;
+}
+
+deferred::task<std::tuple<int, std::string, bool>> all(deferred::thread_pool& pool)
+{
+  co_return co_await deferred::when_all(
+    value(1), value_on(pool, std::string("two")), value_on(pool, true));
+}
+
+} // namespace
+
+TEST_CASE("task", "[task]")
+{
+  CHECK(deferred::sync_wait(value(1)) == 1);
+  CHECK(deferred::sync_wait(sum(1, 2)) == 3);
+
+  int i   = 0;
+  auto& r = deferred::sync_wait(reference(i));
+  CHECK(&r == &i);
+
+  CHECK_THROWS_AS(deferred::sync_wait(fail()), std::runtime_error);
+}
+
+TEST_CASE("task on another thread", "[task-thread]")
+{
+  deferred::thread_pool pool(1);
+  CHECK(deferred::sync_wait(resume_on(pool)) != std::this_thread::get_id());
+}
+
+TEST_CASE("when_all", "[when-all]")
+{
+  deferred::thread_pool pool(2);
+  auto t = all(pool);
+  CHECK(deferred::sync_wait(t) == std::tuple<int, std::string, bool>{1, "two", true});
+}
@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <latch>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "deferred/detail/work_stealing_deque.hpp"
+#include "deferred/thread_pool.hpp"
+
+namespace {
+
+std::uint64_t fib(deferred::thread_pool& pool, std::uint64_t n)
+{
+  if (n < 2)
+  {
+    return n;
+  }
+  std::uint64_t x = 0, y = 0;
+  deferred::fork_join(pool, [&] { x = fib(pool, n - 1); }, [&] { y = fib(pool, n - 2); });
+  return x + y;
+}
+
+} // namespace
+
+TEST_CASE("work stealing deque", "[work-stealing-deque]")
+{
+  std::vector<int> values(100);
+  deferred::detail::work_stealing_deque<int*> deque(4);
+  CHECK(deque.empty());
+  CHECK(deque.pop() == nullptr);
+  CHECK(deque.steal() == nullptr);
+
+  for (auto& v : values)
+  {
+    deque.push(&v);
+  }
+  CHECK(deque.steal() == &values[0]);
+  CHECK(deque.pop() == &values[99]);
+  CHECK(deque.steal() == &values[1]);
+  for (int i = 98; i >= 2; --i)
+  {
+    CHECK(deque.pop() == &values[i]);
+  }
+  CHECK(deque.empty());
+}
+
+TEST_CASE("work stealing deque concurrent steal", "[work-stealing-deque-concurrent]")
+{
+  constexpr int n = 100000;
+  std::vector<int> values(n);
+  deferred::detail::work_stealing_deque<int*> deque;
+  std::atomic<int> taken = 0;
+  std::atomic<bool> done = false;
+
+  std::vector<std::jthread> thieves;
+  for (int i = 0; i < 3; ++i)
+  {
+    thieves.emplace_back([&] {
+      while (!done || !deque.empty())
+      {
+        if (auto* v = deque.steal())
+        {
+          ++*v;
+          ++taken;
+        }
+      }
+    });
+  }
+  for (auto& v : values)
+  {
+    deque.push(&v);
+    if ((&v - values.data()) % 3 == 0)
+    {
+      if (auto* p = deque.pop())
+      {
+        ++*p;
+        ++taken;
+      }
+    }
+  }
+  done = true;
+  thieves.clear();
+  while (auto* p = deque.pop())
+  {
+    ++*p;
+    ++taken;
+  }
+
+  CHECK(taken == n);
+  CHECK(std::ranges::all_of(values, [](int v) { return v == 1; }));
+}
+
+TEST_CASE("thread pool submit", "[thread-pool]")
+{
+  std::atomic<int> count = 0;
+  {
+    deferred::thread_pool pool(2);
+    CHECK(pool.size() == 2);
+    for (int i = 0; i < 100; ++i)
+    {
+      pool.submit([&count] { ++count; });
+    }
+  }
+  CHECK(count == 100);
+}
+
+TEST_CASE("fork join runs concurrently", "[fork-join]")
+{
+  deferred::thread_pool pool(2);
+  std::latch all(3);
+  int a = 0, b = 0, c = 0;
+  // each callable waits for the others, so this only finishes if they run concurrently
+  deferred::fork_join(
+    pool,
+    [&] {
+      all.arrive_and_wait();
+      a = 1;
+    },
+    [&] {
+      all.arrive_and_wait();
+      b = 2;
+    },
+    [&] {
+      all.arrive_and_wait();
+      c = 3;
+    });
+  CHECK(a + b + c == 6);
+}
+
+TEST_CASE("fork join nested", "[fork-join-nested]")
+{
+  deferred::thread_pool pool(1);
+  std::atomic<int> count = 0;
+  auto leaf              = [&] { ++count; };
+  auto node              = [&] { deferred::fork_join(pool, leaf, leaf, leaf); };
+  deferred::fork_join(pool, node, node, node, node);
+  CHECK(count == 12);
+}
+
+TEST_CASE("fork join exception", "[fork-join-exception]")
+{
+  deferred::thread_pool pool(2);
+  std::atomic<int> count = 0;
+  CHECK_THROWS_AS(deferred::fork_join(
+                    pool,
+                    [&] { ++count; },
+                    [&] {
+                      ++count;
+                      throw std::runtime_error("error");
+                    },
+                    [&] { ++count; }),
+                  std::runtime_error);
+  CHECK(count == 3);
+}
+
+TEST_CASE("fork join recursive", "[fork-join-recursive]")
+{
+  deferred::thread_pool pool(4);
+  CHECK(fib(pool, 20) == 6765);
+}
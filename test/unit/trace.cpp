@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "deferred/conditional.hpp"
+#include "deferred/constant.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/trace.hpp"
+#include "deferred/type_traits/is_pure_expression.hpp"
+#include "deferred/variable.hpp"
+
+TEST_CASE("trace records nested events", "[trace-nested]")
+{
+  deferred::tracer t;
+  auto x  = deferred::variable(2);
+  auto ex = deferred::traced_((x + 1) * (x - 1), t);
+  static_assert(!deferred::is_pure_expression_v<decltype(ex)>);
+  CHECK(ex.nesting() == 0);
+  CHECK(ex() == 3);
+
+  auto const events = t.events();
+  REQUIRE(events.size() == 1);
+  auto const& e = events[0];
+  REQUIRE(e.size() == 6);
+  CHECK(e[0].phase == 'B');
+  CHECK(e[0].nesting == 0);
+  CHECK(e[1].phase == 'B');
+  CHECK(e[1].nesting == 1);
+  CHECK(e[2].phase == 'E');
+  CHECK(e[2].name == e[1].name);
+  CHECK(e[3].phase == 'B');
+  CHECK(e[4].phase == 'E');
+  CHECK(e[5].phase == 'E');
+  CHECK(e[5].name == e[0].name);
+  CHECK(e[0].name == deferred::type_name<std::multiplies<>>());
+  // operands may be evaluated in any order
+  auto const plus  = deferred::type_name<std::plus<>>();
+  auto const minus = deferred::type_name<std::minus<>>();
+  CHECK(((e[1].name == plus && e[3].name == minus) || (e[1].name == minus && e[3].name == plus)));
+  for (std::size_t i = 1; i < e.size(); ++i)
+  {
+    CHECK(e[i - 1].timestamp <= e[i].timestamp);
+  }
+}
+
+TEST_CASE("trace nesting of conditional", "[trace-conditional]")
+{
+  deferred::tracer t;
+  auto x  = deferred::variable(1);
+  auto ex = deferred::traced_(deferred::if_(x > 0, x * 2).else_(x + 1), t);
+  CHECK(ex() == 2);
+
+  auto const events = t.events();
+  REQUIRE(events.size() == 1);
+  // if_, x > 0, x * 2
+  REQUIRE(events[0].size() == 6);
+  CHECK(events[0][0].name == "if_");
+  CHECK(events[0][0].nesting == 0);
+  CHECK(events[0][1].nesting == 1);
+  CHECK(events[0][3].nesting == 1);
+}
+
+TEST_CASE("trace threads", "[trace-threads]")
+{
+  deferred::tracer t;
+  auto ex = deferred::traced_(deferred::constant(1) + 2, t);
+  CHECK(ex() == 3);
+  std::thread worker([&] {
+    for (int i = 0; i < 3; ++i)
+    {
+      static_cast<void>(ex());
+    }
+  });
+  worker.join();
+
+  auto const events = t.events();
+  REQUIRE(events.size() == 2);
+  CHECK(events[0].size() == 2);
+  CHECK(events[1].size() == 6);
+}
+
+TEST_CASE("trace ring buffer", "[trace-ring]")
+{
+  deferred::tracer t(4);
+  auto ex = deferred::traced_(deferred::constant(1) + 2, t);
+  for (int i = 0; i < 5; ++i)
+  {
+    static_cast<void>(ex());
+  }
+  CHECK(t.events()[0].size() == 4);
+  CHECK(t.dropped() == 6);
+}
+
+TEST_CASE("trace chrome format", "[trace-chrome]")
+{
+  deferred::tracer t(2);
+  auto x  = deferred::variable(1);
+  auto ex = deferred::traced_((x + 1) * 2, t);
+  CHECK(ex() == 4);
+
+  // only the end events of the root and the sum are left, and they are omitted
+  auto const json = t.chrome_trace();
+  CHECK(json.find("\"traceEvents\":[") != std::string::npos);
+  CHECK(json.find("\"ph\"") == std::string::npos);
+
+  deferred::tracer u;
+  auto ey = deferred::traced_((x + 1) * 2, u);
+  CHECK(ey() == 4);
+  auto const full = u.chrome_trace();
+  CHECK(full.find("\"ph\":\"B\"") != std::string::npos);
+  CHECK(full.find("\"ph\":\"E\"") != std::string::npos);
+  CHECK(full.find("\"tid\":0") != std::string::npos);
+  CHECK(full.find("\"args\":{\"nesting\":1}") != std::string::npos);
+}
@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "deferred/conditional.hpp"
+#include "deferred/constant.hpp"
+#include "deferred/invoke.hpp"
+#include "deferred/operators.hpp"
+#include "deferred/switch.hpp"
+#include "deferred/transform.hpp"
+#include "deferred/type_traits/is_constant_expression.hpp"
+#include "deferred/variable.hpp"
+#include "deferred/while.hpp"
+
+namespace {
+
+// Replaces constants with twice their value.
+auto const twice = []<typename T>(deferred::constant_<T> const& c) {
+  return deferred::constant(c() * 2);
+};
+
+struct lookup_fn
+{
+  std::vector<int> const* table;
+  int* lookups;
+
+  int operator()(int i) const
+  {
+    ++*lookups;
+    return (*table)[i];
+  }
+};
+
+struct batched_sum_fn
+{
+  std::vector<int> const* table;
+  int* lookups;
+
+  int operator()(int i, int j) const
+  {
+    ++*lookups;
+    return (*table)[i] + (*table)[j];
+  }
+};
+
+} // namespace
+
+TEST_CASE("matches", "[matches]")
+{
+  using deferred::matches_v;
+  namespace pattern = deferred::pattern;
+
+  auto x = deferred::variable(1);
+  using plus_type = decltype(x + 1);
+  static_assert(matches_v<pattern::any, plus_type>);
+  static_assert(
+    matches_v<pattern::operation<std::plus<>, pattern::variable, pattern::any>, plus_type>);
+  static_assert(
+    matches_v<pattern::operation<std::plus<>, pattern::variable, pattern::constant>, plus_type>);
+  static_assert(!matches_v<pattern::operation<std::plus<>, pattern::constant, pattern::any>,
+                           plus_type>);
+  static_assert(
+    !matches_v<pattern::operation<std::minus<>, pattern::any, pattern::any>, plus_type>);
+  static_assert(!matches_v<pattern::operation<std::plus<>, pattern::any>, plus_type>);
+  static_assert(matches_v<pattern::satisfies<deferred::is_constant_expression>,
+                          decltype(deferred::constant(1) + 2)>);
+  static_assert(matches_v<plus_type, plus_type>);
+  static_assert(matches_v<pattern::operation<std::logical_and<>, pattern::any, pattern::any>,
+                          decltype(x && x)>);
+
+  using chain_type = decltype(x + 1 + x);
+  static_assert(matches_v<pattern::operation<std::plus<>,
+                                             pattern::variable,
+                                             pattern::constant,
+                                             pattern::variable>,
+                          chain_type>);
+  static_assert(
+    !matches_v<pattern::operation<std::plus<>, pattern::any, pattern::any>, chain_type>);
+  static_assert(!matches_v<pattern::operation<std::multiplies<>,
+                                              pattern::any,
+                                              pattern::any,
+                                              pattern::any>,
+                           chain_type>);
+}
+
+TEST_CASE("transform without rules", "[transform-identity]")
+{
+  auto x  = deferred::variable(1);
+  auto ex = x * 2 + 3;
+  auto t  = deferred::transform(ex);
+  static_assert(std::is_same_v<decltype(t), decltype(ex)>);
+  static_assert(std::is_same_v<decltype(deferred::transform(x)), deferred::variable_<int>&>);
+
+  x = 4;
+  CHECK(t() == 11);
+}
+
+TEST_CASE("transform replaces matching nodes", "[transform]")
+{
+  namespace pattern = deferred::pattern;
+
+  std::vector<int> table{10, 20, 30};
+  int lookups = 0;
+  auto a      = deferred::variable(0);
+  auto b      = deferred::variable(2);
+
+  lookup_fn lookup{&table, &lookups};
+  auto ex = deferred::invoke(lookup, a) + deferred::invoke(lookup, b);
+
+  using lookup_pattern = pattern::operation<lookup_fn, pattern::any>;
+  auto batch =
+    deferred::make_rule<pattern::operation<std::plus<>, lookup_pattern, lookup_pattern>>(
+      [&](auto const& e) {
+        return deferred::invoke(batched_sum_fn{&table, &lookups},
+                                deferred::operand<0>(deferred::operand<0>(e)),
+                                deferred::operand<0>(deferred::operand<1>(e)));
+      });
+  auto t = deferred::transform(ex, batch);
+  static_assert(!std::is_same_v<decltype(t), decltype(ex)>);
+
+  CHECK(t() == 40);
+  CHECK(lookups == 1);
+
+  a = 1;
+  CHECK(t() == 50);
+  CHECK(lookups == 2);
+}
+
+TEST_CASE("transform is bottom-up", "[transform-bottom-up]")
+{
+  namespace pattern = deferred::pattern;
+
+  auto x = deferred::variable(3);
+  // x * 2 -> x + x
+  using pattern_type = pattern::operation<std::multiplies<>, pattern::any, pattern::constant>;
+  auto rule          = deferred::make_rule<pattern_type>([](auto const& e) {
+    auto const& c = deferred::operand<1>(e);
+    return deferred::operand<0>(e) + deferred::operand<0>(e) + (c() - 2);
+  });
+  auto t = deferred::transform((x * 2) * 2, rule);
+  CHECK(t() == 12);
+
+  x = 5;
+  CHECK(t() == 20);
+}
+
+TEST_CASE("transform with constrained callable", "[transform-callable]")
+{
+  auto x = deferred::variable(1);
+  auto t = deferred::transform(x + 1 + deferred::invoke([](int v) { return v; }, 5), twice);
+  CHECK(t() == 1 + 2 + 10);
+}
+
+TEST_CASE("transform control flow", "[transform-control-flow]")
+{
+  auto x = deferred::variable(1);
+
+  SECTION("conditional")
+  {
+    auto ex = deferred::if_(x > 0, x + 1).else_if(x < -5, x - 1).else_(x * 3);
+    auto t  = deferred::transform(ex, twice);
+    CHECK(t() == 3);
+    x = -10;
+    CHECK(t() == -60);
+    x = -1;
+    CHECK(t() == -6);
+  }
+
+  SECTION("conditional without else")
+  {
+    auto t = deferred::transform(deferred::if_(x > 0, x + 1), twice);
+    CHECK(t() == 3);
+  }
+
+  SECTION("switch")
+  {
+    auto ex = deferred::switch_(
+      x, deferred::default_(0), deferred::case_(1, x + 10), deferred::case_(2, x + 20));
+    auto t = deferred::transform(ex, twice);
+    // labels are doubled as well
+    CHECK(t() == 0);
+    x = 2;
+    CHECK(t() == 22);
+    x = 4;
+    CHECK(t() == 44);
+  }
+
+  SECTION("while")
+  {
+    auto i  = deferred::variable(0);
+    auto ex = deferred::while_(i < 3, ++i);
+    auto t  = deferred::transform(ex, twice);
+    t();
+    CHECK(i() == 6);
+  }
+}
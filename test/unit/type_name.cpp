@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2019-2026 Yiannis Papadopoulos <giannis.papadopoulos@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string_view>
+#include <vector>
+
+#include "deferred/constant.hpp"
+#include "deferred/type_name.hpp"
+
+namespace {
+
+struct point
+{ };
+
+} // namespace
+
+TEST_CASE("type_name of fundamental types", "[type_name-fundamental]")
+{
+  STATIC_CHECK(deferred::type_name<int>() == "int");
+  STATIC_CHECK(deferred::type_name<double>() == "double");
+  STATIC_CHECK(deferred::type_name<unsigned char>() == "unsigned char");
+}
+
+TEST_CASE("type_name of qualified types", "[type_name-qualified]")
+{
+  constexpr auto c = deferred::type_name<int const>();
+  STATIC_CHECK(c.find("const") != std::string_view::npos);
+  STATIC_CHECK(c.find("int") != std::string_view::npos);
+
+  constexpr auto r = deferred::type_name<int&>();
+  STATIC_CHECK(r.find('&') != std::string_view::npos);
+  STATIC_CHECK(r.find("&&") == std::string_view::npos);
+
+  constexpr auto rr = deferred::type_name<int&&>();
+  STATIC_CHECK(rr.find("&&") != std::string_view::npos);
+}
+
+TEST_CASE("type_name of class types", "[type_name-class]")
+{
+  constexpr auto p = deferred::type_name<point>();
+  STATIC_CHECK(p.ends_with("point"));
+
+  constexpr auto c = deferred::type_name<deferred::constant_<int>>();
+  STATIC_CHECK(c.find("deferred::constant_<int>") != std::string_view::npos);
+
+  constexpr auto v = deferred::type_name<std::vector<int>>();
+  STATIC_CHECK(v.find("vector") != std::string_view::npos);
+}
+
+TEST_CASE("type_name is stored once", "[type_name-storage]")
+{
+  auto const a = deferred::type_name<point>();
+  auto const b = deferred::type_name<point>();
+  CHECK(a.data() == b.data());
+  CHECK(a.data()[a.size()] == '\0');
+
+  auto x = deferred::constant(1);
+  CHECK(deferred::type_name(x) == deferred::type_name<deferred::constant_<int>&>());
+}